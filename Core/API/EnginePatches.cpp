@@ -41,6 +41,7 @@ ICorePatches::ICorePatches() {
   _eWorldFormat = E_LF_CURRENT;
   _iWantedWorldFormat = -1;
   _strWorldConverters = "";
+  _bSkippableResources = FALSE;
 };
 
 // Apply core patches (called after Core initialization!)
@@ -80,9 +81,24 @@ void ICorePatches::CorePatches(void) {
 #if _PATCHCONFIG_FIX_STREAMPAGING
   _pShell->DeclareSymbol("user INDEX sam_bUsePlaceholderResources;", &_EnginePatches._bUsePlaceholderResources);
 #endif
+
+#if _PATCHCONFIG_EXTEND_FILESYSTEM
+  extern void ReportPathResolution(void);
+  extern void ResetPathResolution(void);
+
+  _pShell->DeclareSymbol("user INDEX fil_bHashedZipLookup;", &fil_bHashedZipLookup);
+  _pShell->DeclareSymbol("user INDEX fil_iZipSeekCheckpoints;", &fil_iZipSeekCheckpoints);
+  _pShell->DeclareSymbol("persistent user INDEX fil_bMapZipArchives;", &fil_bMapZipArchives);
+  _pShell->DeclareSymbol("persistent user INDEX fil_iMaxMappedArchivesMB;", &fil_iMaxMappedArchivesMB);
+  _pShell->DeclareSymbol("user void fil_ReportZipReads(void);", &IUnzip::ReportReads);
+  _pShell->DeclareSymbol("user void fil_ResetZipReads(void);", &IUnzip::ResetReads);
+  _pShell->DeclareSymbol("user void fil_ReportPathResolution(void);", &ReportPathResolution);
+  _pShell->DeclareSymbol("user void fil_ResetPathResolution(void);", &ResetPathResolution);
+#endif
 };
 
 #include "Patches/Entities.h"
+#include "Patches/Worlds.h"
 
 void ICorePatches::Entities(void) {
 #if _PATCHCONFIG_EXTEND_ENTITIES
@@ -91,6 +107,10 @@ void ICorePatches::Entities(void) {
   void (CEntity::*pReadProps)(CTStream &) = &CEntity::ReadProperties_t;
   CreatePatch(pReadProps, &CEntityPatch::P_ReadProperties, "CEntity::ReadProperties_t(...)");
 
+  extern void (CEntity::*pWriteProperties)(CTStream &);
+  pWriteProperties = &CEntity::WriteProperties_t;
+  CreatePatch(pWriteProperties, &CEntityPatch::P_WriteProperties, "CEntity::WriteProperties_t(...)");
+
   extern void (CEntity::*pSendEvent)(const CEntityEvent &);
   pSendEvent = &CEntity::SendEvent;
   CreatePatch(pSendEvent, &CEntityPatch::P_SendEvent, "CEntity::SendEvent(...)");
@@ -99,6 +119,19 @@ void ICorePatches::Entities(void) {
   void (CRationalEntity::*pCall)(SLONG, SLONG, BOOL, const CEntityEvent &) = &CRationalEntity::Call;
   CreatePatch(pCall, &CRationalEntityPatch::P_Call, "CRationalEntity::Call(...)");
 
+#if _PATCHCONFIG_ENTITY_REGISTRY
+  // Keep track of entities of specific classes in each world
+  extern void (CEntity::*pDestroy)(void);
+  pDestroy = &CEntity::Destroy;
+  CreatePatch(pDestroy, &CEntityPatch::P_Destroy, "CEntity::Destroy()");
+
+  extern CEntity *(CWorld::*pCreateEntityOfClass)(const CPlacement3D &, CEntityClass *);
+  pCreateEntityOfClass = &CWorld::CreateEntity;
+  CreatePatch(pCreateEntityOfClass, &CWorldPatch::P_CreateEntityOfClass, "CWorld::CreateEntity(...)");
+
+  IEntityRegistry::Activate();
+#endif // _PATCHCONFIG_ENTITY_REGISTRY
+
   // CPlayer
   extern CEntityPatch::CReceiveItem pReceiveItem;
   StructPtr pReceiveItemPtr(ClassicsCore_GetEntitiesSymbol("?ReceiveItem@CPlayer@@UAEHABVCEntityEvent@@@Z"));
@@ -166,6 +199,9 @@ void ICorePatches::Entities(void) {
   }
 #endif // _PATCHCONFIG_ENTITY_FORCE
 
+  // Custom symbols
+  _pShell->DeclareSymbol("persistent user INDEX sam_bSkippableResources;", &_EnginePatches._bSkippableResources);
+
 #endif // _PATCHCONFIG_EXTEND_ENTITIES
 };
 
@@ -431,6 +467,30 @@ static void PatchStreams(void) {
   void (CTStream::*pFreeBufferFunc)(void) = &CTStream::FreeBuffer;
   CreatePatch(pFreeBufferFunc, &CUnpageStreamPatch::P_FreeBuffer, "CTStream::FreeBuffer()");
 
+  // Commit memory of write buffers as they grow
+  extern void (CTStream::*pStreamWrite)(const void *, SLONG);
+  extern void (CTStream::*pStreamSetPos)(SLONG);
+  extern void (CTStream::*pStreamSeek)(SLONG, CTStream::SeekDir);
+  extern BOOL _bCommitStreamsOnWrite;
+
+  StructPtr pWritePtr(ClassicsCore_GetEngineSymbol("?Write_t@CTStream@@UAEXPBXJ@Z"));
+  StructPtr pSetPosPtr(ClassicsCore_GetEngineSymbol("?SetPos_t@CTStream@@UAEXJ@Z"));
+  StructPtr pSeekPtr(ClassicsCore_GetEngineSymbol("?Seek_t@CTStream@@UAEXJW4SeekDir@1@@Z"));
+
+  // Write buffers are committed right away if any of the methods cannot be patched
+  if (pWritePtr.iAddress != NULL && pSetPosPtr.iAddress != NULL && pSeekPtr.iAddress != NULL) {
+    pStreamWrite = pWritePtr(pStreamWrite);
+    CreatePatch(pStreamWrite, &CUnpageStreamPatch::P_Write, "CTStream::Write_t(...)");
+
+    pStreamSetPos = pSetPosPtr(pStreamSetPos);
+    CreatePatch(pStreamSetPos, &CUnpageStreamPatch::P_SetPos, "CTStream::SetPos_t(...)");
+
+    pStreamSeek = pSeekPtr(pStreamSeek);
+    CreatePatch(pStreamSeek, &CUnpageStreamPatch::P_Seek, "CTStream::Seek_t(...)");
+
+    _bCommitStreamsOnWrite = TRUE;
+  }
+
   // CTFileStream
   void (CTFileStream::*pCreateFunc)(const CTFileName &, CTStream::CreateMode) = &CTFileStream::Create_t;
   CreatePatch(pCreateFunc, &CFileStreamPatch::P_Create, "CTFileStream::Create_t(...)");
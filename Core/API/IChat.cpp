@@ -185,6 +185,10 @@ static void ClientLogDelete(SHELL_FUNC_ARGS) {
   // Delete entire identity
   if (iCharacter == -1) {
     _aClientIdentities.Delete(&ci);
+    IClientLogging::InvalidateIndex();
+
+    // Journal can't keep track of removals
+    IClientLogging::SaveLog();
     return;
   }
 
@@ -196,6 +200,10 @@ static void ClientLogDelete(SHELL_FUNC_ARGS) {
   // Delete character
   CPlayerCharacter &pc = ci.aCharacters[iCharacter - 1];
   ci.aCharacters.Delete(&pc);
+  IClientLogging::InvalidateIndex();
+
+  // Journal can't keep track of removals
+  IClientLogging::SaveLog();
 };
 
 // Resave client log
@@ -206,9 +214,19 @@ static void ClientLogSave(void) {
 // Reload client log
 static void ClientLogLoad(void) {
   _aClientIdentities.Clear();
+  IClientLogging::InvalidateIndex();
   IClientLogging::LoadLog();
 };
 
+// [Cecil] Measure client log lookups among synthetic identities
+static void ClientLogBenchmark(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  INDEX ctIdentities = NEXT_ARG(INDEX);
+  INDEX ctLookups = NEXT_ARG(INDEX);
+
+  IClientLogging::Benchmark(ctIdentities, ctLookups);
+};
+
 void Chat(void) {
   _pShell->DeclareSymbol("persistent user CTString ser_strCommandPrefix;", &ser_strCommandPrefix);
   _pShell->DeclareSymbol("user CTString ser_strAdminPassword;", &ser_strAdminPassword);
@@ -240,6 +258,8 @@ void Chat(void) {
   _pShell->DeclareSymbol("user void ClientLogDelete(INDEX, INDEX);", &ClientLogDelete);
   _pShell->DeclareSymbol("user void ClientLogSave(void);", &ClientLogSave);
   _pShell->DeclareSymbol("user void ClientLogLoad(void);", &ClientLogLoad);
+  _pShell->DeclareSymbol("user void ClientLogBenchmark(INDEX, INDEX);", &ClientLogBenchmark);
+  _pShell->DeclareSymbol("user INDEX ser_bClientLogIndex;", &ser_bClientLogIndex);
 };
 
 }; // namespace
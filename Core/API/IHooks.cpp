@@ -16,6 +16,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "StdH.h"
 
 #include "Networking/Modules/ClientLogging.h"
+#include "Networking/ExtPackets.h"
+#include "Query/QueryManager.h"
 
 // Auto update shadows upon loading into worlds
 INDEX gam_bAutoUpdateShadows = TRUE;
@@ -125,6 +127,11 @@ void IHooks::OnChangeLevel(void)
 
     itPlugin->pm_events.m_game->OnChangeLevel();
   }
+
+#if _PATCHCONFIG_NEW_QUERY
+  // [Cecil] Replies to status requests include the current level
+  IQuery::InvalidateReplies();
+#endif
 };
 
 // Called before stopping world simulation
@@ -146,8 +153,20 @@ void IHooks::OnGameStop(void)
   // Reset all clients
   CActiveClient::ResetAll();
 
-  // Save client log by the end of the game
-  IClientLogging::SaveLog();
+  // [Cecil] Flush client log journal by the end of the game
+  IClientLogging::FlushLog();
+
+  // [Cecil] Entity classes may be released with the world
+  IEntityRegistry::Reset();
+
+#if _PATCHCONFIG_EXT_PACKETS
+  // [Cecil] Drop extension packets that haven't been sent during the game
+  IExtPacketBatch::Discard();
+
+  // [Cecil] Forget values that have been sent and received during the game
+  IExtPacketStream::ResetWriting();
+  IExtPacketStream::ResetReading();
+#endif
 };
 
 // Called after saving the game
@@ -187,6 +206,11 @@ void IHooks::OnAddPlayer(CPlayerTarget &plt, BOOL bLocal)
     itPlugin->pm_events.m_network->OnAddPlayer(plt, bLocal);
   }
 
+#if _PATCHCONFIG_NEW_QUERY
+  // [Cecil] Replies to status requests include the player list
+  IQuery::InvalidateReplies();
+#endif
+
   // Logic for connecting players
   if (bLocal && !_pNetwork->IsServer())
   {
@@ -210,6 +234,11 @@ void IHooks::OnRemovePlayer(CPlayerTarget &plt, BOOL bLocal)
 
     itPlugin->pm_events.m_network->OnRemovePlayer(plt, bLocal);
   }
+
+#if _PATCHCONFIG_NEW_QUERY
+  // [Cecil] Replies to status requests include the player list
+  IQuery::InvalidateReplies();
+#endif
 };
 
 // Called after starting demo playback
@@ -47,6 +47,9 @@ class CORE_API ICorePatches {
     // Which world converters to use (converter names separated by ';' or an empty string for automatic)
     CTString _strWorldConverters;
 
+    // Entities
+    INDEX _bSkippableResources; // Prefix resource properties with their length when writing entities
+
   public:
     // Constructor
     ICorePatches();
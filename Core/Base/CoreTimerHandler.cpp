@@ -66,6 +66,16 @@ void CCoreTimerHandler::OnTick(void)
   }
 
 #if _PATCHCONFIG_EXT_PACKETS
+  // Send extension packets that have been queued outside of game ticks (they are sent after each processed tick)
+  // Don't wait for the network loop if it's busy; the packets will be sent on the next tick
+  {
+    CTSingleLock slNetwork(&_pNetwork->ga_csNetwork, FALSE);
+
+    if (slNetwork.TryToLock()) {
+      IExtPacketBatch::Flush();
+    }
+  }
+
   // Stop extension packet sounds when the game isn't active
   if (!GetGameAPI()->IsHooked() || !GetGameAPI()->IsGameOn()) {
     CExtPlaySound::StopAllSounds();
@@ -130,8 +130,6 @@ void CZipHandle::Clear(void)
   zh_zeEntry.Clear();
 
   // Clear the zlib stream
-  CTSingleLock slZip(_pcsZipLock, TRUE);
-
   inflateEnd(&zh_zstream);
   memset(&zh_zstream, 0, sizeof(zh_zstream));
 
@@ -148,7 +146,8 @@ void CZipHandle::Clear(void)
   }
 };
 
-void CZipHandle::Throw_t(int iErr, const CTString &strDescription) {
+// [Cecil] Throw an error about some zlib operation on a file entry
+static void ThrowZlibError_t(const CZipEntry &ze, const z_stream &zstream, int iErr, const CTString &strDescription) {
   CTString strError;
 
   switch (iErr) {
@@ -164,8 +163,12 @@ void CZipHandle::Throw_t(int iErr, const CTString &strDescription) {
     default: strError.PrintF(LOCALIZE("Unknown ZLIB error: %d"), iErr);
   }
 
-  ThrowF_t(LOCALIZE("(%s/%s) %s - ZLIB error: %s - %s"), zh_zeEntry.ze_pfnmArchive->str_String,
-    zh_zeEntry.ze_fnm.str_String, strDescription, strError.str_String, zh_zstream.msg);
+  ThrowF_t(LOCALIZE("(%s/%s) %s - ZLIB error: %s - %s"), ze.ze_pfnmArchive->str_String,
+    ze.ze_fnm.str_String, strDescription, strError.str_String, zstream.msg);
+};
+
+void CZipHandle::Throw_t(int iErr, const CTString &strDescription) {
+  ThrowZlibError_t(zh_zeEntry, zh_zstream, iErr, strDescription);
 };
 
 // [Cecil] Pointer to '_azhHandles' in the engine
@@ -196,6 +199,510 @@ static inline BOOL VerifyHandle(INDEX iHandle) {
   return TRUE;
 };
 
+// [Cecil] Amount of inflate streams kept per ZIP handle as seek checkpoints
+INDEX fil_iZipSeekCheckpoints = 4;
+
+// [Cecil] Maximum amount of seek checkpoints per ZIP handle
+#define ZIP_MAX_CHECKPOINTS 16
+
+// [Cecil] Size of compressed input buffer per inflate stream
+#define ZIP_INPUT_SIZE (16 * 1024)
+
+// [Cecil] Size of a buffer for skipping decompressed data
+#define ZIP_SKIP_SIZE (16 * 1024)
+
+// [Cecil] One inflate stream of an open file entry that can be resumed from its current position
+struct SZipInflater {
+  z_stream zi_zstream;    // zlib filestream for decompression
+  SLONG zi_slReadPos;     // Amount of compressed data that has been read
+  ULONG zi_ulLastUsed;    // Read number of the last time this stream has been used
+  UBYTE *zi_pubBufIn;     // Input buffer (only when reading from a file)
+};
+
+// [Cecil] Map archives into memory and read file entries directly from them
+INDEX fil_bMapZipArchives = FALSE;
+
+// [Cecil] Archive that's mapped into memory
+struct SZipMapping {
+  CTFileName zm_fnmArchive; // Path to the archive (empty if it's not used anymore)
+  HANDLE zm_hFile;          // Open archive file
+  HANDLE zm_hMapping;       // File mapping object
+  const UBYTE *zm_pubView;  // Mapped view of the entire file
+  SLONG zm_slSize;          // Size of the file
+  INDEX zm_ctRefs;          // Amount of open handles that read from it
+};
+
+// [Cecil] Mapped archives
+static CStaticStackArray<SZipMapping *> _apZipMappings;
+
+// [Cecil] Archives that couldn't be mapped and are read as files until the archives are reloaded
+static CStaticStackArray<CTFileName> _afnmUnmappable;
+
+// [Cecil] Total size of all mapped archives, limited to save address space of the 32-bit process
+static SLONG _slMappedSize = 0;
+
+// [Cecil] Maximum total size of mapped archives in megabytes
+INDEX fil_iMaxMappedArchivesMB = 128;
+
+// [Cecil] Statistics of open handles per reading method (0 - file, 1 - mapping)
+struct SZipReadStats {
+  LONG zrs_ctOpens;
+  LONG zrs_ctReads;
+  LONG zrs_slBytes;
+  CTimerValue zrs_tvOpen;
+};
+
+static SZipReadStats _aZipStats[2];
+
+// [Cecil] Decompression state of an open file entry that's owned by each handle
+// Unlike the engine's 'CZipHandle' it's never moved in memory and can be used without any global locks
+class CZipStream {
+  public:
+    CZipEntry zs_zeEntry; // Copy of the entry with the exact data position
+    FILE *zs_fFile;       // Open handle of the archive
+    SLONG zs_slFilePos;   // Current position in the archive file (-1 if unknown)
+    ULONG zs_ulReads;     // Amount of performed reads
+
+    SZipMapping *zs_pzm;       // Mapped archive to read from instead of the file
+    const UBYTE *zs_pubMapped; // Compressed data of the entry in the mapped archive
+
+    // Inflate streams suspended at different positions
+    SZipInflater *zs_apInflaters[ZIP_MAX_CHECKPOINTS];
+    INDEX zs_ctInflaters;
+
+  public:
+    CZipStream(void) : zs_fFile(NULL), zs_slFilePos(-1), zs_ulReads(0),
+      zs_pzm(NULL), zs_pubMapped(NULL), zs_ctInflaters(0)
+    {
+      memset(zs_apInflaters, 0, sizeof(zs_apInflaters));
+    };
+
+    ~CZipStream(void) {
+      for (INDEX i = 0; i < zs_ctInflaters; i++) {
+        inflateEnd(&zs_apInflaters[i]->zi_zstream);
+
+        if (zs_apInflaters[i]->zi_pubBufIn != NULL) {
+          FreeMemory(zs_apInflaters[i]->zi_pubBufIn);
+        }
+
+        delete zs_apInflaters[i];
+      }
+
+      if (zs_fFile != NULL) {
+        fclose(zs_fFile);
+      }
+    };
+
+    // Index of the reading method for statistics
+    inline INDEX StatsIndex(void) const {
+      return (zs_pzm != NULL) ? 1 : 0;
+    };
+
+    // Read a block of stored data
+    void ReadStored(UBYTE *pub, SLONG slStart, SLONG slLen);
+
+    // Read more compressed data for some inflate stream
+    BOOL FillInput(SZipInflater &zi);
+
+    // Get inflate stream that's the closest to some position without going over it
+    SZipInflater &GetInflater_t(SLONG slPos);
+
+    // Decompress data from some inflate stream into a buffer
+    BOOL Inflate_t(SZipInflater &zi, UBYTE *pub, SLONG slLen, const char *strError);
+};
+
+// [Cecil] Decompression states of open handles, parallel to '_aZipHandles'
+static CStaticStackArray<CZipStream *> _apZipStreams;
+
+void CZipStream::ReadStored(UBYTE *pub, SLONG slStart, SLONG slLen) {
+  // Copy straight from the mapped archive
+  if (zs_pubMapped != NULL) {
+    memcpy(pub, zs_pubMapped + slStart, slLen);
+    return;
+  }
+
+  fseek(zs_fFile, zs_zeEntry.ze_slDataOffset + slStart, SEEK_SET);
+  SLONG slRead = fread(pub, 1, slLen, zs_fFile);
+
+  zs_slFilePos = (slRead > 0) ? slStart + slRead : -1;
+};
+
+BOOL CZipStream::FillInput(SZipInflater &zi) {
+  const SLONG slLeft = zs_zeEntry.ze_slCompressedSize - zi.zi_slReadPos;
+  if (slLeft <= 0) return FALSE;
+
+  // Give all of the remaining data from the mapped archive at once
+  if (zs_pubMapped != NULL) {
+    zi.zi_zstream.next_in = (Bytef *)(zs_pubMapped + zi.zi_slReadPos);
+    zi.zi_zstream.avail_in = slLeft;
+
+    zi.zi_slReadPos += slLeft;
+    return TRUE;
+  }
+
+  // Other streams of this handle may have moved the file pointer
+  if (zs_slFilePos != zi.zi_slReadPos) {
+    fseek(zs_fFile, zs_zeEntry.ze_slDataOffset + zi.zi_slReadPos, SEEK_SET);
+  }
+
+  SLONG slRead = fread(zi.zi_pubBufIn, 1, Min(slLeft, (SLONG)ZIP_INPUT_SIZE), zs_fFile);
+
+  if (slRead <= 0) {
+    zs_slFilePos = -1;
+    return FALSE;
+  }
+
+  zi.zi_slReadPos += slRead;
+  zs_slFilePos = zi.zi_slReadPos;
+
+  // Tell zlib that there is more to read
+  zi.zi_zstream.next_in = zi.zi_pubBufIn;
+  zi.zi_zstream.avail_in = slRead;
+  return TRUE;
+};
+
+SZipInflater &CZipStream::GetInflater_t(SLONG slPos) {
+  zs_ulReads++;
+
+  // Find the furthest stream that isn't past the position yet
+  SZipInflater *pziBest = NULL;
+  SZipInflater *pziOldest = NULL;
+
+  for (INDEX i = 0; i < zs_ctInflaters; i++) {
+    SZipInflater *pzi = zs_apInflaters[i];
+
+    if (pzi->zi_zstream.total_out <= (ULONG)slPos) {
+      if (pziBest == NULL || pzi->zi_zstream.total_out > pziBest->zi_zstream.total_out) {
+        pziBest = pzi;
+      }
+    }
+
+    if (pziOldest == NULL || pzi->zi_ulLastUsed < pziOldest->zi_ulLastUsed) {
+      pziOldest = pzi;
+    }
+  }
+
+  // All streams are ahead, so one has to start from the beginning
+  if (pziBest == NULL) {
+    const INDEX ctMax = Clamp(fil_iZipSeekCheckpoints, (INDEX)1, (INDEX)ZIP_MAX_CHECKPOINTS);
+
+    // Restart the least recently used stream, leaving others suspended where they are
+    if (zs_ctInflaters >= ctMax) {
+      pziBest = pziOldest;
+      inflateReset(&pziBest->zi_zstream);
+
+    // Start a new stream
+    } else {
+      pziBest = new SZipInflater;
+      memset(&pziBest->zi_zstream, 0, sizeof(pziBest->zi_zstream));
+      pziBest->zi_pubBufIn = NULL;
+
+      int iErr = inflateInit2(&pziBest->zi_zstream, -15);
+
+      if (iErr != Z_OK) {
+        z_stream zstream = pziBest->zi_zstream;
+        delete pziBest;
+
+        ThrowZlibError_t(zs_zeEntry, zstream, iErr, LOCALIZE("Cannot init inflation"));
+      }
+
+      // Mapped archives don't need input buffers
+      if (zs_pubMapped == NULL) {
+        pziBest->zi_pubBufIn = (UBYTE *)AllocMemory(ZIP_INPUT_SIZE);
+      }
+
+      zs_apInflaters[zs_ctInflaters++] = pziBest;
+    }
+
+    pziBest->zi_zstream.next_in = NULL;
+    pziBest->zi_zstream.avail_in = 0;
+    pziBest->zi_slReadPos = 0;
+  }
+
+  pziBest->zi_ulLastUsed = zs_ulReads;
+  return *pziBest;
+};
+
+BOOL CZipStream::Inflate_t(SZipInflater &zi, UBYTE *pub, SLONG slLen, const char *strError) {
+  z_stream &zstream = zi.zi_zstream;
+
+  zstream.avail_out = slLen;
+  zstream.next_out = pub;
+
+  // While there is something to write to given block
+  while (zstream.avail_out > 0) {
+    // If zlib has no more input, read more to it
+    if (zstream.avail_in == 0 && !FillInput(zi)) {
+      return FALSE;
+    }
+
+    // Decode to output
+    int iErr = inflate(&zstream, Z_SYNC_FLUSH);
+
+    if (iErr == Z_STREAM_END) {
+      return (zstream.avail_out == 0);
+    }
+
+    if (iErr != Z_OK) {
+      ThrowZlibError_t(zs_zeEntry, zstream, iErr, strError);
+    }
+  }
+
+  return TRUE;
+};
+
+// [Cecil] Release a mapped archive
+static void UnmapArchive(SZipMapping *pzm) {
+  _slMappedSize -= pzm->zm_slSize;
+
+  UnmapViewOfFile(pzm->zm_pubView);
+  CloseHandle(pzm->zm_hMapping);
+  CloseHandle(pzm->zm_hFile);
+  delete pzm;
+};
+
+// [Cecil] Get mapped archive or map it if it hasn't been yet (must be called under the ZIP lock)
+static SZipMapping *MapArchive(const CTFileName &fnmArchive) {
+  for (INDEX i = 0; i < _apZipMappings.Count(); i++) {
+    SZipMapping *pzm = _apZipMappings[i];
+
+    if (pzm->zm_fnmArchive == fnmArchive) return pzm;
+  }
+
+  // Don't try mapping the same archive again
+  for (INDEX iUnmappable = 0; iUnmappable < _afnmUnmappable.Count(); iUnmappable++) {
+    if (_afnmUnmappable[iUnmappable] == fnmArchive) return NULL;
+  }
+
+  const __int64 llMaxSize = __int64(Clamp(fil_iMaxMappedArchivesMB, (INDEX)0, (INDEX)1024)) * 1024 * 1024;
+
+  HANDLE hFile = CreateFileA(fnmArchive.str_String, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+  if (hFile == INVALID_HANDLE_VALUE) {
+    _afnmUnmappable.Push() = fnmArchive;
+    return NULL;
+  }
+
+  const DWORD dwSize = GetFileSize(hFile, NULL);
+  HANDLE hMapping = NULL;
+  const UBYTE *pubView = NULL;
+
+  if (dwSize != INVALID_FILE_SIZE && dwSize != 0 && __int64(_slMappedSize) + dwSize <= llMaxSize) {
+    hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+  }
+
+  if (hMapping != NULL) {
+    pubView = (const UBYTE *)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+  }
+
+  // Fall back to reading the file
+  if (pubView == NULL) {
+    if (hMapping != NULL) CloseHandle(hMapping);
+    CloseHandle(hFile);
+
+    _afnmUnmappable.Push() = fnmArchive;
+    return NULL;
+  }
+
+  SZipMapping *pzm = new SZipMapping;
+  pzm->zm_fnmArchive = fnmArchive;
+  pzm->zm_hFile = hFile;
+  pzm->zm_hMapping = hMapping;
+  pzm->zm_pubView = pubView;
+  pzm->zm_slSize = dwSize;
+  pzm->zm_ctRefs = 0;
+
+  _apZipMappings.Push() = pzm;
+  _slMappedSize += dwSize;
+  return pzm;
+};
+
+// [Cecil] Release all mapped archives that aren't being read from (must be called under the ZIP lock)
+static void UnmapArchives(void) {
+  INDEX ctKeep = 0;
+
+  for (INDEX i = 0; i < _apZipMappings.Count(); i++) {
+    SZipMapping *pzm = _apZipMappings[i];
+
+    // Keep mappings of open handles until they are closed but don't give them out anymore
+    if (pzm->zm_ctRefs > 0) {
+      pzm->zm_fnmArchive = CTString("");
+      _apZipMappings[ctKeep++] = pzm;
+
+    } else {
+      UnmapArchive(pzm);
+    }
+  }
+
+  if (ctKeep == 0) {
+    _apZipMappings.PopAll();
+  } else {
+    _apZipMappings.PopUntil(ctKeep - 1);
+  }
+
+  // Try mapping all archives again
+  _afnmUnmappable.PopAll();
+};
+
+// [Cecil] Stop reading from a mapped archive (must be called under the ZIP lock)
+static void ReleaseMapping(SZipMapping *pzm) {
+  ASSERT(pzm->zm_ctRefs > 0);
+  pzm->zm_ctRefs--;
+
+  // Release detached mappings right away
+  if (pzm->zm_ctRefs == 0 && pzm->zm_fnmArchive == "") {
+    for (INDEX i = 0; i < _apZipMappings.Count(); i++) {
+      if (_apZipMappings[i] != pzm) continue;
+
+      // Replace with the last one
+      _apZipMappings[i] = _apZipMappings[_apZipMappings.Count() - 1];
+      _apZipMappings.Pop();
+      break;
+    }
+
+    UnmapArchive(pzm);
+  }
+};
+
+// [Cecil] Destroy decompression state that isn't attached to any handle
+static void DestroyZipStream(CZipStream *pzs) {
+  if (pzs->zs_pzm != NULL) {
+    CTSingleLock slZip(_pcsZipLock, TRUE);
+    ReleaseMapping(pzs->zs_pzm);
+  }
+
+  delete pzs;
+};
+
+// [Cecil] Find compressed data of a file entry in the mapped archive
+static BOOL FindMappedData(CZipStream &zs) {
+  const SZipMapping &zm = *zs.zs_pzm;
+  CZipEntry &ze = zs.zs_zeEntry;
+
+  // Local header must be inside the file
+  const SLONG slHeader = ze.ze_slDataOffset;
+
+  if (slHeader < 0 || slHeader + SLONG(sizeof(int) + sizeof(LocalFileHeader)) > zm.zm_slSize) {
+    return FALSE;
+  }
+
+  if (*(const int *)(zm.zm_pubView + slHeader) != SIGNATURE_LFH) {
+    return FALSE;
+  }
+
+  LocalFileHeader lfh;
+  memcpy(&lfh, zm.zm_pubView + slHeader + sizeof(int), sizeof(lfh));
+
+  // Determine exact compressed data position
+  const SLONG slData = slHeader + sizeof(int) + sizeof(lfh) + lfh.lfh_swFileNameLen + lfh.lfh_swExtraFieldLen;
+  const SLONG slSize = (ze.ze_bStored ? ze.ze_slUncompressedSize : ze.ze_slCompressedSize);
+
+  // Data must be inside the file as well
+  if (slData + slSize > zm.zm_slSize) {
+    return FALSE;
+  }
+
+  ze.ze_slDataOffset = slData;
+  zs.zs_pubMapped = zm.zm_pubView + slData;
+  return TRUE;
+};
+
+// [Cecil] Get decompression state of an open handle
+static CZipStream *GetZipStream(INDEX iHandle) {
+  // Only lock the handle tables instead of the entire reading
+  CTSingleLock slZip(_pcsZipLock, TRUE);
+
+  if (!VerifyHandle(iHandle) || iHandle >= _apZipStreams.Count()) return NULL;
+  return _apZipStreams[iHandle];
+};
+
+// [Cecil] Use hashed index for looking up file entries instead of going through all of them
+INDEX fil_bHashedZipLookup = TRUE;
+
+// [Cecil] Hash table of file entry indices in '_aZipFiles' (-1 for empty slots)
+static CStaticArray<INDEX> _aiFileHashTable;
+
+// [Cecil] Amount of file entries at the moment of hashing (-1 if the table hasn't been built)
+static INDEX _ctHashedFiles = -1;
+
+// [Cecil] Case-insensitive hash of a filename (FNV-1a)
+static inline ULONG HashFileName(const char *str) {
+  ULONG ulHash = 2166136261UL;
+
+  for (; *str != '\0'; str++) {
+    ulHash ^= (UBYTE)tolower((UBYTE)*str);
+    ulHash *= 16777619UL;
+  }
+
+  return ulHash;
+};
+
+// [Cecil] Rebuild hash table of file entries
+static void HashFileEntries(void) {
+  const INDEX ctFiles = _aZipFiles.Count();
+
+  // Keep the table at most half full, with a power of two size
+  INDEX ctSlots = 64;
+  while (ctSlots < ctFiles * 2) ctSlots <<= 1;
+
+  _aiFileHashTable.Clear();
+  _aiFileHashTable.New(ctSlots);
+
+  for (INDEX iSlot = 0; iSlot < ctSlots; iSlot++) {
+    _aiFileHashTable[iSlot] = -1;
+  }
+
+  const ULONG ulMask = ctSlots - 1;
+
+  for (INDEX iFile = 0; iFile < ctFiles; iFile++) {
+    const CTFileName &fnm = _aZipFiles[iFile].ze_fnm;
+    ULONG ulSlot = HashFileName(fnm.str_String) & ulMask;
+
+    // Find a free slot or a file with the same name
+    while (_aiFileHashTable[ulSlot] != -1) {
+      if (_aZipFiles[_aiFileHashTable[ulSlot]].ze_fnm == fnm) break;
+      ulSlot = (ulSlot + 1) & ulMask;
+    }
+
+    // Entries are sorted by priority, so only the first file with the same name is remembered
+    if (_aiFileHashTable[ulSlot] == -1) {
+      _aiFileHashTable[ulSlot] = iFile;
+    }
+  }
+
+  _ctHashedFiles = ctFiles;
+};
+
+// [Cecil] Find index of a file entry by its name (-1 if no file)
+static INDEX FindFileEntry(const CTFileName &fnm) {
+  // Use hash table if it's up to date with file entries
+  if (fil_bHashedZipLookup && _ctHashedFiles == _aZipFiles.Count()) {
+    const ULONG ulMask = _aiFileHashTable.Count() - 1;
+    ULONG ulSlot = HashFileName(fnm.str_String) & ulMask;
+
+    for (;;) {
+      const INDEX iFile = _aiFileHashTable[ulSlot];
+
+      // Hit an empty slot
+      if (iFile == -1) return -1;
+
+      // Filename matches
+      if (_aZipFiles[iFile].ze_fnm == fnm) return iFile;
+
+      ulSlot = (ulSlot + 1) & ulMask;
+    }
+  }
+
+  // Go through all files otherwise
+  for (INDEX iFile = 0; iFile < _aZipFiles.Count(); iFile++) {
+    // Filename matches
+    if (_aZipFiles[iFile].ze_fnm == fnm) {
+      return iFile;
+    }
+  }
+
+  return -1;
+};
+
 namespace IUnzip {
 
 // [Cecil] Get priority for a specific archive
@@ -262,7 +769,12 @@ void SortEntries(void) {
   // 4. From the game itself
   // 5. From other game directories
   // 6. From CD
-  qsort(&_aZipFiles[0], _aZipFiles.Count(), sizeof(CZipEntry), qsort_CompareContentDir);
+  if (_aZipFiles.Count() != 0) {
+    qsort(&_aZipFiles[0], _aZipFiles.Count(), sizeof(CZipEntry), qsort_CompareContentDir);
+  }
+
+  // Hash sorted entries for quick lookups
+  HashFileEntries();
 };
 
 // Add one zip archive to the currently active set
@@ -508,6 +1020,12 @@ static int qsort_ArchiveCTFileName_reverse(const void *pElement1, const void *pE
 // Read directories of all currently added archives in reverse alphabetical order
 void ReadDirectoriesReverse_t(void)
 {
+  // [Cecil] Archives may have changed since the last time
+  {
+    CTSingleLock slZip(_pcsZipLock, TRUE);
+    UnmapArchives();
+  }
+
   // No archives
   if (_aZipArchives.Count() == 0) return;
 
@@ -562,23 +1080,15 @@ BOOL IsFileAtIndexMod(INDEX i) {
 // Get index of a specific file (-1 if no file)
 INDEX GetFileIndex(const CTFileName &fnm)
 {
-  for (INDEX iFile = 0; iFile < _aZipFiles.Count(); iFile++) {
-    // Filename matches
-    if (_aZipFiles[iFile].ze_fnm == fnm) {
-      return iFile;
-    }
-  }
-
-  return -1;
+  return FindFileEntry(fnm);
 };
 
 // [Cecil] Get path to the archive with the file
 const CTFileName &GetFileArchive(const CTFileName &fnm) {
-  for (INDEX iFile = 0; iFile < _aZipFiles.Count(); iFile++) {
-    // Filename matches
-    if (_aZipFiles[iFile].ze_fnm == fnm) {
-      return *_aZipFiles[iFile].ze_pfnmArchive;
-    }
+  const INDEX iFile = FindFileEntry(fnm);
+
+  if (iFile != -1) {
+    return *_aZipFiles[iFile].ze_pfnmArchive;
   }
 
   static CTFileName fnmNoFile = CTString("");
@@ -604,22 +1114,76 @@ void GetFileInfo(INDEX iHandle, CTFileName &fnmZip,
 // Open a zip file entry for reading
 INDEX Open_t(const CTFileName &fnm)
 {
-  CZipEntry *pze = NULL;
+  const INDEX iFile = FindFileEntry(fnm);
 
-  for (INDEX iFile = 0; iFile < _aZipFiles.Count(); iFile++)
-  {
-    // Stop searching if it's that one
-    if (_aZipFiles[iFile].ze_fnm == fnm) {
-      pze = &_aZipFiles[iFile];
-      break;
+  // Not found
+  if (iFile == -1) {
+    ThrowF_t(LOCALIZE("File not found: %s"), fnm.str_String);
+  }
+
+  const CZipEntry *pze = &_aZipFiles[iFile];
+  CTimerValue tvOpen = _pTimer->GetHighPrecisionTimer();
+
+  // [Cecil] Create decompression state of the handle
+  CZipStream *pzs = new CZipStream;
+  pzs->zs_zeEntry = *pze;
+
+  // [Cecil] Try reading from the mapped archive
+  if (fil_bMapZipArchives) {
+    CTSingleLock slZip(_pcsZipLock, TRUE);
+    pzs->zs_pzm = MapArchive(*pze->ze_pfnmArchive);
+
+    if (pzs->zs_pzm != NULL) {
+      pzs->zs_pzm->zm_ctRefs++;
     }
   }
 
-  // Not found
-  if (pze == NULL) {
-    ThrowF_t(LOCALIZE("File not found: %s"), fnm.str_String);
+  if (pzs->zs_pzm != NULL) {
+    if (!FindMappedData(*pzs)) {
+      DestroyZipStream(pzs);
+
+      ThrowF_t(LOCALIZE("%s/%s: Wrong signature for 'local file header'"), 
+        pze->ze_pfnmArchive->str_String, pze->ze_fnm.str_String);
+    }
+
+  } else {
+    // Open zip archive for reading
+    pzs->zs_fFile = fopen(pze->ze_pfnmArchive->str_String, "rb");
+
+    // If failed to open it
+    if (pzs->zs_fFile == NULL) {
+      DestroyZipStream(pzs);
+
+      // Report error
+      ThrowF_t(LOCALIZE("Cannot open '%s': %s"), pze->ze_pfnmArchive->str_String, strerror(errno));
+    }
+
+    // Seek to the local header of the entry
+    fseek(pzs->zs_fFile, pze->ze_slDataOffset, SEEK_SET);
+
+    // Read the signature
+    int slSig = 0;
+    fread(&slSig, sizeof(slSig), 1, pzs->zs_fFile);
+
+    // Unexpected signature
+    if (slSig != SIGNATURE_LFH) {
+      DestroyZipStream(pzs);
+
+      ThrowF_t(LOCALIZE("%s/%s: Wrong signature for 'local file header'"), 
+        pze->ze_pfnmArchive->str_String, pze->ze_fnm.str_String);
+    }
+
+    // Read the header
+    LocalFileHeader lfh;
+    fread(&lfh, sizeof(lfh), 1, pzs->zs_fFile);
+
+    // Determine exact compressed data position
+    pzs->zs_zeEntry.ze_slDataOffset = ftell(pzs->zs_fFile) + lfh.lfh_swFileNameLen + lfh.lfh_swExtraFieldLen;
   }
 
+  // [Cecil] Only lock while taking a free handle (inflate streams are created on the first read)
+  CTSingleLock slZip(_pcsZipLock, TRUE);
+
   // Go through each existing handle
   BOOL bHandleFound = FALSE;
   INDEX iHandle = 1;
@@ -638,74 +1202,25 @@ INDEX Open_t(const CTFileName &fnm)
     iHandle = _aZipHandles.Count();
     _aZipHandles.Push(1);
   }
-  
-  // Get the handle
-  CZipHandle &zh = _aZipHandles[iHandle];
 
-  ASSERT(!zh.zh_bOpen);
-  zh.zh_zeEntry = *pze;
-
-  // Open zip archive for reading
-  zh.zh_fFile = fopen(pze->ze_pfnmArchive->str_String, "rb");
-
-  // If failed to open it
-  if (zh.zh_fFile == NULL) {
-    // Clear the handle
-    zh.Clear();
-
-    // Report error
-    ThrowF_t(LOCALIZE("Cannot open '%s': %s"), pze->ze_pfnmArchive->str_String, strerror(errno));
+  // [Cecil] Keep decompression states in sync with the handles
+  while (_apZipStreams.Count() < _aZipHandles.Count()) {
+    _apZipStreams.Push() = NULL;
   }
 
-  // Seek to the local header of the entry
-  fseek(zh.zh_fFile, zh.zh_zeEntry.ze_slDataOffset, SEEK_SET);
-
-  // Read the signature
-  int slSig;
-  fread(&slSig, sizeof(slSig), 1, zh.zh_fFile);
-
-  // Unexpected signature
-  if (slSig != SIGNATURE_LFH) {
-    ThrowF_t(LOCALIZE("%s/%s: Wrong signature for 'local file header'"), 
-      zh.zh_zeEntry.ze_pfnmArchive->str_String, zh.zh_zeEntry.ze_fnm.str_String);
-  }
-
-  // Read the header
-  LocalFileHeader lfh;
-  fread(&lfh, sizeof(lfh), 1, zh.zh_fFile);
-
-  // Determine exact compressed data position
-  zh.zh_zeEntry.ze_slDataOffset = ftell(zh.zh_fFile) + lfh.lfh_swFileNameLen + lfh.lfh_swExtraFieldLen;
-
-  // Seek there
-  fseek(zh.zh_fFile, zh.zh_zeEntry.ze_slDataOffset, SEEK_SET);
-
-  // Allocate buffers
-  zh.zh_pubBufIn = (UBYTE *)AllocMemory(BUF_SIZE);
-
-  // Initialize zlib stream
-  CTSingleLock slZip(_pcsZipLock, TRUE);
-
-  zh.zh_zstream.next_out  = NULL;
-  zh.zh_zstream.avail_out = 0;
-  zh.zh_zstream.next_in   = NULL;
-  zh.zh_zstream.avail_in  = 0;
-  zh.zh_zstream.zalloc = (alloc_func)Z_NULL;
-  zh.zh_zstream.zfree = (free_func)Z_NULL;
-
-  int iErr = inflateInit2(&zh.zh_zstream, -15);
+  // Get the handle
+  CZipHandle &zh = _aZipHandles[iHandle];
 
-  // If failed
-  if (iErr != Z_OK) {
-    // Clean up what is possible
-    FreeMemory(zh.zh_pubBufIn);
-    zh.zh_pubBufIn = NULL;
+  ASSERT(!zh.zh_bOpen);
+  zh.zh_zeEntry = pzs->zs_zeEntry;
 
-    fclose(zh.zh_fFile);
-    zh.zh_fFile = NULL;
+  ASSERT(_apZipStreams[iHandle] == NULL);
+  _apZipStreams[iHandle] = pzs;
 
-    zh.Throw_t(iErr, LOCALIZE("Cannot init inflation"));
-  }
+  // [Cecil] Count opened handles
+  SZipReadStats &zrs = _aZipStats[pzs->StatsIndex()];
+  zrs.zrs_ctOpens++;
+  zrs.zrs_tvOpen += _pTimer->GetHighPrecisionTimer() - tvOpen;
 
   // Return the handle successfully
   zh.zh_bOpen = TRUE;
@@ -732,73 +1247,49 @@ ULONG GetCRC(INDEX iHandle)
 // Read a block from ZIP file
 void ReadBlock_t(INDEX iHandle, UBYTE *pub, SLONG slStart, SLONG slLen)
 {
-  if (!VerifyHandle(iHandle)) return;
+  // [Cecil] Each handle has its own decompression state, so nothing else needs to wait for it
+  CZipStream *pzs = GetZipStream(iHandle);
+  if (pzs == NULL) return;
 
-  CZipHandle &zh = _aZipHandles[iHandle];
+  const CZipEntry &ze = pzs->zs_zeEntry;
 
   // Over the end of file
-  if (slStart >= zh.zh_zeEntry.ze_slUncompressedSize) {
+  if (slStart >= ze.ze_slUncompressedSize) {
     return;
   }
 
   // Clamp length to end of the entry data
-  slLen = Min(slLen, zh.zh_zeEntry.ze_slUncompressedSize - slStart);
+  slLen = Min(slLen, ze.ze_slUncompressedSize - slStart);
+
+  // [Cecil] Count reads from any thread
+  SZipReadStats &zrs = _aZipStats[pzs->StatsIndex()];
+  InterlockedIncrement(&zrs.zrs_ctReads);
+  InterlockedExchangeAdd(&zrs.zrs_slBytes, slLen);
 
   // If not compressed
-  if (zh.zh_zeEntry.ze_bStored) {
+  if (ze.ze_bStored) {
     // Just read from file
-    fseek(zh.zh_fFile, zh.zh_zeEntry.ze_slDataOffset+slStart, SEEK_SET);
-    fread(pub, 1, slLen, zh.zh_fFile);
+    pzs->ReadStored(pub, slStart, slLen);
     return;
   }
 
-  CTSingleLock slZip(_pcsZipLock, TRUE);
-
-  // If behind the current pointer
-  if (slStart < zh.zh_zstream.total_out) {
-    // Reset the zlib stream to beginning
-    inflateReset(&zh.zh_zstream);
-    zh.zh_zstream.avail_in = 0;
-    zh.zh_zstream.next_in = NULL;
-
-    // Seek to start of zip entry data inside archive
-    fseek(zh.zh_fFile, zh.zh_zeEntry.ze_slDataOffset, SEEK_SET);
-  }
+  // [Cecil] Resume from the closest position behind the wanted one instead of restarting
+  SZipInflater &zi = pzs->GetInflater_t(slStart);
 
   // While ahead of the current pointer
-  while (slStart > zh.zh_zstream.total_out)
-  {
-    // If zlib has no more input
-    while (zh.zh_zstream.avail_in == 0) {
-      // Read more to it
-      SLONG slRead = fread(zh.zh_pubBufIn, 1, BUF_SIZE, zh.zh_fFile);
+  UBYTE aubSkip[ZIP_SKIP_SIZE];
 
-      if (slRead <= 0) {
-        return;
-      }
-
-      // Tell zlib that there is more to read
-      zh.zh_zstream.next_in = zh.zh_pubBufIn;
-      zh.zh_zstream.avail_in = slRead;
-    }
+  while ((ULONG)slStart > zi.zi_zstream.total_out) {
+    const SLONG slSkip = Min(SLONG(slStart - zi.zi_zstream.total_out), SLONG(ZIP_SKIP_SIZE));
 
-    // Read dummy data from the output
-    #define DUMMY_SIZE 256
-    UBYTE aubDummy[DUMMY_SIZE];
-
-    // Decode to output
-    zh.zh_zstream.avail_out = Min(SLONG(slStart-zh.zh_zstream.total_out), SLONG(DUMMY_SIZE));
-    zh.zh_zstream.next_out = aubDummy;
-
-    int iErr = inflate(&zh.zh_zstream, Z_SYNC_FLUSH);
-
-    if (iErr != Z_OK && iErr != Z_STREAM_END) {
-      zh.Throw_t(iErr, LOCALIZE("Error seeking in zip"));
+    // Decode dummy data
+    if (!pzs->Inflate_t(zi, aubSkip, slSkip, LOCALIZE("Error seeking in zip"))) {
+      break;
     }
   }
 
   // If not streaming continuously
-  if (slStart != zh.zh_zstream.total_out) {
+  if ((ULONG)slStart != zi.zi_zstream.total_out) {
     // This should not happen
     ASSERT(FALSE);
 
@@ -808,43 +1299,142 @@ void ReadBlock_t(INDEX iHandle, UBYTE *pub, SLONG slStart, SLONG slLen)
     return;
   }
 
-  // Set zlib for writing to the block
-  zh.zh_zstream.avail_out = slLen;
-  zh.zh_zstream.next_out = pub;
+  // Decode to the block
+  pzs->Inflate_t(zi, pub, slLen, LOCALIZE("Error reading from zip"));
+};
+
+// Close a ZIP file entry
+void Close(INDEX iHandle)
+{
+  CZipStream *pzs = NULL;
 
-  // While there is something to write to given block
-  while (zh.zh_zstream.avail_out > 0)
   {
-    // If zlib has no more input
-    while (zh.zh_zstream.avail_in == 0) {
-      // Read more to it
-      SLONG slRead = fread(zh.zh_pubBufIn, 1, BUF_SIZE, zh.zh_fFile);
+    CTSingleLock slZip(_pcsZipLock, TRUE);
 
-      if (slRead <= 0) {
-        return;
-      }
+    if (!VerifyHandle(iHandle)) return;
 
-      // Tell zlib that there is more to read
-      zh.zh_zstream.next_in = zh.zh_pubBufIn;
-      zh.zh_zstream.avail_in = slRead;
+    // [Cecil] Detach decompression state of the handle
+    if (iHandle < _apZipStreams.Count()) {
+      pzs = _apZipStreams[iHandle];
+      _apZipStreams[iHandle] = NULL;
+
+      if (pzs != NULL && pzs->zs_pzm != NULL) {
+        ReleaseMapping(pzs->zs_pzm);
+      }
     }
 
-    // Decode to output
-    int iErr = inflate(&zh.zh_zstream, Z_SYNC_FLUSH);
+    // Clear it
+    _aZipHandles[iHandle].Clear();
+  }
 
-    if (iErr != Z_OK && iErr != Z_STREAM_END) {
-      zh.Throw_t(iErr, LOCALIZE("Error reading from zip"));
-    }
+  // [Cecil] Destroy it outside the lock
+  delete pzs;
+};
+
+// [Cecil] Get uncompressed data of an open stored file entry directly from the mapped archive
+const UBYTE *GetMappedData(INDEX iHandle) {
+  CZipStream *pzs = GetZipStream(iHandle);
+
+  if (pzs == NULL || !pzs->zs_zeEntry.ze_bStored) return NULL;
+  return pzs->zs_pubMapped;
+};
+
+// [Cecil] Print out statistics of reading from archives
+void ReportReads(void) {
+  static const char *astrMethods[2] = { "file", "mapping" };
+
+  CPrintF(TRANS("Archive reads (%s by default, %d archives mapped):\n"),
+    astrMethods[fil_bMapZipArchives ? 1 : 0], _apZipMappings.Count());
+
+  for (INDEX i = 0; i < 2; i++) {
+    const SZipReadStats &zrs = _aZipStats[i];
+    const DOUBLE dOpen = zrs.zrs_tvOpen.GetSeconds() * 1000.0;
+    const DOUBLE dAverage = (zrs.zrs_ctOpens != 0) ? dOpen / zrs.zrs_ctOpens : 0.0;
+
+    CPrintF(TRANS("  %-7s: %d opens in %.3f ms (%.4f ms per open), %d reads, %d KB\n"), astrMethods[i],
+      zrs.zrs_ctOpens, dOpen, dAverage, zrs.zrs_ctReads, zrs.zrs_slBytes / 1024);
   }
 };
 
-// Close a ZIP file entry
-void Close(INDEX iHandle)
+// [Cecil] Reset statistics of reading from archives
+void ResetReads(void) {
+  for (INDEX i = 0; i < 2; i++) {
+    SZipReadStats &zrs = _aZipStats[i];
+    zrs.zrs_ctOpens = 0;
+    zrs.zrs_ctReads = 0;
+    zrs.zrs_slBytes = 0;
+    zrs.zrs_tvOpen = CTimerValue(0.0f);
+  }
+};
+
+// [Cecil] Read the beginning of a file at a specific position without using shared handles
+SLONG ReadFileStart(INDEX iFile, UBYTE *pub, SLONG slLen)
 {
-  if (!VerifyHandle(iHandle)) return;
+  if (iFile < 0 || iFile >= _aZipFiles.Count()) return -1;
+
+  const CZipEntry &ze = _aZipFiles[iFile];
+  slLen = Min(slLen, ze.ze_slUncompressedSize);
+
+  FILE *f = fopen(ze.ze_pfnmArchive->str_String, "rb");
+  if (f == NULL) return -1;
+
+  // Skip the local header of the entry
+  int slSig = 0;
+  LocalFileHeader lfh;
+
+  fseek(f, ze.ze_slDataOffset, SEEK_SET);
+
+  if (fread(&slSig, sizeof(slSig), 1, f) != 1 || slSig != SIGNATURE_LFH
+   || fread(&lfh, sizeof(lfh), 1, f) != 1) {
+    fclose(f);
+    return -1;
+  }
+
+  fseek(f, lfh.lfh_swFileNameLen + lfh.lfh_swExtraFieldLen, SEEK_CUR);
+
+  // Just read stored data
+  if (ze.ze_bStored) {
+    SLONG slRead = fread(pub, 1, slLen, f);
+    fclose(f);
+    return slRead;
+  }
+
+  // Inflate with a separate zlib stream
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+
+  if (inflateInit2(&zs, -15) != Z_OK) {
+    fclose(f);
+    return -1;
+  }
+
+  UBYTE aubIn[BUF_SIZE];
+  SLONG slLeft = ze.ze_slCompressedSize;
+  int iErr = Z_OK;
+
+  zs.next_out = pub;
+  zs.avail_out = slLen;
+
+  while (zs.avail_out > 0 && iErr == Z_OK) {
+    // Read more input
+    if (zs.avail_in == 0) {
+      SLONG slRead = fread(aubIn, 1, Min(slLeft, (SLONG)BUF_SIZE), f);
+      if (slRead <= 0) break;
+
+      slLeft -= slRead;
+      zs.next_in = aubIn;
+      zs.avail_in = slRead;
+    }
+
+    iErr = inflate(&zs, Z_SYNC_FLUSH);
+  }
+
+  const SLONG slRead = slLen - zs.avail_out;
+  inflateEnd(&zs);
+  fclose(f);
 
-  // Clear it
-  _aZipHandles[iHandle].Clear();
+  if (iErr != Z_OK && iErr != Z_STREAM_END) return -1;
+  return slRead;
 };
 
 }; // namespace
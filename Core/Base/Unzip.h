@@ -43,6 +43,18 @@ class CZipEntry {
     };
 };
 
+// [Cecil] Use hashed index for looking up file entries instead of going through all of them
+CORE_API extern INDEX fil_bHashedZipLookup;
+
+// [Cecil] Amount of inflate streams kept per ZIP handle as seek checkpoints
+CORE_API extern INDEX fil_iZipSeekCheckpoints;
+
+// [Cecil] Map archives into memory and read file entries directly from them
+CORE_API extern INDEX fil_bMapZipArchives;
+
+// [Cecil] Maximum total size of mapped archives in megabytes
+CORE_API extern INDEX fil_iMaxMappedArchivesMB;
+
 // Interface with functions for getting files out of ZIP archives
 namespace IUnzip {
 
@@ -97,6 +109,21 @@ CORE_API void ReadBlock_t(INDEX iHandle, UBYTE *pub, SLONG slStart, SLONG slLen)
 // Close a ZIP file entry
 CORE_API void Close(INDEX iHandle);
 
+// [Cecil] Get uncompressed data of an open stored file entry directly from the mapped archive
+// Returns NULL if the entry is compressed or the archive isn't mapped
+CORE_API const UBYTE *GetMappedData(INDEX iHandle);
+
+// [Cecil] Print out statistics of reading from archives
+CORE_API void ReportReads(void);
+
+// [Cecil] Reset statistics of reading from archives
+CORE_API void ResetReads(void);
+
+// [Cecil] Read the beginning of a file at a specific position without using shared handles
+// Safe to call from other threads as long as the list of files isn't being changed
+// Returns amount of read bytes or -1 on failure
+CORE_API SLONG ReadFileStart(INDEX iFile, UBYTE *pub, SLONG slLen);
+
 }; // namespace
 
 #endif
@@ -95,3 +95,4 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // Common components
 #include <Core/Base/GameDirectories.h>
 #include <Core/Objects/PropertyPtr.h>
+#include <Core/Objects/EntityRegistry.h>
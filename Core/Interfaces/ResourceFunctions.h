@@ -158,6 +158,49 @@ void SetDataFromFile_t(Type &object, CTFileName &fnmData, char *strFilters)
   }
 };
 
+// [Cecil] Chunk that prefixes resource data with its length in bytes, so it can be skipped without reading it
+#define IRES_SKIPPABLE_ID "RLEN"
+
+// [Cecil] Begin writing skippable resource data (returns position of the length that needs to be set)
+inline SLONG BeginSkippable_t(CTStream &strm) {
+  strm.WriteID_t(IRES_SKIPPABLE_ID);
+
+  const SLONG slLengthPos = strm.GetPos_t();
+  strm << (SLONG)0;
+
+  return slLengthPos;
+};
+
+// [Cecil] Finish writing skippable resource data by setting its length
+inline void EndSkippable_t(CTStream &strm, SLONG slLengthPos) {
+  const SLONG slEnd = strm.GetPos_t();
+
+  strm.SetPos_t(slLengthPos);
+  strm << SLONG(slEnd - slLengthPos - sizeof(SLONG));
+  strm.SetPos_t(slEnd);
+};
+
+// [Cecil] Read length of skippable resource data, if there is one (returns -1 for data without it)
+inline SLONG ReadSkippable_t(CTStream &strm) {
+  if (strm.PeekID_t() != CChunkID(IRES_SKIPPABLE_ID)) return -1;
+
+  strm.ExpectID_t(IRES_SKIPPABLE_ID);
+
+  SLONG slLength;
+  strm >> slLength;
+
+  return slLength;
+};
+
+// [Cecil] Seek past skippable resource data (returns FALSE if the data has no length and has to be read)
+inline BOOL SkipSkippable_t(CTStream &strm) {
+  const SLONG slLength = ReadSkippable_t(strm);
+  if (slLength < 0) return FALSE;
+
+  strm.Seek_t(slLength, CTStream::SD_CUR);
+  return TRUE;
+};
+
 namespace Anims {
 
 // Reimplementation of CAnimObject::Write_t()
@@ -213,6 +256,9 @@ inline void ReadClass_t(CAnimObject &ao, CTStream &strm) {
 };
 
 inline void Read_t(CTStream &strm, CAnimObject &ao) {
+  // [Cecil] Length is only needed for skipping
+  ReadSkippable_t(strm);
+
   // Read animation file
   CTFileName fnmAnim;
   strm >> fnmAnim;
@@ -225,6 +271,9 @@ inline void Read_t(CTStream &strm, CAnimObject &ao) {
 };
 
 inline void Skip_t(CTStream &strm) {
+  // [Cecil] Seek past the data if its length is known
+  if (SkipSkippable_t(strm)) return;
+
   // Skip animation file and animation object
   CTFileName fnmDummy;
   strm >> fnmDummy;
@@ -233,7 +282,10 @@ inline void Skip_t(CTStream &strm) {
   ReadClass_t(aoDummy, strm);
 };
 
-inline void Write_t(CTStream &strm, CAnimObject &ao) {
+// [Cecil] Skippable data is prefixed with its length but isn't readable by vanilla functions
+inline void Write_t(CTStream &strm, CAnimObject &ao, BOOL bSkippable = FALSE) {
+  const SLONG slLengthPos = (bSkippable ? BeginSkippable_t(strm) : -1);
+
   // Write animation file
   CAnimData *pad = (CAnimData *)ao.GetData();
 
@@ -245,6 +297,8 @@ inline void Write_t(CTStream &strm, CAnimObject &ao) {
 
   // Write animation object
   WriteClass_t(ao, strm);
+
+  if (bSkippable) EndSkippable_t(strm, slLengthPos);
 };
 
 }; // Anims namespace
@@ -252,6 +306,9 @@ inline void Write_t(CTStream &strm, CAnimObject &ao) {
 namespace Textures {
 
 inline void Read_t(CTStream &strm, CTextureObject &to) {
+  // [Cecil] Length is only needed for skipping
+  ReadSkippable_t(strm);
+
   // Read texture file
   CTFileName fnmTexture;
   strm >> fnmTexture;
@@ -264,6 +321,9 @@ inline void Read_t(CTStream &strm, CTextureObject &to) {
 };
 
 inline void Skip_t(CTStream &strm) {
+  // [Cecil] Seek past the data if its length is known
+  if (SkipSkippable_t(strm)) return;
+
   // Skip texture file and texture object
   CTFileName fnmDummy;
   strm >> fnmDummy;
@@ -272,7 +332,10 @@ inline void Skip_t(CTStream &strm) {
   toDummy.Read_t(&strm);
 };
 
-inline void Write_t(CTStream &strm, CTextureObject &to) {
+// [Cecil] Skippable data is prefixed with its length but isn't readable by vanilla functions
+inline void Write_t(CTStream &strm, CTextureObject &to, BOOL bSkippable = FALSE) {
+  const SLONG slLengthPos = (bSkippable ? BeginSkippable_t(strm) : -1);
+
   // Write texture file
   CTextureData *ptd = (CTextureData *)to.GetData();
 
@@ -284,6 +347,8 @@ inline void Write_t(CTStream &strm, CTextureObject &to) {
 
   // Write texture object
   to.Write_t(&strm);
+
+  if (bSkippable) EndSkippable_t(strm, slLengthPos);
 };
 
 }; // Textures namespace
@@ -293,6 +358,9 @@ namespace Models {
 inline void Skip_t(CTStream &strm);
 
 inline void Read_t(CTStream &strm, CModelObject &mo) {
+  // [Cecil] Length is only needed for skipping
+  ReadSkippable_t(strm);
+
   // Read model file
   CTFileName fnModel;
   strm >> fnModel;
@@ -348,6 +416,9 @@ inline void Read_t(CTStream &strm, CModelObject &mo) {
 };
 
 void Skip_t(CTStream &strm) {
+  // [Cecil] Seek past the data if its length is known
+  if (SkipSkippable_t(strm)) return;
+
   // Skip model file and model object
   CTFileName fnmDummy;
   strm >> fnmDummy;
@@ -389,7 +460,10 @@ void Skip_t(CTStream &strm) {
   }
 };
 
-inline void Write_t(CTStream &strm, CModelObject &mo) {
+// [Cecil] Skippable data is prefixed with its length but isn't readable by vanilla functions
+inline void Write_t(CTStream &strm, CModelObject &mo, BOOL bSkippable = FALSE) {
+  const SLONG slLengthPos = (bSkippable ? BeginSkippable_t(strm) : -1);
+
   // Write model file
   CAnimData *pad = (CAnimData *)mo.GetData();
 
@@ -405,10 +479,10 @@ inline void Write_t(CTStream &strm, CModelObject &mo) {
   // Write all textures
   strm.WriteID_t("MTEX");
 
-  IRes::Textures::Write_t(strm, mo.mo_toTexture);
-  IRes::Textures::Write_t(strm, mo.mo_toBump);
-  IRes::Textures::Write_t(strm, mo.mo_toReflection);
-  IRes::Textures::Write_t(strm, mo.mo_toSpecular);
+  IRes::Textures::Write_t(strm, mo.mo_toTexture, bSkippable);
+  IRes::Textures::Write_t(strm, mo.mo_toBump, bSkippable);
+  IRes::Textures::Write_t(strm, mo.mo_toReflection, bSkippable);
+  IRes::Textures::Write_t(strm, mo.mo_toSpecular, bSkippable);
 
   // Write attachments
   if (!mo.mo_lhAttachments.IsEmpty()) {
@@ -420,9 +494,11 @@ inline void Write_t(CTStream &strm, CModelObject &mo) {
       strm << itamo->amo_iAttachedPosition;
       strm << itamo->amo_plRelative;
 
-      Write_t(strm, itamo->amo_moModelObject);
+      Write_t(strm, itamo->amo_moModelObject, bSkippable);
     }
   }
+
+  if (bSkippable) EndSkippable_t(strm, slLengthPos);
 };
 
 }; // Models namespace
@@ -569,7 +645,10 @@ inline void WriteOffsetAndChildren(CTStream &strm, CModelInstance &mi) {
   }
 };
 
-inline void Write_t(CTStream &strm, CModelInstance &mi) {
+// [Cecil] Skippable data is prefixed with its length but isn't readable by vanilla functions
+inline void Write_t(CTStream &strm, CModelInstance &mi, BOOL bSkippable = FALSE) {
+  const SLONG slLengthPos = (bSkippable ? BeginSkippable_t(strm) : -1);
+
   strm.WriteID_t("MI03");
 
   // Write model instance name
@@ -588,6 +667,8 @@ inline void Write_t(CTStream &strm, CModelInstance &mi) {
   WriteOffsetAndChildren(strm, mi);
 
   strm.WriteID_t("ME03");
+
+  if (bSkippable) EndSkippable_t(strm, slLengthPos);
 };
 
 inline void ReadMeshInstances_t(CTStream &strm, CModelInstance &mi, BOOL bNew)
@@ -827,6 +908,9 @@ inline void ReadNew_t(CTStream &strm, CModelInstance &mi) {
 };
 
 void Read_t(CTStream &strm, CModelInstance &mi) {
+  // [Cecil] Length is only needed for skipping
+  ReadSkippable_t(strm);
+
   CChunkID cid = strm.PeekID_t();
 
   // Read old format
@@ -844,6 +928,9 @@ void Read_t(CTStream &strm, CModelInstance &mi) {
 };
 
 inline void Skip_t(CTStream &strm) {
+  // [Cecil] Seek past the data if its length is known
+  if (SkipSkippable_t(strm)) return;
+
   CModelInstance miDummy;
   Read_t(strm, miDummy);
 };
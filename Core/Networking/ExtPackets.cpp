@@ -30,7 +30,7 @@ INDEX ser_bReportExtPacketLogic = TRUE;
 void ClassicsPackets_ServerReport(IClassicsExtPacket *pExtPacket, const char *strFormat, ...)
 {
   // Ignore reports
-  if (!_pNetwork->IsServer() || !ser_bReportExtPacketLogic) return;
+  if (!ClassicsPackets_IsReporting()) return;
 
   va_list arg;
   va_start(arg, strFormat);
@@ -48,6 +48,20 @@ void ClassicsPackets_SendToClients(IClassicsExtPacket *pExtPacket)
   // Not running a server
   if (!_pNetwork->IsServer()) return;
 
+  // [Cecil] Send built-in packets together with other ones by the end of the tick
+  if (ser_bBatchExtPackets && pExtPacket->GetType() <= IClassicsExtPacket::k_EPacketType_LastS2C) {
+    if (IExtPacketBatch::Queue((CExtPacket *)pExtPacket)) return;
+  }
+
+  // [Cecil] Send queued packets first to preserve the order
+  IExtPacketBatch::Flush();
+
+  // [Cecil] Write built-in packets as a part of the game stream
+  if (pExtPacket->GetType() <= IClassicsExtPacket::k_EPacketType_LastS2C) {
+    IExtPacketStream::Send((CExtPacket *)pExtPacket);
+    return;
+  }
+
   // Remember last value
   INDEX &iLastSequence = _pNetwork->ga_srvServer.srv_iLastProcessedSequence;
   const INDEX iLastValue = iLastSequence;
@@ -78,44 +92,94 @@ void ClassicsPackets_SendToServer(IClassicsExtPacket *pExtPacket)
 
 bool ClassicsPackets_GetBoolProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return false;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return false;
 
-  return pval->IsTrue();
+  void *pData = pck.GetFieldData(pField);
+
+  switch (pField->eType) {
+    case SExtPacketField::E_BOOL:
+    case SExtPacketField::E_INDEX: return *(INDEX *)pData != 0;
+    case SExtPacketField::E_FLOAT: return *(FLOAT *)pData != 0.0f;
+    case SExtPacketField::E_ANY: return ((CAnyValue *)pData)->IsTrue();
+  }
+
+  CAnyValue val;
+  pck.GetFieldValue(pField, val);
+  return val.IsTrue();
 };
 
 int ClassicsPackets_GetIntProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return 0;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return 0;
+
+  void *pData = pck.GetFieldData(pField);
 
-  return pval->ToIndex();
+  switch (pField->eType) {
+    case SExtPacketField::E_BOOL:
+    case SExtPacketField::E_INDEX: return *(INDEX *)pData;
+    case SExtPacketField::E_FLOAT: return (int)*(FLOAT *)pData;
+    case SExtPacketField::E_ANY: return ((CAnyValue *)pData)->ToIndex();
+  }
+
+  CAnyValue val;
+  pck.GetFieldValue(pField, val);
+  return val.ToIndex();
 };
 
 double ClassicsPackets_GetFloatProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return 0.0;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return 0.0;
+
+  void *pData = pck.GetFieldData(pField);
+
+  switch (pField->eType) {
+    case SExtPacketField::E_BOOL:
+    case SExtPacketField::E_INDEX: return *(INDEX *)pData;
+    case SExtPacketField::E_FLOAT: return *(FLOAT *)pData;
+    case SExtPacketField::E_ANY: return ((CAnyValue *)pData)->ToFloat();
+  }
 
-  return pval->ToFloat();
+  CAnyValue val;
+  pck.GetFieldValue(pField, val);
+  return val.ToFloat();
 };
 
 const char *ClassicsPackets_GetStringProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return "";
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return "";
+
+  void *pData = pck.GetFieldData(pField);
+
+  if (pField->eType == SExtPacketField::E_STRING) {
+    return ((CTString *)pData)->str_String;
+
+  } else if (pField->eType == SExtPacketField::E_ANY) {
+    CAnyValue &val = *(CAnyValue *)pData;
+    if (val.GetType() != CAnyValue::E_VAL_STRING) return "";
 
-  if (pval->GetType() != CAnyValue::E_VAL_STRING) return "";
-  return pval->GetString().str_String;
+    return val.GetString().str_String;
+  }
+
+  return "";
 };
 
 bool ClassicsPackets_SetBoolProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty, bool bValue) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return false;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return false;
+
+  void *pData = pck.GetFieldData(pField);
+
+  if (pField->eType == SExtPacketField::E_BOOL || pField->eType == SExtPacketField::E_INDEX) {
+    *(INDEX *)pData = bValue;
 
-  if (pval->GetType() == CAnyValue::E_VAL_BOOL || pval->GetType() == CAnyValue::E_VAL_INDEX) {
-    pval->GetIndex() = bValue;
+  } else if (pField->eType == SExtPacketField::E_ANY && (((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_BOOL
+                                                      || ((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_INDEX)) {
+    ((CAnyValue *)pData)->GetIndex() = bValue;
 
   } else {
     PACKET_PROP_WARNING(pExtPacket, strProperty, "Cannot set property to a bool value!");
@@ -127,11 +191,17 @@ bool ClassicsPackets_SetBoolProp(IClassicsBuiltInExtPacket *pExtPacket, const ch
 
 bool ClassicsPackets_SetIntProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty, int iValue) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return false;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return false;
 
-  if (pval->GetType() == CAnyValue::E_VAL_BOOL || pval->GetType() == CAnyValue::E_VAL_INDEX) {
-    pval->GetIndex() = iValue;
+  void *pData = pck.GetFieldData(pField);
+
+  if (pField->eType == SExtPacketField::E_BOOL || pField->eType == SExtPacketField::E_INDEX) {
+    *(INDEX *)pData = iValue;
+
+  } else if (pField->eType == SExtPacketField::E_ANY && (((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_BOOL
+                                                      || ((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_INDEX)) {
+    ((CAnyValue *)pData)->GetIndex() = iValue;
 
   } else {
     PACKET_PROP_WARNING(pExtPacket, strProperty, "Cannot set property to an integer value!");
@@ -143,14 +213,19 @@ bool ClassicsPackets_SetIntProp(IClassicsBuiltInExtPacket *pExtPacket, const cha
 
 bool ClassicsPackets_SetFloatProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty, double fValue) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return false;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return false;
+
+  void *pData = pck.GetFieldData(pField);
+
+  if (pField->eType == SExtPacketField::E_FLOAT) {
+    *(FLOAT *)pData = fValue;
 
-  if (pval->GetType() == CAnyValue::E_VAL_FLOAT) {
-    pval->GetFloat() = fValue;
+  } else if (pField->eType == SExtPacketField::E_ANY && ((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_FLOAT) {
+    ((CAnyValue *)pData)->GetFloat() = fValue;
 
-  } else if (pval->GetType() == CAnyValue::E_VAL_DOUBLE) {
-    pval->GetDouble() = fValue;
+  } else if (pField->eType == SExtPacketField::E_ANY && ((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_DOUBLE) {
+    ((CAnyValue *)pData)->GetDouble() = fValue;
 
   } else {
     PACKET_PROP_WARNING(pExtPacket, strProperty, "Cannot set property to a float value!");
@@ -162,11 +237,16 @@ bool ClassicsPackets_SetFloatProp(IClassicsBuiltInExtPacket *pExtPacket, const c
 
 bool ClassicsPackets_SetStringProp(IClassicsBuiltInExtPacket *pExtPacket, const char *strProperty, const char *strValue) {
   CExtPacket &pck = *(CExtPacket *)pExtPacket;
-  CAnyValue *pval = pck.GetValue(strProperty);
-  if (pval == NULL) return false;
+  const SExtPacketField *pField = pck.FindField(strProperty);
+  if (pField == NULL) return false;
 
-  if (pval->GetType() == CAnyValue::E_VAL_STRING) {
-    pval->GetString() = strValue;
+  void *pData = pck.GetFieldData(pField);
+
+  if (pField->eType == SExtPacketField::E_STRING) {
+    *(CTString *)pData = strValue;
+
+  } else if (pField->eType == SExtPacketField::E_ANY && ((CAnyValue *)pData)->GetType() == CAnyValue::E_VAL_STRING) {
+    ((CAnyValue *)pData)->GetString() = strValue;
 
   } else {
     PACKET_PROP_WARNING(pExtPacket, strProperty, "Cannot set property to a string value!");
@@ -203,7 +283,6 @@ CEntity *CExtEntityPacket::GetEntity(void) {
     return NULL;
   }
 
-  const ULONG ulEntity = props["ulEntity"].GetIndex();
   CEntity *pen = FindExtEntity(ulEntity);
 
   if (pen == NULL) {
@@ -214,33 +293,77 @@ CEntity *CExtEntityPacket::GetEntity(void) {
   return pen;
 };
 
-// Convenient value getter
-CAnyValue *CExtPacket::GetValue(const CTString &strVariable) {
-  se1::map<CTString, CAnyValue>::iterator it = props.find(strVariable);
+// Find named field
+const SExtPacketField *CExtPacket::FindField(const char *strVariable) {
+  INDEX ctFields;
+  const SExtPacketField *aFields = GetFields(ctFields);
 
-  if (it == props.end()) {
-    PACKET_PROP_WARNING(this, strVariable, "Property doesn't exist!");
-    return NULL;
+  for (INDEX i = 0; i < ctFields; i++) {
+    if (strcmp(aFields[i].strName, strVariable) == 0) return &aFields[i];
+  }
+
+  PACKET_PROP_WARNING(this, strVariable, "Property doesn't exist!");
+  return NULL;
+};
+
+// Get field value as a generic value
+void CExtPacket::GetFieldValue(const SExtPacketField *pField, CAnyValue &val) {
+  void *pData = GetFieldData(pField);
+
+  switch (pField->eType) {
+    case SExtPacketField::E_BOOL:      val = bool(*(BOOL *)pData != FALSE); break;
+    case SExtPacketField::E_INDEX:     val = int(*(INDEX *)pData); break;
+    case SExtPacketField::E_FLOAT:     val = *(FLOAT *)pData; break;
+    case SExtPacketField::E_VECTOR:    val = *(FLOAT3D *)pData; break;
+    case SExtPacketField::E_PLACEMENT: val = *(CPlacement3D *)pData; break;
+    case SExtPacketField::E_BOX:       val = *(FLOATaabbox3D *)pData; break;
+    case SExtPacketField::E_STRING:    val = *(CTString *)pData; break;
+    case SExtPacketField::E_ANY:       val = *(CAnyValue *)pData; break;
+    default: ASSERT(FALSE);
   }
+};
 
-  return &it->second;
+// Set field value from a generic value
+void CExtPacket::SetFieldValue(const SExtPacketField *pField, CAnyValue val) {
+  void *pData = GetFieldData(pField);
+
+  switch (pField->eType) {
+    case SExtPacketField::E_BOOL:      *(BOOL *)pData = val.IsTrue(); break;
+    case SExtPacketField::E_INDEX:     *(INDEX *)pData = val.ToIndex(); break;
+    case SExtPacketField::E_FLOAT:     *(FLOAT *)pData = val.ToFloat(); break;
+    case SExtPacketField::E_VECTOR:    *(FLOAT3D *)pData = val.GetVector(); break;
+    case SExtPacketField::E_PLACEMENT: *(CPlacement3D *)pData = val.GetPlacement(); break;
+    case SExtPacketField::E_BOX:       *(FLOATaabbox3D *)pData = val.GetBox(); break;
+    case SExtPacketField::E_STRING:    *(CTString *)pData = val.GetString(); break;
+    case SExtPacketField::E_ANY:       *(CAnyValue *)pData = val; break;
+    default: ASSERT(FALSE);
+  }
+};
+
+// Convenient value getter
+bool CExtPacket::GetValue(const CTString &strVariable, CAnyValue &val) {
+  const SExtPacketField *pField = FindField(strVariable);
+  if (pField == NULL) return false;
+
+  GetFieldValue(pField, val);
+  return true;
 };
 
 // Convenient value setter
 bool CExtPacket::operator()(const CTString &strVariable, const CAnyValue &val) {
-  se1::map<CTString, CAnyValue>::iterator it = props.find(strVariable);
+  const SExtPacketField *pField = FindField(strVariable);
+  if (pField == NULL) return false;
 
-  if (it == props.end()) {
-    PACKET_PROP_WARNING(this, strVariable, "Property doesn't exist!");
-    return false;
-  }
+  // Compare with the type of the current value
+  CAnyValue valCurrent;
+  GetFieldValue(pField, valCurrent);
 
-  if (it->second.GetType() != val.GetType()) {
-    PACKET_PROP_WARNING(this, strVariable, CTString(0, "Cannot set value! Expected type %d but got %d!", it->second.GetType(), val.GetType()));
+  if (valCurrent.GetType() != val.GetType()) {
+    PACKET_PROP_WARNING(this, strVariable, CTString(0, "Cannot set value! Expected type %d but got %d!", valCurrent.GetType(), val.GetType()));
     return false;
   }
 
-  it->second = val;
+  SetFieldValue(pField, val);
   return true;
 };
 
@@ -283,6 +406,46 @@ CExtPacket *CExtPacket::CreatePacket(EPacketType ePacket)
   return NULL;
 };
 
+// Create a copy of a built-in packet
+CExtPacket *CExtPacket::CopyPacket(CExtPacket &pck)
+{
+  #define COPY_PACKET(_Class) return new _Class((const _Class &)pck)
+
+  switch (pck.GetType()) {
+    // Server to client
+    case k_EPacketType_EntityCreate  : COPY_PACKET(CExtEntityCreate);
+    case k_EPacketType_EntityDelete  : COPY_PACKET(CExtEntityDelete);
+    case k_EPacketType_EntityCopy    : COPY_PACKET(CExtEntityCopy);
+    case k_EPacketType_EntityEvent   : COPY_PACKET(CExtEntityEvent);
+    case k_EPacketType_EntityItem    : COPY_PACKET(CExtEntityItem);
+    case k_EPacketType_EntityInit    : COPY_PACKET(CExtEntityInit);
+    case k_EPacketType_EntityTeleport: COPY_PACKET(CExtEntityTeleport);
+    case k_EPacketType_EntityPosition: COPY_PACKET(CExtEntityPosition);
+    case k_EPacketType_EntityParent  : COPY_PACKET(CExtEntityParent);
+    case k_EPacketType_EntityProp    : COPY_PACKET(CExtEntityProp);
+    case k_EPacketType_EntityHealth  : COPY_PACKET(CExtEntityHealth);
+    case k_EPacketType_EntityFlags   : COPY_PACKET(CExtEntityFlags);
+    case k_EPacketType_EntityMove    : COPY_PACKET(CExtEntityMove);
+    case k_EPacketType_EntityRotate  : COPY_PACKET(CExtEntityRotate);
+    case k_EPacketType_EntityImpulse : COPY_PACKET(CExtEntityImpulse);
+    case k_EPacketType_EntityDirDmg  : COPY_PACKET(CExtEntityDirectDamage);
+    case k_EPacketType_EntityRadDmg  : COPY_PACKET(CExtEntityRangeDamage);
+    case k_EPacketType_EntityBoxDmg  : COPY_PACKET(CExtEntityBoxDamage);
+
+    case k_EPacketType_ChangeLevel : COPY_PACKET(CExtChangeLevel);
+    case k_EPacketType_ChangeWorld : COPY_PACKET(CExtChangeWorld);
+    case k_EPacketType_SessionProps: COPY_PACKET(CExtSessionProps);
+    case k_EPacketType_GameplayExt : COPY_PACKET(CExtGameplayExt);
+    case k_EPacketType_PlaySound   : COPY_PACKET(CExtPlaySound);
+  }
+
+  #undef COPY_PACKET
+
+  // Invalid packet
+  ASSERT(FALSE);
+  return NULL;
+};
+
 // [Cecil] TEMP: Get entity of a specific class under a certain index
 static INDEX GetEntity(SHELL_FUNC_ARGS) {
   BEGIN_SHELL_FUNC;
@@ -299,14 +462,142 @@ static INDEX GetEntity(SHELL_FUNC_ARGS) {
   return -1;
 };
 
+// Packets for the benchmark
+struct SPacketBenchmark {
+  CExtEntityPosition pckPos;
+  CExtEntityImpulse pckImpulse;
+  CExtEntityDirectDamage pckDamage;
+
+  // Get packet for some iteration
+  CExtEntityPacket &Get(INDEX i) {
+    switch (i % 3) {
+      case 0: return pckPos;
+      case 1: return pckImpulse;
+    }
+
+    return pckDamage;
+  };
+
+  // Set fields of some packet directly
+  void SetTyped(INDEX i) {
+    const FLOAT f = FLOAT(i % 1000);
+
+    switch (i % 3) {
+      case 0:
+        pckPos.ulEntity = i;
+        pckPos.vSet = FLOAT3D(f, f * 0.5f, -f);
+        pckPos.bRelative = (i & 1);
+        break;
+
+      case 1:
+        pckImpulse.ulEntity = i;
+        pckImpulse.vSpeed = FLOAT3D(0.0f, f, 0.0f);
+        break;
+
+      default:
+        pckDamage.ulEntity = i;
+        pckDamage.eDamageType = DMT_BULLET;
+        pckDamage.fDamage = f;
+        pckDamage.ulTarget = i + 1;
+        pckDamage.vHitPoint = FLOAT3D(f, 0.0f, f);
+        pckDamage.vDirection = FLOAT3D(0.0f, 0.0f, -1.0f);
+        break;
+    }
+  };
+
+  // Set fields of some packet by their names
+  void SetNamed(INDEX i) {
+    const FLOAT f = FLOAT(i % 1000);
+
+    switch (i % 3) {
+      case 0:
+        pckPos("ulEntity", (int)i);
+        pckPos("vSet", FLOAT3D(f, f * 0.5f, -f));
+        pckPos("bRelative", bool((i & 1) != 0));
+        break;
+
+      case 1:
+        pckImpulse("ulEntity", (int)i);
+        pckImpulse("vSpeed", FLOAT3D(0.0f, f, 0.0f));
+        break;
+
+      default:
+        pckDamage("ulEntity", (int)i);
+        pckDamage("eDamageType", (int)DMT_BULLET);
+        pckDamage("fDamage", f);
+        pckDamage("ulTarget", int(i + 1));
+        pckDamage("vHitPoint", FLOAT3D(f, 0.0f, f));
+        pckDamage("vDirection", FLOAT3D(0.0f, 0.0f, -1.0f));
+        break;
+    }
+  };
+};
+
+// Encode and decode a certain amount of entity packets
+static DOUBLE RunPacketBenchmark(INDEX ctPackets, BOOL bNamed, INDEX &ctMismatches) {
+  SPacketBenchmark bmWrite, bmRead;
+  CNetworkMessage nm((MESSAGETYPE)PCK_EXTENSION);
+
+  CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  for (INDEX i = 0; i < ctPackets; i++) {
+    if (bNamed) {
+      bmWrite.SetNamed(i);
+    } else {
+      bmWrite.SetTyped(i);
+    }
+
+    CExtEntityPacket &pckWrite = bmWrite.Get(i);
+    CExtEntityPacket &pckRead = bmRead.Get(i);
+
+    nm.Reinit();
+    pckWrite.Write(nm);
+
+    nm.Rewind();
+    pckRead.Read(nm);
+
+    if (pckRead.ulEntity != pckWrite.ulEntity) ctMismatches++;
+  }
+
+  return (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+};
+
+// Measure how fast entity packets are encoded and decoded
+static void BenchmarkPackets(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const INDEX ctPackets = ClampDn(NEXT_ARG(INDEX), (INDEX)1);
+
+  INDEX ctMismatches = 0;
+  const DOUBLE dTyped = RunPacketBenchmark(ctPackets, FALSE, ctMismatches);
+  const DOUBLE dNamed = RunPacketBenchmark(ctPackets, TRUE, ctMismatches);
+
+  CPrintF(TRANS("Encoded and decoded %d entity packets:\n"), ctPackets);
+  CPrintF(TRANS("  typed fields: %.3f s (%.0f packets per second)\n"), dTyped, ctPackets / ClampDn(dTyped, 0.000001));
+  CPrintF(TRANS("  named fields: %.3f s (%.0f packets per second)\n"), dNamed, ctPackets / ClampDn(dNamed, 0.000001));
+
+  if (ctMismatches != 0) {
+    CPrintF(TRANS("^cff0000%d packets have been decoded incorrectly!\n"), ctMismatches);
+  }
+};
+
 // Register the module
 void CExtPacket::RegisterExtPackets(void)
 {
   _pShell->DeclareSymbol("persistent user INDEX ser_bReportExtPacketLogic;", &ser_bReportExtPacketLogic);
+  _pShell->DeclareSymbol("persistent user INDEX ser_bBatchExtPackets;", &ser_bBatchExtPackets);
+  _pShell->DeclareSymbol("persistent user INDEX ser_iExtPacketPrecision;", &ser_iExtPacketPrecision);
+  _pShell->DeclareSymbol("persistent user INDEX ser_iExtPacketKeyframe;", &ser_iExtPacketKeyframe);
 
   // [Cecil] TEMP: Get entity of a specific class under a certain index
   _pShell->DeclareSymbol("user INDEX GetEntity(CTString, INDEX);", &GetEntity);
 
+  // Measure packet encoding speed
+  _pShell->DeclareSymbol("user void pck_Benchmark(INDEX);", &BenchmarkPackets);
+
+  // Sizes of packets sent through the game stream
+  _pShell->DeclareSymbol("user void pck_ReportStats(void);", &IExtPacketStream::ReportStats);
+  _pShell->DeclareSymbol("user void pck_ResetStats(void);", &IExtPacketStream::ResetStats);
+
   // Declare extra symbols
   void DeclareExtraSymbolsForExtPackets(void);
   DeclareExtraSymbolsForExtPackets();
@@ -27,15 +27,79 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // Report packet actions to the server
 CORE_API extern INDEX ser_bReportExtPacketLogic;
 
+// Check if packet actions are being reported (to avoid formatting reports that won't be printed)
+inline BOOL ClassicsPackets_IsReporting(void) {
+  return _pNetwork->IsServer() && ser_bReportExtPacketLogic;
+};
+
+// Collect packets sent during a tick and send them to clients as one block
+CORE_API extern INDEX ser_bBatchExtPackets;
+
+// Fractional bits of positions and speeds that are sent as differences from previous values (-1 to disable)
+CORE_API extern INDEX ser_iExtPacketPrecision;
+
+// How many times in a row a value can be sent as a difference before sending the whole value again
+CORE_API extern INDEX ser_iExtPacketKeyframe;
+
+// Description of a packet field that can be accessed by its name
+struct SExtPacketField {
+  // Field types
+  enum EType {
+    E_BOOL,      // BOOL
+    E_INDEX,     // INDEX or ULONG
+    E_FLOAT,     // FLOAT
+    E_VECTOR,    // FLOAT3D
+    E_PLACEMENT, // CPlacement3D
+    E_BOX,       // FLOATaabbox3D
+    E_STRING,    // CTString
+    E_ANY,       // CAnyValue for fields that can hold values of different types
+  };
+
+  const char *strName; // Field name
+  EType eType; // Value type
+  size_t iOffset; // Offset of the field from the beginning of the packet
+};
+
+// Describe a packet field by its variable
+#define EXTPACKET_FIELD(_Class, _Type, _Field) { #_Field, SExtPacketField::_Type, offsetof(_Class, _Field) }
+
+// Declare a table of named fields for a packet class
+#define EXTPACKET_DECLAREFIELDS \
+  static const SExtPacketField _aFields[]; \
+  virtual const SExtPacketField *GetFields(INDEX &ctFields) const;
+
+// Define a method that returns a table of named fields
+#define EXTPACKET_DEFINEFIELDS(_Class) \
+  const SExtPacketField *_Class::GetFields(INDEX &ctFields) const { \
+    ctFields = sizeof(_aFields) / sizeof(_aFields[0]); \
+    return _aFields; \
+  }
+
 // Define built-in extension packets
 class CORE_API CExtPacket : public IClassicsBuiltInExtPacket {
-  protected:
-    // Properties instead of raw data fields for easier modification via API
-    se1::map<CTString, CAnyValue> props;
-
   public:
+    // Get table of named fields of this packet
+    virtual const SExtPacketField *GetFields(INDEX &ctFields) const {
+      ctFields = 0;
+      return NULL;
+    };
+
+    // Find named field
+    const SExtPacketField *FindField(const char *strVariable);
+
+    // Get pointer to the field data
+    inline void *GetFieldData(const SExtPacketField *pField) {
+      return (UBYTE *)this + pField->iOffset;
+    };
+
+    // Get field value as a generic value
+    void GetFieldValue(const SExtPacketField *pField, CAnyValue &val);
+
+    // Set field value from a generic value
+    void SetFieldValue(const SExtPacketField *pField, CAnyValue val);
+
     // Convenient value getter
-    CAnyValue *GetValue(const CTString &strVariable);
+    bool GetValue(const CTString &strVariable, CAnyValue &val);
 
     // Convenient value setter
     bool operator()(const CTString &strVariable, const CAnyValue &val);
@@ -43,10 +107,76 @@ class CORE_API CExtPacket : public IClassicsBuiltInExtPacket {
     // Create new packet from type
     static CExtPacket *CreatePacket(EPacketType ePacket);
 
+    // Create a copy of a built-in packet
+    static CExtPacket *CopyPacket(CExtPacket &pck);
+
+    // Write resource path, possibly as an index of a path that has been sent before
+    void WritePath(CNetworkMessage &nm, const CTString &strPath);
+
+    // Read resource path, possibly by an index of a path that has been received before (returns FALSE if it's unknown)
+    BOOL ReadPath(CNetworkMessage &nm, CTString &strPath);
+
     // Register the module
     static void RegisterExtPackets(void);
 };
 
+// Interface for sending multiple packets to clients within one block
+class CORE_API IExtPacketBatch {
+  public:
+    // Packet type that marks a block with multiple packets
+    static const ULONG ulBatchType = 0xFFFFFFFF;
+
+  public:
+    // Queue packet to be sent by the end of the tick (returns FALSE if it should be sent right away)
+    static BOOL Queue(CExtPacket *pExtPacket);
+
+    // Send all queued packets to clients
+    static void Flush(void);
+
+    // Discard all queued packets without sending them
+    static void Discard(void);
+};
+
+// Interface for packets that are sent through the game stream
+class CORE_API IExtPacketStream {
+  public:
+    static CNetworkMessage *pnmWriting; // Game stream block that's currently being written
+    static CNetworkMessage *pnmReading; // Game stream block that's currently being read
+    static BOOL bWritingLegacy; // Writing a block for clients that run other patch versions
+    static BOOL bWritingWhole; // Writing values in full for all clients (while any client reads the old format)
+
+  public:
+    // Write packet into a game stream block
+    static bool Write(CExtPacket *pExtPacket, CNetworkMessage &nm);
+
+    // Read packet from a game stream block
+    static void Read(CExtPacket *pExtPacket, CNetworkMessage &nm);
+
+    // Check if any active client runs another patch version and can only read packets in the old format
+    static BOOL AnyLegacyClients(void);
+
+    // Write packet into a new game stream block and send it to all clients (returns false if it hasn't been written)
+    static bool Send(CExtPacket *pExtPacket);
+
+    // Forget values and paths that have been sent to clients, so they are sent in full again
+    static void ResetWriting(void);
+
+    // Forget values and paths that have been received from the server
+    static void ResetReading(void);
+
+    // Write values and paths that have been received from the server for a joining client or a new demo
+    static void WriteState(CTStream &strm);
+
+    // Read values and paths that have been received from the server before joining the game or recording a demo
+    static void ReadState(CTStream &strm);
+
+    // Print out sizes of packets that have been sent
+    static void ReportStats(void);
+
+    // Reset statistics of sent packets
+    static void ResetStats(void);
+};
+
 // Entity packets
 
 class CORE_API CExtEntityCreate : public CExtPacket {
@@ -54,12 +184,16 @@ class CORE_API CExtEntityCreate : public CExtPacket {
     static CEntity *penLast; // Last created entity
 
   public:
-    CExtEntityCreate() {
-      props["fnmClass"] = ""; // Class file to create an entity from (packed as extra if index isn't found in the predefined list)
-      props["plPos"] = CPlacement3D(FLOAT3D(0, 0, 0), ANGLE3D(0, 0, 0)); // Place to create an entity at
+    CTString fnmClass; // Class file to create an entity from (packed as extra if index isn't found in the predefined list)
+    CPlacement3D plPos; // Place to create an entity at
+
+  public:
+    CExtEntityCreate() : fnmClass(""), plPos(FLOAT3D(0, 0, 0), ANGLE3D(0, 0, 0))
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityCreate);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -70,29 +204,43 @@ class CORE_API CExtEntityCreate : public CExtPacket {
 // Base for entity manipulation packets
 class CORE_API CExtEntityPacket : public CExtPacket {
   public:
-    CExtEntityPacket() {
-      props["ulEntity"] = 0x7FFFFFFF; // Entity ID in the world (31 bits)
+    ULONG ulEntity; // Entity ID in the world (31 bits)
+
+  public:
+    CExtEntityPacket() : ulEntity(0x7FFFFFFF)
+    {
     };
 
     // Write entity ID
     void WriteEntity(CNetworkMessage &nm) {
-      ULONG ulEntity = ClampUp((ULONG)props["ulEntity"].GetIndex(), (ULONG)0x7FFFFFFFUL);
-      nm.WriteBits(&ulEntity, 31);
+      ULONG ulWrite = ClampUp(ulEntity, (ULONG)0x7FFFFFFFUL);
+      nm.WriteBits(&ulWrite, 31);
     };
 
     // Read entity ID
     void ReadEntity(CNetworkMessage &nm) {
-      ULONG ulEntity = 0;
+      ulEntity = 0;
       nm.ReadBits(&ulEntity, 31);
-      props["ulEntity"].GetIndex() = ulEntity;
     };
 
     // Check for invalid ID
     inline BOOL IsEntityValid(void) {
       // 0x7FFFFFFF - 0xFFFFFFFF are invalid
-      return ULONG(props["ulEntity"].GetIndex()) < 0x7FFFFFFF;
+      return ulEntity < 0x7FFFFFFF;
     };
 
+    // Write position or speed, possibly as a difference from the previous one sent for this entity
+    void WriteVector(CNetworkMessage &nm, const FLOAT3D &v, INDEX iChannel);
+
+    // Read position or speed, possibly as a difference from the previous one received for this entity
+    void ReadVector(CNetworkMessage &nm, FLOAT3D &v, INDEX iChannel);
+
+    // Write rotation, possibly as a difference from the previous one sent for this entity
+    void WriteAngles(CNetworkMessage &nm, const ANGLE3D &a, INDEX iChannel);
+
+    // Read rotation, possibly as a difference from the previous one received for this entity
+    void ReadAngles(CNetworkMessage &nm, ANGLE3D &a, INDEX iChannel);
+
     // Retrieve an entity from an ID
     CEntity *FindExtEntity(ULONG ulID);
 
@@ -156,11 +304,15 @@ class CORE_API EExtEntityEvent : public CEntityEvent {
 
 class CORE_API CExtEntityDelete : public CExtEntityPacket {
   public:
-    CExtEntityDelete() : CExtEntityPacket() {
-      props["bSameClass"] = false; // Delete all instances of the same class
+    BOOL bSameClass; // Delete all instances of the same class
+
+  public:
+    CExtEntityDelete() : CExtEntityPacket(), bSameClass(FALSE)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityDelete);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -170,11 +322,15 @@ class CORE_API CExtEntityDelete : public CExtEntityPacket {
 
 class CORE_API CExtEntityCopy : public CExtEntityPacket {
   public:
-    CExtEntityCopy() : CExtEntityPacket() {
-      props["iCopies"] = 1;
+    INDEX iCopies; // Amount of copies to make (up to 31)
+
+  public:
+    CExtEntityCopy() : CExtEntityPacket(), iCopies(1)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityCopy);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -204,6 +360,7 @@ class CORE_API CExtEntityEvent : public CExtEntityPacket {
     void Copy(const EExtEntityEvent &eeOther, ULONG ctSetFields);
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityEvent);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -237,12 +394,16 @@ class CORE_API CExtEntityInit : public CExtEntityEvent {
 
 class CORE_API CExtEntityTeleport : public CExtEntityPacket {
   public:
-    CExtEntityTeleport() : CExtEntityPacket() {
-      props["plSet"] = CPlacement3D(FLOAT3D(0, 0, 0), ANGLE3D(0, 0, 0)); // Placement to set
-      props["bRelative"] = false; // Relative to the current placement (oriented)
+    CPlacement3D plSet; // Placement to set
+    BOOL bRelative; // Relative to the current placement (oriented)
+
+  public:
+    CExtEntityTeleport() : CExtEntityPacket(), plSet(FLOAT3D(0, 0, 0), ANGLE3D(0, 0, 0)), bRelative(FALSE)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityTeleport);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -252,13 +413,17 @@ class CORE_API CExtEntityTeleport : public CExtEntityPacket {
 
 class CORE_API CExtEntityPosition : public CExtEntityPacket {
   public:
-    CExtEntityPosition() : CExtEntityPacket() {
-      props["vSet"] = FLOAT3D(0, 0, 0); // Position or rotation to set
-      props["bRotation"] = false; // Set rotation instead of position
-      props["bRelative"] = false; // Relative to the current placement (axis-aligned)
+    FLOAT3D vSet; // Position or rotation to set
+    BOOL bRotation; // Set rotation instead of position
+    BOOL bRelative; // Relative to the current placement (axis-aligned)
+
+  public:
+    CExtEntityPosition() : CExtEntityPacket(), vSet(0, 0, 0), bRotation(FALSE), bRelative(FALSE)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityPosition);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -268,11 +433,15 @@ class CORE_API CExtEntityPosition : public CExtEntityPacket {
 
 class CORE_API CExtEntityParent : public CExtEntityPacket {
   public:
-    CExtEntityParent() : CExtEntityPacket() {
-      props["ulParent"] = -1;
+    ULONG ulParent; // Parent entity ID
+
+  public:
+    CExtEntityParent() : CExtEntityPacket(), ulParent(-1)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityParent);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -282,35 +451,39 @@ class CORE_API CExtEntityParent : public CExtEntityPacket {
 
 class CORE_API CExtEntityProp : public CExtEntityPacket {
   public:
-    CExtEntityProp() : CExtEntityPacket() {
-      props["bName"] = false; // Using a name to find the property or not
-      props["ulProp"] = 0; // Property ID or name hash
-      props["value"] = 0.0; // DOUBLE or CTString
+    BOOL bName; // Using a name to find the property or not
+    ULONG ulProp; // Property ID or name hash
+    CAnyValue value; // DOUBLE or CTString
+
+  public:
+    CExtEntityProp() : CExtEntityPacket(), bName(FALSE), ulProp(0), value(0.0)
+    {
     };
 
     // Set property name
     inline void SetProperty(const CTString &strName) {
-      props["bName"].GetIndex() = true;
-      props["ulProp"].GetIndex() = strName.GetHash();
+      bName = TRUE;
+      ulProp = strName.GetHash();
     };
 
     // Set property ID
     inline void SetProperty(ULONG ulID) {
-      props["bName"].GetIndex() = false;
-      props["ulProp"].GetIndex() = ulID;
+      bName = FALSE;
+      ulProp = ulID;
     };
 
     // Set string value
     inline void SetValue(const CTString &str) {
-      props["value"] = str;
+      value = str;
     };
 
     // Set number value
     inline void SetValue(DOUBLE f) {
-      props["value"] = f;
+      value = f;
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityProp);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -320,11 +493,15 @@ class CORE_API CExtEntityProp : public CExtEntityPacket {
 
 class CORE_API CExtEntityHealth : public CExtEntityPacket {
   public:
-    CExtEntityHealth() : CExtEntityPacket() {
-      props["fHealth"] = 0.0f; // Health to set
+    FLOAT fHealth; // Health to set
+
+  public:
+    CExtEntityHealth() : CExtEntityPacket(), fHealth(0.0f)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityHealth);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -334,34 +511,38 @@ class CORE_API CExtEntityHealth : public CExtEntityPacket {
 
 class CORE_API CExtEntityFlags : public CExtEntityPacket {
   public:
-    CExtEntityFlags() : CExtEntityPacket() {
-      props["ulFlags"] = 0; // Flags to apply
-      props["iType"] = 0; // Type of flags
-      props["bRemove"] = false; // Disable flags instead of enabling
+    ULONG ulFlags; // Flags to apply
+    INDEX iType; // Type of flags
+    BOOL bRemove; // Disable flags instead of enabling
+
+  public:
+    CExtEntityFlags() : CExtEntityPacket(), ulFlags(0), iType(0), bRemove(FALSE)
+    {
     };
 
     // Set normal flags
     inline void EntityFlags(ULONG ul, BOOL bRemoveFlags) {
-      props["ulFlags"].GetIndex() = ul;
-      props["iType"].GetIndex() = 0;
-      props["bRemove"].GetIndex() = bRemoveFlags;
+      ulFlags = ul;
+      iType = 0;
+      bRemove = bRemoveFlags;
     };
 
     // Set physical flags
     inline void PhysicalFlags(ULONG ul, BOOL bRemoveFlags) {
-      props["ulFlags"].GetIndex() = ul;
-      props["iType"].GetIndex() = 1;
-      props["bRemove"].GetIndex() = bRemoveFlags;
+      ulFlags = ul;
+      iType = 1;
+      bRemove = bRemoveFlags;
     };
 
     // Set collision flags
     inline void CollisionFlags(ULONG ul, BOOL bRemoveFlags) {
-      props["ulFlags"].GetIndex() = ul;
-      props["iType"].GetIndex() = 2;
-      props["bRemove"].GetIndex() = bRemoveFlags;
+      ulFlags = ul;
+      iType = 2;
+      bRemove = bRemoveFlags;
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityFlags);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -371,11 +552,15 @@ class CORE_API CExtEntityFlags : public CExtEntityPacket {
 
 class CORE_API CExtEntityMove : public CExtEntityPacket {
   public:
-    CExtEntityMove() : CExtEntityPacket() {
-      props["vSpeed"] = FLOAT3D(0, 0, 0); // Desired speed
+    FLOAT3D vSpeed; // Desired speed
+
+  public:
+    CExtEntityMove() : CExtEntityPacket(), vSpeed(0, 0, 0)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityMove);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -410,9 +595,12 @@ class CORE_API CExtEntityImpulse : public CExtEntityMove {
 // Abstract damage packet
 class CORE_API CExtEntityDamage : public CExtEntityPacket {
   public:
-    CExtEntityDamage() : CExtEntityPacket() {
-      props["eDamageType"] = (int)DMT_NONE; // Damage type to use
-      props["fDamage"] = 0.0f; // Damage to inflict
+    INDEX eDamageType; // Damage type to use
+    FLOAT fDamage; // Damage to inflict
+
+  public:
+    CExtEntityDamage() : CExtEntityPacket(), eDamageType(DMT_NONE), fDamage(0.0f)
+    {
     };
 
     virtual bool Write(CNetworkMessage &nm);
@@ -421,13 +609,17 @@ class CORE_API CExtEntityDamage : public CExtEntityPacket {
 
 class CORE_API CExtEntityDirectDamage : public CExtEntityDamage {
   public:
-    CExtEntityDirectDamage() : CExtEntityDamage() {
-      props["ulTarget"] = -1; // Target entity for damaging
-      props["vHitPoint"] = FLOAT3D(0, 0, 0); // Where exactly the damage occurred
-      props["vDirection"] = FLOAT3D(0, 0, 0); // From which direction the damage came from
+    ULONG ulTarget; // Target entity for damaging
+    FLOAT3D vHitPoint; // Where exactly the damage occurred
+    FLOAT3D vDirection; // From which direction the damage came from
+
+  public:
+    CExtEntityDirectDamage() : CExtEntityDamage(), ulTarget(-1), vHitPoint(0, 0, 0), vDirection(0, 0, 0)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityDirDmg);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -437,13 +629,17 @@ class CORE_API CExtEntityDirectDamage : public CExtEntityDamage {
 
 class CORE_API CExtEntityRangeDamage : public CExtEntityDamage {
   public:
-    CExtEntityRangeDamage() : CExtEntityDamage() {
-      props["vCenter"] = FLOAT3D(0, 0, 0); // Place to inflict damage from
-      props["fFallOff"] = 0.0f; // Total damage radius
-      props["fHotSpot"] = 0.0f; // Full damage radius
+    FLOAT3D vCenter; // Place to inflict damage from
+    FLOAT fFallOff; // Total damage radius
+    FLOAT fHotSpot; // Full damage radius
+
+  public:
+    CExtEntityRangeDamage() : CExtEntityDamage(), vCenter(0, 0, 0), fFallOff(0.0f), fHotSpot(0.0f)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityRadDmg);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -453,11 +649,15 @@ class CORE_API CExtEntityRangeDamage : public CExtEntityDamage {
 
 class CORE_API CExtEntityBoxDamage : public CExtEntityDamage {
   public:
-    CExtEntityBoxDamage() : CExtEntityDamage() {
-      props["boxArea"] = FLOATaabbox3D(FLOAT3D(0, 0, 0), 0.0f); // Area to inflict the damage in
+    FLOATaabbox3D boxArea; // Area to inflict the damage in
+
+  public:
+    CExtEntityBoxDamage() : CExtEntityDamage(), boxArea(FLOAT3D(0, 0, 0), 0.0f)
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_EntityBoxDmg);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -467,11 +667,15 @@ class CORE_API CExtEntityBoxDamage : public CExtEntityDamage {
 
 class CORE_API CExtChangeLevel : public CExtPacket {
   public:
-    CExtChangeLevel() {
-      props["strWorld"] = ""; // World file to change to
+    CTString strWorld; // World file to change to
+
+  public:
+    CExtChangeLevel() : strWorld("")
+    {
     };
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_ChangeLevel);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -494,20 +698,22 @@ class CORE_API CExtChangeWorld : public CExtChangeLevel {
 class CORE_API CExtSessionProps : public CExtPacket {
   public:
     CSesPropsContainer sp; // Session properties to set (data that's not processed isn't being zeroed!)
+    INDEX iSize; // Amount of bytes to set
+    INDEX iOffset; // Starting byte (up to NET_MAXSESSIONPROPERTIES - 1)
 
   public:
-    CExtSessionProps() {
-      props["iSize"] = 0; // Amount of bytes to set
-      props["iOffset"] = 0; // Starting byte (up to NET_MAXSESSIONPROPERTIES - 1)
+    CExtSessionProps() : iSize(0), iOffset(0)
+    {
     };
 
-    inline INDEX &GetSize(void) { return props["iSize"].GetIndex(); };
-    inline INDEX &GetOffset(void) { return props["iOffset"].GetIndex(); };
+    inline INDEX &GetSize(void) { return iSize; };
+    inline INDEX &GetOffset(void) { return iOffset; };
 
     // Set new data at the current end and expand session properties size
     BOOL AddData(const void *pData, size_t ctBytes);
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_SessionProps);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -517,9 +723,12 @@ class CORE_API CExtSessionProps : public CExtPacket {
 
 class CORE_API CExtGameplayExt : public CExtPacket {
   public:
-    CExtGameplayExt() {
-      props["iVar"] = 0; // Variable in the structure (0 is invalid, starts from 1)
-      props["value"] = 0.0; // DOUBLE or CTString
+    INDEX iVar; // Variable in the structure (0 is invalid, starts from 1)
+    CAnyValue value; // DOUBLE or CTString
+
+  public:
+    CExtGameplayExt() : iVar(0), value(0.0)
+    {
     };
 
     // Find variable index by its name
@@ -532,6 +741,7 @@ class CORE_API CExtGameplayExt : public CExtPacket {
     void SetValue(const CTString &strVar, DOUBLE f);
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_GameplayExt);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -541,23 +751,27 @@ class CORE_API CExtGameplayExt : public CExtPacket {
 
 class CORE_API CExtPlaySound : public CExtPacket {
   public:
-    CExtPlaySound() {
-      // Sound file to play
-      // - Setting it to "/stop/" stops any playing sound on a specified channel
-      // - Leaving it blank simply changes sound parameters of a channel without playing/resetting any sounds
-      props["strFile"] = "";
+    // Sound file to play
+    // - Setting it to "/stop/" stops any playing sound on a specified channel
+    // - Leaving it blank simply changes sound parameters of a channel without playing/resetting any sounds
+    CTString strFile;
 
-      props["iChannel"] = 0; // Playback channel (0-31)
-      props["ulFlags"] = SOF_NONE; // Playback flags
+    INDEX iChannel; // Playback channel (0-31)
+    ULONG ulFlags; // Playback flags
 
-      // Sound parameters
-      props["fDelay"] = 0.0f; // Playback delay (0.0+)
-      props["fOffset"] = 0.0f; // Playback offset in seconds
-      props["fVolumeL"] = 1.0f; // Left ear volume (0.0 .. 4.0)
-      props["fVolumeR"] = 1.0f; // Right ear volume (0.0 .. 4.0)
-      props["fFilterL"] = 1.0f; // Left ear filter (1.0 .. 500.0)
-      props["fFilterR"] = 1.0f; // Right ear filter (1.0 .. 500.0)
-      props["fPitch"] = 1.0f; // Playback pitch (0.0 .. 10.0)
+    // Sound parameters
+    FLOAT fDelay; // Playback delay (0.0+)
+    FLOAT fOffset; // Playback offset in seconds
+    FLOAT fVolumeL; // Left ear volume (0.0 .. 4.0)
+    FLOAT fVolumeR; // Right ear volume (0.0 .. 4.0)
+    FLOAT fFilterL; // Left ear filter (1.0 .. 500.0)
+    FLOAT fFilterR; // Right ear filter (1.0 .. 500.0)
+    FLOAT fPitch; // Playback pitch (0.0 .. 10.0)
+
+  public:
+    CExtPlaySound() : strFile(""), iChannel(0), ulFlags(SOF_NONE),
+      fDelay(0.0f), fOffset(0.0f), fVolumeL(1.0f), fVolumeR(1.0f), fFilterL(1.0f), fFilterR(1.0f), fPitch(1.0f)
+    {
     };
 
     // Get channel from index
@@ -567,6 +781,7 @@ class CORE_API CExtPlaySound : public CExtPacket {
     static void StopAllSounds(void);
 
   public:
+    EXTPACKET_DECLAREFIELDS;
     EXTPACKET_DEFINEFORTYPE(k_EPacketType_PlaySound);
 
     virtual bool Write(CNetworkMessage &nm);
@@ -21,9 +21,13 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
-bool CExtChangeLevel::Write(CNetworkMessage &nm) {
-  CTString &strWorld = props["strWorld"].GetString();
+const SExtPacketField CExtChangeLevel::_aFields[] = {
+  EXTPACKET_FIELD(CExtChangeLevel, E_STRING, strWorld),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtChangeLevel);
 
+bool CExtChangeLevel::Write(CNetworkMessage &nm) {
   // Store up to 255 characters
   UBYTE ct = (UBYTE)ClampUp(strWorld.Length(), (INDEX)255);
   nm << ct;
@@ -37,7 +41,6 @@ bool CExtChangeLevel::Write(CNetworkMessage &nm) {
 };
 
 void CExtChangeLevel::Read(CNetworkMessage &nm) {
-  CTString &strWorld = props["strWorld"].GetString();
   strWorld = "";
 
   UBYTE ct;
@@ -52,8 +55,6 @@ void CExtChangeLevel::Read(CNetworkMessage &nm) {
 };
 
 void CExtChangeLevel::Process(void) {
-  const CTString &strWorld = props["strWorld"].GetString();
-
   if (!FileExists(strWorld)) {
     ClassicsPackets_ServerReport(this, TRANS("Cannot change world to '%s': World file does not exist\n"), strWorld);
     return;
@@ -92,8 +93,6 @@ void CExtChangeLevel::Process(void) {
 };
 
 void CExtChangeWorld::Process(void) {
-  const CTString &strWorld = props["strWorld"].GetString();
-
   if (!FileExists(strWorld)) {
     ClassicsPackets_ServerReport(this, TRANS("Cannot change world to '%s': World file does not exist\n"), strWorld);
     return;
@@ -19,20 +19,26 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityCopy::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityCopy, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityCopy, E_INDEX, iCopies),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityCopy);
+
 bool CExtEntityCopy::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  INDEX iCopies = props["iCopies"].GetIndex();
-  nm.WriteBits(&iCopies, 5); // Up to 31
+  INDEX iWriteCopies = iCopies;
+  nm.WriteBits(&iWriteCopies, 5); // Up to 31
   return true;
 };
 
 void CExtEntityCopy::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
 
-  INDEX iCopies = 0;
+  iCopies = 0;
   nm.ReadBits(&iCopies, 5);
-  props["iCopies"].GetIndex() = iCopies;
 };
 
 void CExtEntityCopy::Process(void) {
@@ -41,7 +47,6 @@ void CExtEntityCopy::Process(void) {
   if (!EntityExists(pen)) return;
 
   CTString strReport(0, TRANS("Copied %u entity: "), pen->en_ulID);
-  const INDEX iCopies = props["iCopies"].GetIndex();
 
   for (INDEX i = 0; i < iCopies; i++) {
     // Update last created entity
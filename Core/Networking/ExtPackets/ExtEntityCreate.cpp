@@ -182,10 +182,16 @@ static CTString _aBaseClasses[255] = {
 
 CEntity *CExtEntityCreate::penLast = NULL;
 
+const SExtPacketField CExtEntityCreate::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityCreate, E_STRING, fnmClass),
+  EXTPACKET_FIELD(CExtEntityCreate, E_PLACEMENT, plPos),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityCreate);
+
 bool CExtEntityCreate::Write(CNetworkMessage &nm) {
   UBYTE ubClass = 0xFF; // Index in the dictionary (0-254; 255 is invalid)
 
-  const CTFileName fnmClass = props["fnmClass"].GetString();
   CTFileName fnmCheck = fnmClass;
 
   // If class file matches base classes
@@ -211,17 +217,23 @@ bool CExtEntityCreate::Write(CNetworkMessage &nm) {
 
   // Write extra class filename (assume ".ecl" extension)
   if (ubClass == 0xFF) {
-    const CTString strClassName = fnmClass.NoExt();
+    const CTString strClassName = CTFileName(fnmClass).NoExt();
 
-    UBYTE ubLength = strClassName.Length();
-    nm << ubLength;
+    // [Cecil] Clients of other patch versions only read the whole name
+    if (IExtPacketStream::bWritingLegacy) {
+      UBYTE ubLength = strClassName.Length();
+      nm << ubLength;
 
-    for (UBYTE i = 0; i < ubLength; i++) {
-      INetCompress::PathChar(nm, strClassName[i]);
+      for (UBYTE i = 0; i < ubLength; i++) {
+        INetCompress::PathChar(nm, strClassName[i]);
+      }
+
+    } else {
+      WritePath(nm, strClassName);
     }
   }
 
-  INetCompress::Placement(nm, props["plPos"].GetPlacement());
+  INetCompress::Placement(nm, plPos);
   return true;
 };
 
@@ -231,29 +243,21 @@ void CExtEntityCreate::Read(CNetworkMessage &nm) {
 
   // Read extra class filename
   if (ubClass == 0xFF) {
-    UBYTE ubLength;
-    nm >> ubLength;
-
-    // Read each character
-    char strAlloc[256]; // UBYTE maxes out at 255 anyway
-    INDEX iChar;
-
-    for (iChar = 0; iChar < ubLength; iChar++) {
-      strAlloc[iChar] = INetDecompress::PathChar(nm);
-    }
-
-    // Set null-terminator at the end
-    strAlloc[iChar] = '\0';
+    CTString strClassName;
 
     // Assign path to the class
-    props["fnmClass"].GetString() = strAlloc + CTString(".ecl");
+    if (ReadPath(nm, strClassName)) {
+      fnmClass = strClassName + ".ecl";
+    } else {
+      fnmClass = "";
+    }
 
   // Get class from the dictionary
   } else {
-    props["fnmClass"].GetString() = "Classes\\" + _aBaseClasses[ubClass] + ".ecl";
+    fnmClass = "Classes\\" + _aBaseClasses[ubClass] + ".ecl";
   }
 
-  INetDecompress::Placement(nm, props["plPos"].GetPlacement());
+  INetDecompress::Placement(nm, plPos);
 };
 
 void CExtEntityCreate::Process(void) {
@@ -261,9 +265,6 @@ void CExtEntityCreate::Process(void) {
   penLast = NULL;
 
   try {
-    const CTString &fnmClass = props["fnmClass"].GetString();
-    const CPlacement3D &plPos = props["plPos"].GetPlacement();
-
     penLast = IWorld::GetWorld()->CreateEntity_t(plPos, fnmClass);
     ClassicsPackets_ServerReport(this, TRANS("Created '%s' entity (%u)\n"), penLast->GetClass()->ec_pdecDLLClass->dec_strName, penLast->en_ulID);
 
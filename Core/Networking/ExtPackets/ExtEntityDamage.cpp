@@ -19,14 +19,45 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityDirectDamage::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityDirectDamage, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityDirectDamage, E_INDEX, eDamageType),
+  EXTPACKET_FIELD(CExtEntityDirectDamage, E_FLOAT, fDamage),
+  EXTPACKET_FIELD(CExtEntityDirectDamage, E_INDEX, ulTarget),
+  EXTPACKET_FIELD(CExtEntityDirectDamage, E_VECTOR, vHitPoint),
+  EXTPACKET_FIELD(CExtEntityDirectDamage, E_VECTOR, vDirection),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityDirectDamage);
+
+const SExtPacketField CExtEntityRangeDamage::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityRangeDamage, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityRangeDamage, E_INDEX, eDamageType),
+  EXTPACKET_FIELD(CExtEntityRangeDamage, E_FLOAT, fDamage),
+  EXTPACKET_FIELD(CExtEntityRangeDamage, E_VECTOR, vCenter),
+  EXTPACKET_FIELD(CExtEntityRangeDamage, E_FLOAT, fFallOff),
+  EXTPACKET_FIELD(CExtEntityRangeDamage, E_FLOAT, fHotSpot),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityRangeDamage);
+
+const SExtPacketField CExtEntityBoxDamage::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityBoxDamage, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityBoxDamage, E_INDEX, eDamageType),
+  EXTPACKET_FIELD(CExtEntityBoxDamage, E_FLOAT, fDamage),
+  EXTPACKET_FIELD(CExtEntityBoxDamage, E_BOX, boxArea),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityBoxDamage);
+
 bool CExtEntityDamage::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  ULONG ulDamageType = props["eDamageType"].GetIndex();
+  ULONG ulDamageType = eDamageType;
   INetCompress::Integer(nm, ulDamageType);
 
   // Write damage amount up to 2 decimal places
-  ULONG ulDamagePoints = ULONG(props["fDamage"].GetFloat()) * 100;
+  ULONG ulDamagePoints = ULONG(fDamage) * 100;
   INetCompress::Integer(nm, ulDamagePoints);
   return true;
 };
@@ -41,28 +72,25 @@ void CExtEntityDamage::Read(CNetworkMessage &nm) {
   ULONG ulDamagePoints;
   INetDecompress::Integer(nm, ulDamagePoints);
 
-  props["eDamageType"].GetIndex() = ulDamageType;
-  props["fDamage"].GetFloat() = FLOAT(ulDamagePoints) * 0.01f;
+  eDamageType = ulDamageType;
+  fDamage = FLOAT(ulDamagePoints) * 0.01f;
 };
 
 bool CExtEntityDirectDamage::Write(CNetworkMessage &nm) {
   CExtEntityDamage::Write(nm);
 
-  INetCompress::Integer(nm, props["ulTarget"].GetIndex());
-  INetCompress::Float3D(nm, props["vHitPoint"].GetVector());
-  INetCompress::Float3D(nm, props["vDirection"].GetVector());
+  INetCompress::Integer(nm, ulTarget);
+  INetCompress::Float3D(nm, vHitPoint);
+  INetCompress::Float3D(nm, vDirection);
   return true;
 };
 
 void CExtEntityDirectDamage::Read(CNetworkMessage &nm) {
   CExtEntityDamage::Read(nm);
 
-  ULONG ulTarget;
   INetDecompress::Integer(nm, ulTarget);
-  props["ulTarget"].GetIndex() = ulTarget;
-
-  INetDecompress::Float3D(nm, props["vHitPoint"].GetVector());
-  INetDecompress::Float3D(nm, props["vDirection"].GetVector());
+  INetDecompress::Float3D(nm, vHitPoint);
+  INetDecompress::Float3D(nm, vDirection);
 };
 
 void CExtEntityDirectDamage::Process(void) {
@@ -70,17 +98,11 @@ void CExtEntityDirectDamage::Process(void) {
 
   if (!EntityExists(pen)) return;
 
-  const ULONG ulTarget = props["ulTarget"].GetIndex();
   CEntity *penTarget = FindExtEntity(ulTarget);
 
   if (penTarget == NULL) return;
 
-  const DamageType eDamageType = (DamageType)props["eDamageType"].GetIndex();
-  const FLOAT fDamage = props["fDamage"].GetFloat();
-  const FLOAT3D vHitPoint = props["vHitPoint"].GetVector();
-  const FLOAT3D vDirection = props["vDirection"].GetVector();
-
-  pen->InflictDirectDamage(penTarget, pen, eDamageType, fDamage, vHitPoint, vDirection);
+  pen->InflictDirectDamage(penTarget, pen, (DamageType)eDamageType, fDamage, vHitPoint, vDirection);
 
   ClassicsPackets_ServerReport(this, TRANS("Entity %u inflicted %.2f damage to entity %u\n"), pen->en_ulID, fDamage, penTarget->en_ulID);
 };
@@ -88,12 +110,12 @@ void CExtEntityDirectDamage::Process(void) {
 bool CExtEntityRangeDamage::Write(CNetworkMessage &nm) {
   CExtEntityDamage::Write(nm);
 
-  INetCompress::Float3D(nm, props["vCenter"].GetVector());
+  INetCompress::Float3D(nm, vCenter);
 
-  ULONG ulRange = ULONG(props["fFallOff"].GetFloat()) * 10;
+  ULONG ulRange = ULONG(fFallOff) * 10;
   INetCompress::Integer(nm, ulRange);
 
-  ulRange = ULONG(props["fHotSpot"].GetFloat()) * 10;
+  ulRange = ULONG(fHotSpot) * 10;
   INetCompress::Integer(nm, ulRange);
   return true;
 };
@@ -101,14 +123,14 @@ bool CExtEntityRangeDamage::Write(CNetworkMessage &nm) {
 void CExtEntityRangeDamage::Read(CNetworkMessage &nm) {
   CExtEntityDamage::Read(nm);
 
-  INetDecompress::Float3D(nm, props["vCenter"].GetVector());
+  INetDecompress::Float3D(nm, vCenter);
 
   ULONG ulRange;
   INetDecompress::Integer(nm, ulRange);
-  props["fFallOff"].GetFloat() = FLOAT(ulRange) / 10.0f;
+  fFallOff = FLOAT(ulRange) / 10.0f;
 
   INetDecompress::Integer(nm, ulRange);
-  props["fHotSpot"].GetFloat() = FLOAT(ulRange) / 10.0f;
+  fHotSpot = FLOAT(ulRange) / 10.0f;
 };
 
 void CExtEntityRangeDamage::Process(void) {
@@ -116,13 +138,7 @@ void CExtEntityRangeDamage::Process(void) {
 
   if (!EntityExists(pen)) return;
 
-  const DamageType eDamageType = (DamageType)props["eDamageType"].GetIndex();
-  const FLOAT fDamage = props["fDamage"].GetFloat();
-  const FLOAT3D vCenter = props["vCenter"].GetVector();
-  const FLOAT fFallOff = props["fFallOff"].GetFloat();
-  const FLOAT fHotSpot = props["fHotSpot"].GetFloat();
-
-  pen->InflictRangeDamage(pen, eDamageType, fDamage, vCenter, fHotSpot, fFallOff);
+  pen->InflictRangeDamage(pen, (DamageType)eDamageType, fDamage, vCenter, fHotSpot, fFallOff);
 
   ClassicsPackets_ServerReport(this, TRANS("Entity %u inflicted %.2f damage in a %.1f range\n"), pen->en_ulID, fDamage, fFallOff);
 };
@@ -130,7 +146,6 @@ void CExtEntityRangeDamage::Process(void) {
 bool CExtEntityBoxDamage::Write(CNetworkMessage &nm) {
   CExtEntityDamage::Write(nm);
 
-  const FLOATaabbox3D &boxArea = props["boxArea"].GetBox();
   INetCompress::Float3D(nm, boxArea.minvect);
   INetCompress::Float3D(nm, boxArea.maxvect);
   return true;
@@ -139,7 +154,6 @@ bool CExtEntityBoxDamage::Write(CNetworkMessage &nm) {
 void CExtEntityBoxDamage::Read(CNetworkMessage &nm) {
   CExtEntityDamage::Read(nm);
 
-  FLOATaabbox3D &boxArea = props["boxArea"].GetBox();
   INetDecompress::Float3D(nm, boxArea.minvect);
   INetDecompress::Float3D(nm, boxArea.maxvect);
 };
@@ -149,11 +163,7 @@ void CExtEntityBoxDamage::Process(void) {
 
   if (!EntityExists(pen)) return;
 
-  const DamageType eDamageType = (DamageType)props["eDamageType"].GetIndex();
-  const FLOAT fDamage = props["fDamage"].GetFloat();
-  const FLOATaabbox3D &boxArea = props["boxArea"].GetBox();
-
-  pen->InflictBoxDamage(pen, eDamageType, fDamage, boxArea);
+  pen->InflictBoxDamage(pen, (DamageType)eDamageType, fDamage, boxArea);
 
   ClassicsPackets_ServerReport(this, TRANS("Entity %u inflicted %.2f damage in a [%.2f, %.2f, %.2f] sized area\n"),
     pen->en_ulID, fDamage, boxArea.Size()(1), boxArea.Size()(2), boxArea.Size()(3));
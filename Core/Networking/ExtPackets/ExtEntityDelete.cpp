@@ -19,20 +19,26 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityDelete::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityDelete, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityDelete, E_BOOL, bSameClass),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityDelete);
+
 bool CExtEntityDelete::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  BOOL bSameClass = props["bSameClass"].IsTrue();
-  nm.WriteBits(&bSameClass, 1);
+  BOOL bWriteSameClass = (bSameClass != FALSE);
+  nm.WriteBits(&bWriteSameClass, 1);
   return true;
 };
 
 void CExtEntityDelete::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
 
-  BOOL bSameClass = FALSE;
+  bSameClass = FALSE;
   nm.ReadBits(&bSameClass, 1);
-  props["bSameClass"].GetIndex() = bSameClass;
 };
 
 void CExtEntityDelete::Process(void) {
@@ -46,7 +52,7 @@ void CExtEntityDelete::Process(void) {
   }
 
   // Delete all entities of the same class
-  if (props["bSameClass"].IsTrue()) {
+  if (bSameClass) {
     const char *strClass = pen->GetClass()->ec_pdecDLLClass->dec_strName;
     INDEX iClassID = pen->GetClass()->ec_pdecDLLClass->dec_iID;
 
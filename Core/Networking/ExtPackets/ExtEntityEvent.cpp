@@ -19,6 +19,12 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityEvent::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityEvent, E_INDEX, ulEntity),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityEvent);
+
 // Copy event bytes (iEventSize = sizeof(ee))
 void CExtEntityEvent::SetEvent(CEntityEvent &ee, size_t iEventSize) {
   ASSERT(iEventSize <= sizeof(eEvent));
@@ -19,34 +19,38 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityFlags::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityFlags, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityFlags, E_INDEX, ulFlags),
+  EXTPACKET_FIELD(CExtEntityFlags, E_INDEX, iType),
+  EXTPACKET_FIELD(CExtEntityFlags, E_BOOL, bRemove),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityFlags);
+
 bool CExtEntityFlags::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  ULONG ulFlags = props["ulFlags"].GetIndex();
   INetCompress::Integer(nm, ulFlags);
 
-  INDEX iType = props["iType"].GetIndex();
-  nm.WriteBits(&iType, 2);
+  INDEX iWriteType = iType;
+  nm.WriteBits(&iWriteType, 2);
 
-  BOOL bRemove = props["bRemove"].IsTrue();
-  nm.WriteBits(&bRemove, 1);
+  BOOL bWriteRemove = (bRemove != FALSE);
+  nm.WriteBits(&bWriteRemove, 1);
   return true;
 };
 
 void CExtEntityFlags::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
 
-  ULONG ulFlags;
   INetDecompress::Integer(nm, ulFlags);
-  props["ulFlags"].GetIndex() = ulFlags;
 
-  INDEX iType = 0;
+  iType = 0;
   nm.ReadBits(&iType, 2);
-  props["iType"].GetIndex() = iType;
 
-  BOOL bRemove = FALSE;
+  bRemove = FALSE;
   nm.ReadBits(&bRemove, 1);
-  props["bRemove"].GetIndex() = bRemove;
 };
 
 void CExtEntityFlags::Process(void) {
@@ -54,10 +58,6 @@ void CExtEntityFlags::Process(void) {
 
   if (!EntityExists(pen)) return;
 
-  const ULONG ulFlags = props["ulFlags"].GetIndex();
-  const INDEX iType = props["iType"].GetIndex();
-  const BOOL bRemove = props["bRemove"].IsTrue();
-
   ULONG *pulFlags = &pen->en_ulFlags;
   CTString strReport = TRANS("Changed flags of %u entity: 0x%08X -> 0x%08X\n");
 
@@ -19,15 +19,22 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityHealth::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityHealth, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityHealth, E_FLOAT, fHealth),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityHealth);
+
 bool CExtEntityHealth::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
-  INetCompress::Float(nm, props["fHealth"].GetFloat());
+  INetCompress::Float(nm, fHealth);
   return true;
 };
 
 void CExtEntityHealth::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
-  INetDecompress::Float(nm, props["fHealth"].GetFloat());
+  INetDecompress::Float(nm, fHealth);
 };
 
 void CExtEntityHealth::Process(void) {
@@ -36,8 +43,6 @@ void CExtEntityHealth::Process(void) {
   if (!EntityExists(pen)) return;
 
   if (IsLiveEntity(pen)) {
-    FLOAT fHealth = props["fHealth"].GetFloat();
-
     ((CLiveEntity *)pen)->SetHealth(fHealth);
     ClassicsPackets_ServerReport(this, TRANS("Set health of %u entity to %.2f\n"), pen->en_ulID, fHealth);
 
@@ -19,15 +19,22 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityMove::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityMove, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityMove, E_VECTOR, vSpeed),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityMove);
+
 bool CExtEntityMove::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
-  INetCompress::Float3D(nm, props["vSpeed"].GetVector());
+  WriteVector(nm, vSpeed, 0);
   return true;
 };
 
 void CExtEntityMove::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
-  INetDecompress::Float3D(nm, props["vSpeed"].GetVector());
+  ReadVector(nm, vSpeed, 0);
 };
 
 #define REPORT_NOT_MOVABLE TRANS("not a movable entity")
@@ -38,10 +45,12 @@ void CExtEntityMove::Process(void) {
   if (!EntityExists(pen)) return;
 
   if (IsDerivedFromID(pen, CMovableEntity_ClassID)) {
-    CAnyValue &val = props["vSpeed"];
+    ((CMovableEntity *)pen)->SetDesiredTranslation(vSpeed);
 
-    ((CMovableEntity *)pen)->SetDesiredTranslation(val.GetVector());
-    ClassicsPackets_ServerReport(this, TRANS("Changed movement speed of %u entity to %s\n"), pen->en_ulID, val.ToString());
+    if (ClassicsPackets_IsReporting()) {
+      CAnyValue val(vSpeed);
+      ClassicsPackets_ServerReport(this, TRANS("Changed movement speed of %u entity to %s\n"), pen->en_ulID, val.ToString());
+    }
 
   } else {
     ClassicsPackets_ServerReport(this, TRANS("Cannot change movement speed for %u entity: %s\n"), pen->en_ulID, REPORT_NOT_MOVABLE);
@@ -54,10 +63,12 @@ void CExtEntityRotate::Process(void) {
   if (!EntityExists(pen)) return;
 
   if (IsDerivedFromID(pen, CMovableEntity_ClassID)) {
-    CAnyValue &val = props["vSpeed"];
+    ((CMovableEntity *)pen)->SetDesiredRotation(vSpeed);
 
-    ((CMovableEntity *)pen)->SetDesiredRotation(val.GetVector());
-    ClassicsPackets_ServerReport(this, TRANS("Changed rotation speed of %u entity to %s\n"), pen->en_ulID, val.ToString());
+    if (ClassicsPackets_IsReporting()) {
+      CAnyValue val(vSpeed);
+      ClassicsPackets_ServerReport(this, TRANS("Changed rotation speed of %u entity to %s\n"), pen->en_ulID, val.ToString());
+    }
 
   } else {
     ClassicsPackets_ServerReport(this, TRANS("Cannot change rotation speed for %u entity: %s\n"), pen->en_ulID, REPORT_NOT_MOVABLE);
@@ -70,10 +81,12 @@ void CExtEntityImpulse::Process(void) {
   if (!EntityExists(pen)) return;
 
   if (IsDerivedFromID(pen, CMovableEntity_ClassID)) {
-    CAnyValue &val = props["vSpeed"];
+    ((CMovableEntity *)pen)->GiveImpulseTranslationAbsolute(vSpeed);
 
-    ((CMovableEntity *)pen)->GiveImpulseTranslationAbsolute(val.GetVector());
-    ClassicsPackets_ServerReport(this, TRANS("Gave impulse to %u entity: %s\n"), pen->en_ulID, val.ToString());
+    if (ClassicsPackets_IsReporting()) {
+      CAnyValue val(vSpeed);
+      ClassicsPackets_ServerReport(this, TRANS("Gave impulse to %u entity: %s\n"), pen->en_ulID, val.ToString());
+    }
 
   } else {
     ClassicsPackets_ServerReport(this, TRANS("Cannot give impulse to %u entity: %s\n"), pen->en_ulID, REPORT_NOT_MOVABLE);
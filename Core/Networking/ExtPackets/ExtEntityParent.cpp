@@ -19,10 +19,16 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityParent::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityParent, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityParent, E_INDEX, ulParent),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityParent);
+
 bool CExtEntityParent::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  ULONG ulParent = props["ulParent"].GetIndex();
   INetCompress::Integer(nm, ulParent);
   return true;
 };
@@ -30,9 +36,7 @@ bool CExtEntityParent::Write(CNetworkMessage &nm) {
 void CExtEntityParent::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
 
-  ULONG ulParent;
   INetDecompress::Integer(nm, ulParent);
-  props["ulParent"].GetIndex() = ulParent;
 };
 
 void CExtEntityParent::Process(void) {
@@ -40,7 +44,6 @@ void CExtEntityParent::Process(void) {
 
   if (!EntityExists(pen)) return;
 
-  const ULONG ulParent = props["ulParent"].GetIndex();
   CEntity *penParent = FindExtEntity(ulParent);
 
   pen->SetParent(penParent);
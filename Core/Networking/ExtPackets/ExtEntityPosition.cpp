@@ -19,43 +19,66 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityPosition::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityPosition, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityPosition, E_VECTOR, vSet),
+  EXTPACKET_FIELD(CExtEntityPosition, E_BOOL, bRotation),
+  EXTPACKET_FIELD(CExtEntityPosition, E_BOOL, bRelative),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityPosition);
+
 bool CExtEntityPosition::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  BOOL bRotation = props["bRotation"].IsTrue();
-  nm.WriteBits(&bRotation, 1);
+  BOOL bWriteRotation = (bRotation != FALSE);
+  nm.WriteBits(&bWriteRotation, 1);
 
-  const FLOAT3D &vSet = props["vSet"].GetVector();
+  BOOL bWriteRelative = (bRelative != FALSE);
+
+  // [Cecil] Clients of other patch versions read the whole value before the relative flag
+  if (IExtPacketStream::bWritingLegacy) {
+    if (bRotation) {
+      INetCompress::Angle3D(nm, vSet);
+    } else {
+      INetCompress::Float3D(nm, vSet);
+    }
+
+    nm.WriteBits(&bWriteRelative, 1);
+    return true;
+  }
+
+  nm.WriteBits(&bWriteRelative, 1);
+
+  // [Cecil] Absolute and relative values are remembered separately
+  const INDEX iChannel = (bWriteRelative ? 2 : 0);
 
   if (bRotation) {
-    INetCompress::Angle3D(nm, vSet);
+    WriteAngles(nm, vSet, iChannel + 1);
   } else {
-    INetCompress::Float3D(nm, vSet);
+    WriteVector(nm, vSet, iChannel);
   }
 
-  BOOL bRelative = props["bRelative"].IsTrue();
-  nm.WriteBits(&bRelative, 1);
   return true;
 };
 
 void CExtEntityPosition::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
 
-  BOOL bRotation = FALSE;
+  bRotation = FALSE;
   nm.ReadBits(&bRotation, 1);
-  props["bRotation"].GetIndex() = bRotation;
 
-  FLOAT3D &vSet = props["vSet"].GetVector();
+  bRelative = FALSE;
+  nm.ReadBits(&bRelative, 1);
+
+  // [Cecil] Absolute and relative values are remembered separately
+  const INDEX iChannel = (bRelative ? 2 : 0);
 
   if (bRotation) {
-    INetDecompress::Angle3D(nm, vSet);
+    ReadAngles(nm, vSet, iChannel + 1);
   } else {
-    INetDecompress::Float3D(nm, vSet);
+    ReadVector(nm, vSet, iChannel);
   }
-
-  BOOL bRelative = FALSE;
-  nm.ReadBits(&bRelative, 1);
-  props["bRelative"].GetIndex() = bRelative;
 };
 
 void CExtEntityPosition::Process(void) {
@@ -65,10 +88,6 @@ void CExtEntityPosition::Process(void) {
 
   CPlacement3D pl = pen->GetPlacement();
 
-  const FLOAT3D &vSet = props["vSet"].GetVector();
-  const BOOL bRotation = props["bRotation"].IsTrue();
-  const BOOL bRelative = props["bRelative"].IsTrue();
-
   // Relative to absolute axes
   if (bRelative) {
     if (bRotation) {
@@ -88,8 +107,10 @@ void CExtEntityPosition::Process(void) {
 
   pen->Teleport(pl, FALSE);
 
-  CAnyValue val(pl);
-  ClassicsPackets_ServerReport(this, TRANS("Teleported %u entity to %s\n"), pen->en_ulID, val.ToString());
+  if (ClassicsPackets_IsReporting()) {
+    CAnyValue val(pl);
+    ClassicsPackets_ServerReport(this, TRANS("Teleported %u entity to %s\n"), pen->en_ulID, val.ToString());
+  }
 };
 
 #endif // _PATCHCONFIG_EXT_PACKETS
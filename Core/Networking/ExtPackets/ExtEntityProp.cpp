@@ -19,20 +19,29 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityProp::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityProp, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityProp, E_BOOL, bName),
+  EXTPACKET_FIELD(CExtEntityProp, E_INDEX, ulProp),
+  EXTPACKET_FIELD(CExtEntityProp, E_ANY, value),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityProp);
+
 bool CExtEntityProp::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
 
-  BOOL bName = props["bName"].IsTrue();
-  nm.WriteBits(&bName, 1);
-  nm << (ULONG)props["ulProp"].GetIndex();
+  BOOL bWriteName = (bName != FALSE);
+  nm.WriteBits(&bWriteName, 1);
+  nm << ulProp;
 
-  BOOL bString = (props["value"].GetType() == CAnyValue::E_VAL_STRING);
+  BOOL bString = (value.GetType() == CAnyValue::E_VAL_STRING);
   nm.WriteBits(&bString, 1);
 
   if (bString) {
-    nm << props["value"].ToString();
+    nm << value.ToString();
   } else {
-    INetCompress::Double(nm, props["value"].ToFloat());
+    INetCompress::Double(nm, value.ToFloat());
   }
 
   return true;
@@ -41,13 +50,10 @@ bool CExtEntityProp::Write(CNetworkMessage &nm) {
 void CExtEntityProp::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
 
-  BOOL bName = FALSE;
+  bName = FALSE;
   nm.ReadBits(&bName, 1);
-  props["bName"].GetIndex() = bName;
 
-  ULONG ulProp;
   nm >> ulProp;
-  props["ulProp"].GetIndex() = ulProp;
 
   BOOL bString = FALSE;
   nm.ReadBits(&bString, 1);
@@ -55,12 +61,12 @@ void CExtEntityProp::Read(CNetworkMessage &nm) {
   if (bString) {
     CTString strValue;
     nm >> strValue;
-    props["value"] = strValue;
+    value = strValue;
 
   } else {
     DOUBLE fValue;
     INetDecompress::Double(nm, fValue);
-    props["value"] = fValue;
+    value = fValue;
   }
 };
 
@@ -70,9 +76,8 @@ void CExtEntityProp::Process(void) {
   if (!EntityExists(pen)) return;
 
   CEntityProperty *pep = NULL;
-  ULONG ulProp = props["ulProp"].GetIndex();
 
-  if (props["bName"].IsTrue()) {
+  if (bName) {
     pep = IWorld::PropertyForHash(pen, ulProp);
   } else {
     pep = IWorld::PropertyForId(pen, ulProp);
@@ -82,22 +87,22 @@ void CExtEntityProp::Process(void) {
 
   INDEX iType = IProperties::ConvertType(pep->ep_eptType);
 
-  bool bString = (props["value"].GetType() == CAnyValue::E_VAL_STRING);
+  bool bString = (value.GetType() == CAnyValue::E_VAL_STRING);
 
   if (bString) {
     if (iType == CEntityProperty::EPT_STRING) {
-      CTString &strValue = props["value"].GetString();
+      CTString &strValue = value.GetString();
       IProperties::SetPropValue(pen, pep, &strValue);
     } else {
       ClassicsPackets_ServerReport(this, TRANS("Expected string property type but got %d\n"), iType);
     }
 
   } else if (iType == CEntityProperty::EPT_FLOAT) {
-    FLOAT fFloatProp = props["value"].ToFloat();
+    FLOAT fFloatProp = value.ToFloat();
     IProperties::SetPropValue(pen, pep, &fFloatProp);
 
   } else if (iType == CEntityProperty::EPT_INDEX) {
-    INDEX iIntProp = props["value"].ToIndex();
+    INDEX iIntProp = value.ToIndex();
     IProperties::SetPropValue(pen, pep, &iIntProp);
 
   } else {
@@ -19,22 +19,45 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtEntityTeleport::_aFields[] = {
+  EXTPACKET_FIELD(CExtEntityTeleport, E_INDEX, ulEntity),
+  EXTPACKET_FIELD(CExtEntityTeleport, E_PLACEMENT, plSet),
+  EXTPACKET_FIELD(CExtEntityTeleport, E_BOOL, bRelative),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtEntityTeleport);
+
 bool CExtEntityTeleport::Write(CNetworkMessage &nm) {
   WriteEntity(nm);
-  INetCompress::Placement(nm, props["plSet"].GetPlacement());
 
-  BOOL bRelative = props["bRelative"].IsTrue();
-  nm.WriteBits(&bRelative, 1);
+  BOOL bWriteRelative = (bRelative != FALSE);
+
+  // [Cecil] Clients of other patch versions read the whole placement before the relative flag
+  if (IExtPacketStream::bWritingLegacy) {
+    INetCompress::Placement(nm, plSet);
+    nm.WriteBits(&bWriteRelative, 1);
+    return true;
+  }
+
+  nm.WriteBits(&bWriteRelative, 1);
+
+  // [Cecil] Absolute and relative values are remembered separately
+  const INDEX iChannel = (bWriteRelative ? 2 : 0);
+  WriteVector(nm, plSet.pl_PositionVector, iChannel);
+  WriteAngles(nm, plSet.pl_OrientationAngle, iChannel + 1);
   return true;
 };
 
 void CExtEntityTeleport::Read(CNetworkMessage &nm) {
   ReadEntity(nm);
-  INetDecompress::Placement(nm, props["plSet"].GetPlacement());
 
-  BOOL bRelative = FALSE;
+  bRelative = FALSE;
   nm.ReadBits(&bRelative, 1);
-  props["bRelative"].GetIndex() = bRelative;
+
+  // [Cecil] Absolute and relative values are remembered separately
+  const INDEX iChannel = (bRelative ? 2 : 0);
+  ReadVector(nm, plSet.pl_PositionVector, iChannel);
+  ReadAngles(nm, plSet.pl_OrientationAngle, iChannel + 1);
 };
 
 void CExtEntityTeleport::Process(void) {
@@ -42,18 +65,20 @@ void CExtEntityTeleport::Process(void) {
 
   if (!EntityExists(pen)) return;
 
-  CAnyValue &val = props["plSet"];
-  CPlacement3D pl = val.GetPlacement();
+  CPlacement3D pl = plSet;
 
   // Relative to current position and orientation
-  if (props["bRelative"].IsTrue())
+  if (bRelative)
   {
     pl.RelativeToAbsoluteSmooth(pen->GetPlacement());
   }
 
   pen->Teleport(pl, FALSE);
 
-  ClassicsPackets_ServerReport(this, TRANS("Teleported %u entity to %s\n"), pen->en_ulID, val.ToString());
+  if (ClassicsPackets_IsReporting()) {
+    CAnyValue val(plSet);
+    ClassicsPackets_ServerReport(this, TRANS("Teleported %u entity to %s\n"), pen->en_ulID, val.ToString());
+  }
 };
 
 #endif // _PATCHCONFIG_EXT_PACKETS
@@ -19,6 +19,13 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #if _PATCHCONFIG_EXT_PACKETS
 
+const SExtPacketField CExtGameplayExt::_aFields[] = {
+  EXTPACKET_FIELD(CExtGameplayExt, E_INDEX, iVar),
+  EXTPACKET_FIELD(CExtGameplayExt, E_ANY, value),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtGameplayExt);
+
 // Find variable index by its name
 int CExtGameplayExt::FindVar(const CTString &strVar) {
 #if _PATCHCONFIG_GAMEPLAY_EXT
@@ -37,14 +44,14 @@ int CExtGameplayExt::FindVar(const CTString &strVar) {
 
 // Set string value
 void CExtGameplayExt::SetValue(const CTString &strVar, const CTString &str) {
-  props["iVar"] = FindVar(strVar);
-  props["value"] = str;
+  iVar = FindVar(strVar);
+  value = str;
 };
 
 // Set number value
 void CExtGameplayExt::SetValue(const CTString &strVar, DOUBLE f) {
-  props["iVar"] = FindVar(strVar);
-  props["value"] = f;
+  iVar = FindVar(strVar);
+  value = f;
 };
 
 bool CExtGameplayExt::Write(CNetworkMessage &nm) {
@@ -52,17 +59,17 @@ bool CExtGameplayExt::Write(CNetworkMessage &nm) {
 
   // It's not like there will ever be more than 16383 GEX variables,
   // plus if 'value' is 0.0, it'll all be neatly packed in just 2 bytes!
-  UWORD iVar = props["iVar"].GetIndex();
-  if (iVar == 0) return false;
+  UWORD uwVar = iVar;
+  if (uwVar == 0) return false;
 
-  BOOL bString = (props["value"].GetType() == CAnyValue::E_VAL_STRING);
-  nm.WriteBits(&iVar, 14);
+  BOOL bString = (value.GetType() == CAnyValue::E_VAL_STRING);
+  nm.WriteBits(&uwVar, 14);
   nm.WriteBits(&bString, 1);
 
   if (bString) {
-    nm << props["value"].ToString();
+    nm << value.ToString();
   } else {
-    INetCompress::Double(nm, props["value"].ToFloat());
+    INetCompress::Double(nm, value.ToFloat());
   }
 
   return true;
@@ -74,23 +81,23 @@ bool CExtGameplayExt::Write(CNetworkMessage &nm) {
 void CExtGameplayExt::Read(CNetworkMessage &nm) {
 #if _PATCHCONFIG_GAMEPLAY_EXT
 
-  UWORD iVar = 0;
+  UWORD uwVar = 0;
   BOOL bString = FALSE;
 
-  nm.ReadBits(&iVar, 14);
+  nm.ReadBits(&uwVar, 14);
   nm.ReadBits(&bString, 1);
 
-  props["iVar"] = (int)iVar;
+  iVar = uwVar;
 
   if (bString) {
     CTString strValue;
     nm >> strValue;
-    props["value"] = strValue;
+    value = strValue;
 
   } else {
     DOUBLE fValue;
     INetDecompress::Double(nm, fValue);
-    props["value"] = fValue;
+    value = fValue;
   }
 
 #endif // _PATCHCONFIG_GAMEPLAY_EXT
@@ -100,13 +107,13 @@ void CExtGameplayExt::Process(void) {
 #if _PATCHCONFIG_GAMEPLAY_EXT
 
   // Invalid offset
-  INDEX iGameplayExt = props["iVar"].GetIndex() - 1;
+  INDEX iGameplayExt = iVar - 1;
   if (iGameplayExt < 0 || iGameplayExt >= k_EGameplayExt_Max) return;
 
   IConfig::NamedValue &entry = IConfig::gex.props[iGameplayExt];
   CAnyValue::EType eType = entry.val.GetType();
 
-  bool bString = (props["value"].GetType() == CAnyValue::E_VAL_STRING);
+  bool bString = (value.GetType() == CAnyValue::E_VAL_STRING);
 
   // Got a number but expected a string
   if (!bString && eType == CAnyValue::E_VAL_STRING) {
@@ -121,10 +128,10 @@ void CExtGameplayExt::Process(void) {
 
   // Set new value depending on type
   switch (eType) {
-    case CAnyValue::E_VAL_BOOL:   entry.val.GetIndex()  = props["value"].GetDouble(); break;
-    case CAnyValue::E_VAL_INDEX:  entry.val.GetIndex()  = props["value"].GetDouble(); break;
-    case CAnyValue::E_VAL_FLOAT:  entry.val.GetFloat()  = props["value"].GetDouble(); break;
-    case CAnyValue::E_VAL_STRING: entry.val.GetString() = props["value"].GetString(); break;
+    case CAnyValue::E_VAL_BOOL:   entry.val.GetIndex()  = value.GetDouble(); break;
+    case CAnyValue::E_VAL_INDEX:  entry.val.GetIndex()  = value.GetDouble(); break;
+    case CAnyValue::E_VAL_FLOAT:  entry.val.GetFloat()  = value.GetDouble(); break;
+    case CAnyValue::E_VAL_STRING: entry.val.GetString() = value.GetString(); break;
   }
 
 #else
@@ -27,6 +27,21 @@ static CSoundObject _asoChannels[32];
 // Played at least one sound
 static BOOL _bPlayedSound = FALSE;
 
+const SExtPacketField CExtPlaySound::_aFields[] = {
+  EXTPACKET_FIELD(CExtPlaySound, E_STRING, strFile),
+  EXTPACKET_FIELD(CExtPlaySound, E_INDEX, iChannel),
+  EXTPACKET_FIELD(CExtPlaySound, E_INDEX, ulFlags),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fDelay),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fOffset),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fVolumeL),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fVolumeR),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fFilterL),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fFilterR),
+  EXTPACKET_FIELD(CExtPlaySound, E_FLOAT, fPitch),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtPlaySound);
+
 // Get channel from index
 CSoundObject *CExtPlaySound::GetChannel(INDEX iChannel) {
   if (iChannel < 0 || iChannel > 31) return NULL;
@@ -82,68 +97,73 @@ static inline FLOAT DecompressPitch(UWORD uwPitch) {
 
 bool CExtPlaySound::Write(CNetworkMessage &nm)
 {
-  INDEX iChannel = props["iChannel"].GetIndex();
-
   // Invalid channel
   if (iChannel < 0 || iChannel > 31) {
     return false;
   }
 
-  nm << props["strFile"].GetString();
+  // [Cecil] Clients of other patch versions only read the whole path
+  if (IExtPacketStream::bWritingLegacy) {
+    nm << strFile;
+  } else {
+    WritePath(nm, strFile);
+  }
 
   // Channel index occupies 5/16 bits
-  nm.WriteBits(&iChannel, 5);
+  INDEX iWriteChannel = iChannel;
+  nm.WriteBits(&iWriteChannel, 5);
 
   // Flags occupy 11/16 bits
-  INDEX iFlags = props["ulFlags"].GetIndex();
-  nm.WriteBits(&iFlags, 11);
-
-  nm << props["fDelay"].GetFloat();
-  nm << props["fOffset"].GetFloat();
-  nm << CompressVolume(props["fVolumeL"].GetFloat());
-  nm << CompressVolume(props["fVolumeR"].GetFloat());
-  nm << CompressFilter(props["fFilterL"].GetFloat());
-  nm << CompressFilter(props["fFilterR"].GetFloat());
-  nm << CompressPitch(props["fPitch"].GetFloat());
+  ULONG ulWriteFlags = ulFlags;
+  nm.WriteBits(&ulWriteFlags, 11);
+
+  nm << fDelay;
+  nm << fOffset;
+  nm << CompressVolume(fVolumeL);
+  nm << CompressVolume(fVolumeR);
+  nm << CompressFilter(fFilterL);
+  nm << CompressFilter(fFilterR);
+  nm << CompressPitch(fPitch);
   return true;
 };
 
 void CExtPlaySound::Read(CNetworkMessage &nm) {
-  nm >> props["strFile"].GetString();
+  const BOOL bKnownFile = ReadPath(nm, strFile);
 
   // Channel index occupies 5/16 bits
-  INDEX iChannel = 0;
+  iChannel = 0;
   nm.ReadBits(&iChannel, 5);
-  props["iChannel"].GetIndex() = iChannel;
 
   // Flags occupy 11/16 bits
-  ULONG ulFlags = 0;
+  ulFlags = 0;
   nm.ReadBits(&ulFlags, 11);
-  props["ulFlags"].GetIndex() = ulFlags;
 
-  nm >> props["fDelay"].GetFloat();
-  nm >> props["fOffset"].GetFloat();
+  nm >> fDelay;
+  nm >> fOffset;
 
   UBYTE ubVolume;
   UWORD uwFilter, uwPitch;
 
   nm >> ubVolume;
-  props["fVolumeL"].GetFloat() = DecompressVolume(ubVolume);
+  fVolumeL = DecompressVolume(ubVolume);
   nm >> ubVolume;
-  props["fVolumeR"].GetFloat() = DecompressVolume(ubVolume);
+  fVolumeR = DecompressVolume(ubVolume);
 
   nm >> uwFilter;
-  props["fFilterL"].GetFloat() = DecompressFilter(uwFilter);
+  fFilterL = DecompressFilter(uwFilter);
   nm >> uwFilter;
-  props["fFilterR"].GetFloat() = DecompressFilter(uwFilter);
+  fFilterR = DecompressFilter(uwFilter);
 
   nm >> uwPitch;
-  props["fPitch"].GetFloat() = DecompressPitch(uwPitch);
+  fPitch = DecompressPitch(uwPitch);
+
+  // Don't change anything on the channel if the sound is unknown
+  if (!bKnownFile) {
+    iChannel = -1;
+  }
 };
 
 void CExtPlaySound::Process(void) {
-  INDEX iChannel = props["iChannel"].GetIndex();
-
   // Invalid channel
   if (iChannel < 0 || iChannel > 31) {
     ClassicsPackets_ServerReport(this, TRANS("Invalid channel index: %d\n"), iChannel);
@@ -151,8 +171,6 @@ void CExtPlaySound::Process(void) {
   }
 
   CSoundObject &so = _asoChannels[iChannel];
-  CTString strFile = props["strFile"].GetString();
-
   // Stop playing on a specific channel
   if (strFile == "/stop/") {
     so.Stop();
@@ -160,15 +178,15 @@ void CExtPlaySound::Process(void) {
   }
 
   // Set sound parameters for a specific channel
-  so.SetDelay(props["fDelay"].GetFloat());
-  so.SetVolume(props["fVolumeL"].GetFloat(), props["fVolumeR"].GetFloat());
-  so.SetFilter(props["fFilterL"].GetFloat(), props["fFilterR"].GetFloat());
-  so.SetPitch(props["fPitch"].GetFloat());
+  so.SetDelay(fDelay);
+  so.SetVolume(fVolumeL, fVolumeR);
+  so.SetFilter(fFilterL, fFilterR);
+  so.SetPitch(fPitch);
 
   // Play a new sound
   if (strFile != "") {
     try {
-      so.Play_t(strFile, props["ulFlags"].GetIndex());
+      so.Play_t(strFile, ulFlags);
     } catch (char *strError) {
       ClassicsPackets_ServerReport(this, TRANS("Cannot play '%s' sound: %s\n"), strFile.str_String, strError);
     }
@@ -177,7 +195,6 @@ void CExtPlaySound::Process(void) {
   }
 
   // Set offset after playing the sound
-  const FLOAT fOffset = props["fOffset"].GetFloat();
   ISounds::SetOffset(so, fOffset, fOffset);
 };
 
@@ -22,6 +22,13 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // [Cecil] NOTE: Assume that NET_MAXSESSIONPROPERTIES is 2048
 #define SESPROPS_BITFIT 11
 
+const SExtPacketField CExtSessionProps::_aFields[] = {
+  EXTPACKET_FIELD(CExtSessionProps, E_INDEX, iSize),
+  EXTPACKET_FIELD(CExtSessionProps, E_INDEX, iOffset),
+};
+
+EXTPACKET_DEFINEFIELDS(CExtSessionProps);
+
 // Set new data at the current end and expand session properties size
 BOOL CExtSessionProps::AddData(const void *pData, size_t ctBytes) {
   INDEX &ctSize = GetSize();
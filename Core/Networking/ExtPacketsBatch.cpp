@@ -0,0 +1,234 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "ExtPackets.h"
+#include "NetworkFunctions.h"
+
+#if _PATCHCONFIG_EXT_PACKETS
+
+// Collect packets sent during a tick and send them to clients as one block
+INDEX ser_bBatchExtPackets = TRUE;
+
+// Start writing packets into another block after this many bytes
+// (leaves plenty of space for one more packet before reaching the message limit)
+static const SLONG _slMaxBatchBytes = 1024;
+
+// Packet waiting to be sent
+struct SQueuedPacket {
+  CExtPacket *pPacket; // NULL if it has been replaced by a newer packet
+  BOOL bReplaceable; // Can be replaced by a newer packet of the same kind
+};
+
+static CStaticStackArray<SQueuedPacket> _aQueue;
+
+// First packet that can still be replaced (everything before it is behind a non-replaceable packet)
+static INDEX _iFirstReplaceable = 0;
+
+// Amount of packets that will actually be sent
+static INDEX _ctQueued = 0;
+
+// Check if a packet can be written in the middle of a block
+static BOOL CanBatch(CExtPacket *pck) {
+  switch (pck->GetType()) {
+    // Entity packets that are always written
+    case IClassicsExtPacket::k_EPacketType_EntityCreate:
+    case IClassicsExtPacket::k_EPacketType_EntityDelete:
+    case IClassicsExtPacket::k_EPacketType_EntityCopy:
+    case IClassicsExtPacket::k_EPacketType_EntityEvent:
+    case IClassicsExtPacket::k_EPacketType_EntityItem:
+    case IClassicsExtPacket::k_EPacketType_EntityInit:
+    case IClassicsExtPacket::k_EPacketType_EntityTeleport:
+    case IClassicsExtPacket::k_EPacketType_EntityPosition:
+    case IClassicsExtPacket::k_EPacketType_EntityParent:
+    case IClassicsExtPacket::k_EPacketType_EntityHealth:
+    case IClassicsExtPacket::k_EPacketType_EntityFlags:
+    case IClassicsExtPacket::k_EPacketType_EntityMove:
+    case IClassicsExtPacket::k_EPacketType_EntityRotate:
+    case IClassicsExtPacket::k_EPacketType_EntityImpulse:
+    case IClassicsExtPacket::k_EPacketType_EntityDirDmg:
+    case IClassicsExtPacket::k_EPacketType_EntityRadDmg:
+    case IClassicsExtPacket::k_EPacketType_EntityBoxDmg:
+      return TRUE;
+
+    // Strings of any length are sent separately
+    case IClassicsExtPacket::k_EPacketType_EntityProp:
+      return ((CExtEntityProp *)pck)->value.GetType() != CAnyValue::E_VAL_STRING;
+  }
+
+  // Level changes, session properties etc. may be too big or may not be written at all
+  return FALSE;
+};
+
+// Check if a packet only sets some state that a newer packet of the same kind would overwrite
+static BOOL IsReplaceable(CExtPacket *pck) {
+  switch (pck->GetType()) {
+    case IClassicsExtPacket::k_EPacketType_EntityTeleport:
+      return !((CExtEntityTeleport *)pck)->bRelative;
+
+    case IClassicsExtPacket::k_EPacketType_EntityPosition:
+      return !((CExtEntityPosition *)pck)->bRelative;
+
+    case IClassicsExtPacket::k_EPacketType_EntityParent:
+    case IClassicsExtPacket::k_EPacketType_EntityProp:
+    case IClassicsExtPacket::k_EPacketType_EntityHealth:
+    case IClassicsExtPacket::k_EPacketType_EntityMove:
+    case IClassicsExtPacket::k_EPacketType_EntityRotate:
+      return TRUE;
+  }
+
+  return FALSE;
+};
+
+// Check if a newer replaceable packet overwrites the state set by an older one
+static BOOL Overwrites(CExtPacket *pckNew, CExtPacket *pckOld) {
+  const IClassicsExtPacket::EPacketType eType = pckNew->GetType();
+  if (eType != pckOld->GetType()) return FALSE;
+
+  // Different entities
+  if (((CExtEntityPacket *)pckNew)->ulEntity != ((CExtEntityPacket *)pckOld)->ulEntity) return FALSE;
+
+  switch (eType) {
+    // Same component of the placement
+    case IClassicsExtPacket::k_EPacketType_EntityPosition:
+      return ((CExtEntityPosition *)pckNew)->bRotation == ((CExtEntityPosition *)pckOld)->bRotation;
+
+    // Same property
+    case IClassicsExtPacket::k_EPacketType_EntityProp: {
+      CExtEntityProp &pckPropNew = *(CExtEntityProp *)pckNew;
+      CExtEntityProp &pckPropOld = *(CExtEntityProp *)pckOld;
+      return pckPropNew.bName == pckPropOld.bName && pckPropNew.ulProp == pckPropOld.ulProp;
+    }
+  }
+
+  return TRUE;
+};
+
+// Queue packet to be sent by the end of the tick (returns FALSE if it should be sent right away)
+BOOL IExtPacketBatch::Queue(CExtPacket *pExtPacket) {
+  // Clients of other patch versions cannot read blocks with multiple packets
+  if (!CanBatch(pExtPacket) || IExtPacketStream::AnyLegacyClients()) return FALSE;
+
+  // Synchronize with flushing from the timer
+  CTSingleLock slNetwork(&_pNetwork->ga_csNetwork, TRUE);
+
+  const BOOL bReplaceable = IsReplaceable(pExtPacket);
+
+  // Remove the last packet of the same kind, since the new one will overwrite its state anyway
+  // Only packets after the last non-replaceable one are checked, so the order of everything else stays the same
+  if (bReplaceable) {
+    for (INDEX i = _aQueue.Count() - 1; i >= _iFirstReplaceable; i--) {
+      SQueuedPacket &qp = _aQueue[i];
+      if (qp.pPacket == NULL || !Overwrites(pExtPacket, qp.pPacket)) continue;
+
+      delete qp.pPacket;
+      qp.pPacket = NULL;
+      _ctQueued--;
+      break;
+    }
+  }
+
+  SQueuedPacket &qpNew = _aQueue.Push();
+  qpNew.pPacket = CExtPacket::CopyPacket(*pExtPacket);
+  qpNew.bReplaceable = bReplaceable;
+  _ctQueued++;
+
+  if (!bReplaceable) {
+    _iFirstReplaceable = _aQueue.Count();
+  }
+
+  return TRUE;
+};
+
+// Send all queued packets to clients
+void IExtPacketBatch::Flush(void) {
+  // Synchronize with the network loop, since packets are encoded in the order they are sent
+  CTSingleLock slNetwork(&_pNetwork->ga_csNetwork, TRUE);
+  if (_aQueue.Count() == 0) return;
+
+  // Not running a server anymore
+  if (!_pNetwork->IsServer()) {
+    Discard();
+    return;
+  }
+
+  const INDEX ctPackets = _aQueue.Count();
+  INDEX iPacket = 0;
+
+  // Send a single packet as is or each packet separately if some client connected since they have been queued
+  if (_ctQueued == 1 || IExtPacketStream::AnyLegacyClients()) {
+    for (; iPacket < ctPackets; iPacket++) {
+      CExtPacket *pck = _aQueue[iPacket].pPacket;
+      if (pck == NULL) continue;
+
+      IExtPacketStream::Send(pck);
+    }
+
+    Discard();
+    return;
+  }
+
+  // Write packets into as few blocks as possible
+  while (iPacket < ctPackets) {
+    CNetStreamBlock nsbBatch = INetwork::CreateServerPacket(ulBatchType);
+    INDEX ctWritten = 0;
+
+    for (; iPacket < ctPackets; iPacket++) {
+      CExtPacket *pck = _aQueue[iPacket].pPacket;
+      if (pck == NULL) continue;
+
+      // Continue in the next block
+      if (ctWritten > 0 && nsbBatch.nm_pubPointer - nsbBatch.nm_pubMessage >= _slMaxBatchBytes) break;
+
+      // Each packet is prefixed with a bit that says that there's one more
+      UBYTE ubNext = 1;
+      nsbBatch.WriteBits(&ubNext, 1);
+
+      INetCompress::Integer(nsbBatch, pck->GetType());
+      IExtPacketStream::Write(pck, nsbBatch);
+      ctWritten++;
+    }
+
+    // End of the block
+    UBYTE ubNext = 0;
+    nsbBatch.WriteBits(&ubNext, 1);
+
+    if (ctWritten > 0) {
+      INetwork::AddBlockToAllSessions(nsbBatch);
+
+    // Restore the sequence if there was nothing left to write
+    } else {
+      _pNetwork->ga_srvServer.srv_iLastProcessedSequence--;
+    }
+  }
+
+  Discard();
+};
+
+// Discard all queued packets without sending them
+void IExtPacketBatch::Discard(void) {
+  CTSingleLock slNetwork(&_pNetwork->ga_csNetwork, TRUE);
+
+  for (INDEX i = 0; i < _aQueue.Count(); i++) {
+    delete _aQueue[i].pPacket;
+  }
+
+  _aQueue.PopAll();
+  _iFirstReplaceable = 0;
+  _ctQueued = 0;
+};
+
+#endif // _PATCHCONFIG_EXT_PACKETS
@@ -0,0 +1,728 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "ExtPackets.h"
+#include "NetworkFunctions.h"
+#include "MessageProcessing.h"
+
+#if _PATCHCONFIG_EXT_PACKETS
+
+// Fractional bits of positions and speeds that are sent as differences from previous values (-1 to disable)
+INDEX ser_iExtPacketPrecision = 7;
+
+// How many times in a row a value can be sent as a difference before sending the whole value again
+INDEX ser_iExtPacketKeyframe = 20;
+
+CNetworkMessage *IExtPacketStream::pnmWriting = NULL;
+CNetworkMessage *IExtPacketStream::pnmReading = NULL;
+BOOL IExtPacketStream::bWritingLegacy = FALSE;
+BOOL IExtPacketStream::bWritingWhole = FALSE;
+
+// Values cannot be quantized beyond this limit
+static const DOUBLE _dMaxQuantized = DOUBLE(1 << 30);
+
+// Last value that has been sent through the game stream for some entity
+struct SStreamBaseline {
+  ULONG ulEntity; // Entity ID (0 if unused)
+  ULONG ulChannel; // Packet type and its value
+  INDEX iPrecision; // Fractional bits of quantized values (-1 for angles)
+  INDEX ctDeltas; // Differences sent since the whole value
+  SLONG aslValue[3]; // Quantized value
+};
+
+// Amount of remembered values (must be a power of two)
+#define STREAM_BASELINES 4096
+
+// Values on both sides are remembered in the same exact slots
+static SStreamBaseline _asbWriting[STREAM_BASELINES];
+static SStreamBaseline _asbReading[STREAM_BASELINES];
+
+// Sizes of packets sent through the game stream
+struct SStreamStats {
+  INDEX ctPackets;
+  SLONG slBits;
+};
+
+// Resource path that has been sent through the game stream
+struct SStreamPath {
+  CTString strPath; // Path as it's read on the other side (empty if unused)
+  ULONG ulHash; // Hash of the path
+  INDEX iLastUse; // Order of the last use for replacing least recently used paths
+};
+
+// Amount of remembered paths (fits into 6 bits)
+#define STREAM_PATHS 64
+
+static SStreamPath _aspWriting[STREAM_PATHS];
+static SStreamPath _aspReading[STREAM_PATHS];
+static INDEX _iLastPathUse = 0;
+
+static SStreamStats _aStreamStats[IClassicsExtPacket::k_EPacketType_LastS2C + 1];
+static INDEX _ctWholeValues = 0;
+static INDEX _ctDeltaValues = 0;
+
+// Get current size of the message in bits
+static inline SLONG GetBitPosition(CNetworkMessage &nm) {
+  return SLONG(nm.nm_pubPointer - nm.nm_pubMessage) * 8 + nm.nm_iBit;
+};
+
+// Get slot for a value of some entity
+static inline SStreamBaseline &GetBaseline(SStreamBaseline *asb, ULONG ulEntity, ULONG ulChannel) {
+  const ULONG ulHash = (ulEntity * 2654435761UL) ^ (ulChannel * 40503UL);
+  return asb[(ulHash >> 16) & (STREAM_BASELINES - 1)];
+};
+
+// Check if the slot holds a value of some entity
+static inline BOOL MatchesBaseline(const SStreamBaseline &sb, ULONG ulEntity, ULONG ulChannel) {
+  return sb.ulEntity == ulEntity && sb.ulChannel == ulChannel;
+};
+
+// Convert vector into fixed-point values
+static BOOL QuantizeVector(const FLOAT3D &v, INDEX iPrecision, SLONG aslValue[3]) {
+  const DOUBLE dScale = DOUBLE(1 << iPrecision);
+
+  for (INDEX i = 0; i < 3; i++) {
+    const DOUBLE dValue = floor(DOUBLE(v(i + 1)) * dScale + 0.5);
+    if (dValue <= -_dMaxQuantized || dValue >= _dMaxQuantized) return FALSE;
+
+    aslValue[i] = (SLONG)dValue;
+  }
+
+  return TRUE;
+};
+
+// Convert fixed-point values back into a vector
+static void DequantizeVector(const SLONG aslValue[3], INDEX iPrecision, FLOAT3D &v) {
+  const DOUBLE dScale = DOUBLE(1 << iPrecision);
+
+  for (INDEX i = 0; i < 3; i++) {
+    v(i + 1) = DOUBLE(aslValue[i]) / dScale;
+  }
+};
+
+// Write packet into a game stream block
+bool IExtPacketStream::Write(CExtPacket *pExtPacket, CNetworkMessage &nm) {
+  const SLONG slStart = GetBitPosition(nm);
+
+  pnmWriting = &nm;
+  const bool bWritten = pExtPacket->Write(nm);
+  pnmWriting = NULL;
+
+  if (bWritten) {
+    const ULONG ulType = pExtPacket->GetType();
+
+    if (ulType <= IClassicsExtPacket::k_EPacketType_LastS2C) {
+      SStreamStats &ss = _aStreamStats[ulType];
+      ss.ctPackets++;
+      ss.slBits += GetBitPosition(nm) - slStart;
+    }
+  }
+
+  return bWritten;
+};
+
+// Read packet from a game stream block
+void IExtPacketStream::Read(CExtPacket *pExtPacket, CNetworkMessage &nm) {
+  pnmReading = &nm;
+  pExtPacket->Read(nm);
+  pnmReading = NULL;
+};
+
+// Check if any active client runs another patch version and can only read packets in the old format
+BOOL IExtPacketStream::AnyLegacyClients(void) {
+  CServer &srv = _pNetwork->ga_srvServer;
+
+  for (INDEX i = 1; i < srv.srv_assoSessions.Count(); i++) {
+    if (srv.srv_assoSessions[i].IsActive() && !IProcessPacket::HasSamePatch(i)) return TRUE;
+  }
+
+  return FALSE;
+};
+
+// Write packet into a new game stream block and send it to all clients (returns false if it hasn't been written)
+bool IExtPacketStream::Send(CExtPacket *pExtPacket) {
+  CServer &srv = _pNetwork->ga_srvServer;
+  const ULONG ulType = pExtPacket->GetType();
+
+  CNetStreamBlock nsbExt = INetwork::CreateServerPacket(ulType);
+
+  // Clients of other patch versions only read whole values, so don't send approximated differences
+  // to anyone else either, otherwise entities would end up in slightly different places for them
+  const BOOL bLegacy = AnyLegacyClients();
+
+  bWritingWhole = bLegacy;
+  const bool bWritten = Write(pExtPacket, nsbExt);
+  bWritingWhole = FALSE;
+
+  // Restore the sequence since the packet has been discarded
+  if (!bWritten) {
+    srv.srv_iLastProcessedSequence--;
+    return false;
+  }
+
+  if (!bLegacy) {
+    INetwork::AddBlockToAllSessions(nsbExt);
+    return true;
+  }
+
+  // Write the same packet in the old format under the same sequence for other clients
+  CNetStreamBlock nsbLegacy(INetwork::PCK_EXTENSION, nsbExt.nsb_iSequenceNumber);
+  INetCompress::Integer(nsbLegacy, ulType);
+
+  bWritingLegacy = TRUE;
+  pExtPacket->Write(nsbLegacy);
+  bWritingLegacy = FALSE;
+
+  for (INDEX i = 0; i < srv.srv_assoSessions.Count(); i++) {
+    INetwork::AddBlockToSession(IProcessPacket::HasSamePatch(i) ? nsbExt : nsbLegacy, i);
+  }
+
+  return true;
+};
+
+// Forget values and paths that have been sent to clients, so they are sent in full again
+void IExtPacketStream::ResetWriting(void) {
+  memset(_asbWriting, 0, sizeof(_asbWriting));
+
+  for (INDEX i = 0; i < STREAM_PATHS; i++) {
+    _aspWriting[i].strPath = "";
+    _aspWriting[i].ulHash = 0;
+    _aspWriting[i].iLastUse = 0;
+  }
+
+  _iLastPathUse = 0;
+};
+
+// Forget values and paths that have been received from the server
+void IExtPacketStream::ResetReading(void) {
+  memset(_asbReading, 0, sizeof(_asbReading));
+
+  for (INDEX i = 0; i < STREAM_PATHS; i++) {
+    _aspReading[i].strPath = "";
+  }
+};
+
+// Chunk with values and paths that have been received from the server
+static const CChunkID _cidStreamState("XPST");
+
+// Write values and paths that have been received from the server for a joining client or a new demo
+void IExtPacketStream::WriteState(CTStream &strm) {
+  strm.WriteID_t(_cidStreamState);
+
+  // Write used value slots
+  INDEX ctBaselines = 0;
+  INDEX i;
+
+  for (i = 0; i < STREAM_BASELINES; i++) {
+    if (_asbReading[i].ulEntity != 0) ctBaselines++;
+  }
+
+  strm << ctBaselines;
+
+  for (i = 0; i < STREAM_BASELINES; i++) {
+    const SStreamBaseline &sb = _asbReading[i];
+    if (sb.ulEntity == 0) continue;
+
+    strm << i;
+    strm << sb.ulEntity << sb.ulChannel << sb.iPrecision << sb.ctDeltas;
+    strm << sb.aslValue[0] << sb.aslValue[1] << sb.aslValue[2];
+  }
+
+  // Write used path slots
+  INDEX ctPaths = 0;
+
+  for (i = 0; i < STREAM_PATHS; i++) {
+    if (_aspReading[i].strPath != "") ctPaths++;
+  }
+
+  strm << ctPaths;
+
+  for (i = 0; i < STREAM_PATHS; i++) {
+    if (_aspReading[i].strPath == "") continue;
+
+    strm << i;
+    strm << _aspReading[i].strPath;
+  }
+};
+
+// Read values and paths that have been received from the server before joining the game or recording a demo
+void IExtPacketStream::ReadState(CTStream &strm) {
+  // No values have been written by the server
+  if (strm.GetStreamSize() - strm.GetPos_t() < (SLONG)sizeof(CChunkID)) return;
+  if (strm.PeekID_t() != _cidStreamState) return;
+
+  strm.ExpectID_t(_cidStreamState);
+  ResetReading();
+
+  INDEX ctBaselines;
+  strm >> ctBaselines;
+
+  while (--ctBaselines >= 0) {
+    INDEX iSlot;
+    strm >> iSlot;
+
+    if (iSlot < 0 || iSlot >= STREAM_BASELINES) {
+      ThrowF_t(TRANS("Invalid slot %d of an extension packet value"), iSlot);
+    }
+
+    SStreamBaseline &sb = _asbReading[iSlot];
+    strm >> sb.ulEntity >> sb.ulChannel >> sb.iPrecision >> sb.ctDeltas;
+    strm >> sb.aslValue[0] >> sb.aslValue[1] >> sb.aslValue[2];
+  }
+
+  INDEX ctPaths;
+  strm >> ctPaths;
+
+  while (--ctPaths >= 0) {
+    INDEX iSlot;
+    strm >> iSlot;
+
+    if (iSlot < 0 || iSlot >= STREAM_PATHS) {
+      ThrowF_t(TRANS("Invalid slot %d of an extension packet path"), iSlot);
+    }
+
+    strm >> _aspReading[iSlot].strPath;
+  }
+};
+
+// Print out sizes of packets that have been sent
+void IExtPacketStream::ReportStats(void) {
+  CPrintF(TRANS("Extension packets sent through the game stream:\n"));
+
+  for (INDEX i = 0; i <= IClassicsExtPacket::k_EPacketType_LastS2C; i++) {
+    const SStreamStats &ss = _aStreamStats[i];
+    if (ss.ctPackets == 0) continue;
+
+    CExtPacket *pck = CExtPacket::CreatePacket((IClassicsExtPacket::EPacketType)i);
+    if (pck == NULL) continue;
+
+    const DOUBLE dBytes = DOUBLE(ss.slBits) / 8.0;
+    CPrintF(TRANS("  %-16s: %d packets, %.0f bytes (%.2f bytes per packet)\n"), pck->GetName(), ss.ctPackets, dBytes, dBytes / ss.ctPackets);
+
+    delete pck;
+  }
+
+  CPrintF(TRANS("Entity vectors: %d whole values, %d differences\n"), _ctWholeValues, _ctDeltaValues);
+};
+
+// Reset statistics of sent packets
+void IExtPacketStream::ResetStats(void) {
+  memset(_aStreamStats, 0, sizeof(_aStreamStats));
+  _ctWholeValues = 0;
+  _ctDeltaValues = 0;
+};
+
+// Write resource path, possibly as an index of a path that has been sent before
+void CExtPacket::WritePath(CNetworkMessage &nm, const CTString &strPath) {
+  const INDEX ctLength = strPath.Length();
+
+  // Convert the path into how it will be read on the other side
+  CTString strRead = strPath;
+  UBYTE ubCompressed = (ctLength <= 255);
+
+  for (INDEX iChar = 0; ubCompressed && iChar < ctLength; iChar++) {
+    const char ch = strPath.str_String[iChar];
+    const char chCompressed = _achCompressedPathCharacters[INetCompress::PathCharIndex(ch)];
+
+    // Send the path as is if any character cannot be compressed
+    if (chCompressed != toupper(ch)) {
+      strRead = strPath;
+      ubCompressed = FALSE;
+      break;
+    }
+
+    strRead.str_String[iChar] = chCompressed;
+  }
+
+  const BOOL bStream = (&nm == IExtPacketStream::pnmWriting && strRead != "");
+  const ULONG ulHash = strRead.GetHash();
+
+  // Find the same path among the ones that have been sent
+  UBYTE ubKnown = FALSE;
+  INDEX iSlot = 0;
+
+  if (bStream) {
+    for (; iSlot < STREAM_PATHS; iSlot++) {
+      const SStreamPath &sp = _aspWriting[iSlot];
+
+      if (sp.ulHash == ulHash && sp.strPath == strRead) {
+        ubKnown = TRUE;
+        break;
+      }
+    }
+  }
+
+  nm.WriteBits(&ubKnown, 1);
+
+  // Write index of the path
+  if (ubKnown) {
+    nm.WriteBits(&iSlot, 6);
+    _aspWriting[iSlot].iLastUse = ++_iLastPathUse;
+    return;
+  }
+
+  // Write the whole path
+  nm.WriteBits(&ubCompressed, 1);
+
+  if (ubCompressed) {
+    UBYTE ubLength = ctLength;
+    nm.WriteBits(&ubLength, 8);
+
+    for (INDEX iChar = 0; iChar < ctLength; iChar++) {
+      INetCompress::PathChar(nm, strPath.str_String[iChar]);
+    }
+
+  } else {
+    nm << strPath;
+  }
+
+  UBYTE ubRemember = bStream;
+  nm.WriteBits(&ubRemember, 1);
+
+  if (!ubRemember) return;
+
+  // Replace the least recently used path
+  iSlot = 0;
+
+  for (INDEX i = 1; i < STREAM_PATHS; i++) {
+    if (_aspWriting[i].iLastUse < _aspWriting[iSlot].iLastUse) iSlot = i;
+  }
+
+  nm.WriteBits(&iSlot, 6);
+
+  SStreamPath &sp = _aspWriting[iSlot];
+  sp.strPath = strRead;
+  sp.ulHash = ulHash;
+  sp.iLastUse = ++_iLastPathUse;
+};
+
+// Read resource path, possibly by an index of a path that has been received before (returns FALSE if it's unknown)
+BOOL CExtPacket::ReadPath(CNetworkMessage &nm, CTString &strPath) {
+  const BOOL bStream = (&nm == IExtPacketStream::pnmReading);
+
+  UBYTE ubKnown = FALSE;
+  nm.ReadBits(&ubKnown, 1);
+
+  // Read index of the path
+  if (ubKnown) {
+    INDEX iSlot = 0;
+    nm.ReadBits(&iSlot, 6);
+
+    strPath = (bStream ? _aspReading[iSlot].strPath : CTString(""));
+
+    // Path has been missed (e.g. if started receiving the stream after it has been sent)
+    if (strPath == "") {
+      ClassicsPackets_ServerReport(this, TRANS("Missing previously sent path %d, skipping\n"), iSlot);
+      return FALSE;
+    }
+
+    return TRUE;
+  }
+
+  // Read the whole path
+  UBYTE ubCompressed = FALSE;
+  nm.ReadBits(&ubCompressed, 1);
+
+  if (ubCompressed) {
+    UBYTE ubLength = 0;
+    nm.ReadBits(&ubLength, 8);
+
+    // Read each character
+    char strAlloc[256]; // UBYTE maxes out at 255 anyway
+    INDEX iChar;
+
+    for (iChar = 0; iChar < ubLength; iChar++) {
+      strAlloc[iChar] = INetDecompress::PathChar(nm);
+    }
+
+    // Set null-terminator at the end
+    strAlloc[iChar] = '\0';
+    strPath = strAlloc;
+
+  } else {
+    nm >> strPath;
+  }
+
+  UBYTE ubRemember = FALSE;
+  nm.ReadBits(&ubRemember, 1);
+
+  if (ubRemember) {
+    INDEX iSlot = 0;
+    nm.ReadBits(&iSlot, 6);
+
+    if (bStream) _aspReading[iSlot].strPath = strPath;
+  }
+
+  return TRUE;
+};
+
+// Write position or speed, possibly as a difference from the previous one sent for this entity
+void CExtEntityPacket::WriteVector(CNetworkMessage &nm, const FLOAT3D &v, INDEX iChannel) {
+  // Clients of other patch versions only read whole values
+  if (IExtPacketStream::bWritingLegacy) {
+    INetCompress::Float3D(nm, v);
+    return;
+  }
+
+  const ULONG ulChannel = GetType() * 4 + iChannel;
+
+  // Values aren't quantized while they are written in full
+  const INDEX iPrecision = (IExtPacketStream::bWritingWhole ? -1 : Clamp(ser_iExtPacketPrecision, (INDEX)-1, (INDEX)15));
+
+  // Only remember values of specific entities that are being sent to clients
+  SStreamBaseline *psb = NULL;
+
+  if (&nm == IExtPacketStream::pnmWriting && ulEntity != 0 && IsEntityValid()) {
+    psb = &GetBaseline(_asbWriting, ulEntity, ulChannel);
+  }
+
+  SLONG aslValue[3];
+  UBYTE ubDelta = FALSE;
+
+  if (psb != NULL && iPrecision >= 0 && MatchesBaseline(*psb, ulEntity, ulChannel)
+   && psb->iPrecision == iPrecision && psb->ctDeltas < ser_iExtPacketKeyframe
+   && QuantizeVector(v, iPrecision, aslValue))
+  {
+    ubDelta = TRUE;
+
+    for (INDEX i = 0; i < 3; i++) {
+      const DOUBLE dDelta = DOUBLE(aslValue[i]) - DOUBLE(psb->aslValue[i]);
+      if (dDelta <= -_dMaxQuantized || dDelta >= _dMaxQuantized) ubDelta = FALSE;
+    }
+  }
+
+  nm.WriteBits(&ubDelta, 1);
+
+  // Write difference from the previous value
+  if (ubDelta) {
+    for (INDEX i = 0; i < 3; i++) {
+      INetCompress::SignedInteger(nm, aslValue[i] - psb->aslValue[i]);
+      psb->aslValue[i] = aslValue[i];
+    }
+
+    psb->ctDeltas++;
+    _ctDeltaValues++;
+    return;
+  }
+
+  // Write the whole value
+  INetCompress::Float3D(nm, v);
+  if (&nm == IExtPacketStream::pnmWriting) _ctWholeValues++;
+
+  // Quantize the value the same way it will be read on the other side
+  FLOAT3D vRead = v;
+
+  for (INDEX i = 1; i <= 3; i++) {
+    if (vRead(i) > -0.001f && vRead(i) < 0.001f) vRead(i) = 0.0f;
+  }
+
+  UBYTE ubRemember = (psb != NULL && iPrecision >= 0 && QuantizeVector(vRead, iPrecision, aslValue));
+  nm.WriteBits(&ubRemember, 1);
+
+  // Can't use it for differences
+  if (!ubRemember) {
+    if (psb != NULL && MatchesBaseline(*psb, ulEntity, ulChannel)) psb->ulEntity = 0;
+    return;
+  }
+
+  nm.WriteBits(&iPrecision, 4);
+
+  psb->ulEntity = ulEntity;
+  psb->ulChannel = ulChannel;
+  psb->iPrecision = iPrecision;
+  psb->ctDeltas = 0;
+  memcpy(psb->aslValue, aslValue, sizeof(aslValue));
+};
+
+// Read position or speed, possibly as a difference from the previous one received for this entity
+void CExtEntityPacket::ReadVector(CNetworkMessage &nm, FLOAT3D &v, INDEX iChannel) {
+  const ULONG ulChannel = GetType() * 4 + iChannel;
+
+  // Only remember values of specific entities that are being received from the server
+  SStreamBaseline *psb = NULL;
+
+  if (&nm == IExtPacketStream::pnmReading && ulEntity != 0 && IsEntityValid()) {
+    psb = &GetBaseline(_asbReading, ulEntity, ulChannel);
+  }
+
+  UBYTE ubDelta = FALSE;
+  nm.ReadBits(&ubDelta, 1);
+
+  // Read difference from the previous value
+  if (ubDelta) {
+    SLONG aslDelta[3];
+
+    for (INDEX i = 0; i < 3; i++) {
+      INetDecompress::SignedInteger(nm, aslDelta[i]);
+    }
+
+    v = FLOAT3D(0, 0, 0);
+
+    // Previous value has been missed (e.g. if started receiving the stream after it has been sent)
+    if (psb == NULL || !MatchesBaseline(*psb, ulEntity, ulChannel) || psb->iPrecision < 0) {
+      ClassicsPackets_ServerReport(this, TRANS("Missing previous value of %u entity, skipping\n"), ulEntity);
+      ulEntity = 0x7FFFFFFF;
+      return;
+    }
+
+    for (INDEX i = 0; i < 3; i++) {
+      psb->aslValue[i] += aslDelta[i];
+    }
+
+    DequantizeVector(psb->aslValue, psb->iPrecision, v);
+    return;
+  }
+
+  // Read the whole value
+  INetDecompress::Float3D(nm, v);
+
+  UBYTE ubRemember = FALSE;
+  nm.ReadBits(&ubRemember, 1);
+
+  if (!ubRemember) {
+    if (psb != NULL && MatchesBaseline(*psb, ulEntity, ulChannel)) psb->ulEntity = 0;
+    return;
+  }
+
+  INDEX iPrecision = 0;
+  nm.ReadBits(&iPrecision, 4);
+
+  if (psb == NULL) return;
+
+  psb->ulEntity = ulEntity;
+  psb->ulChannel = ulChannel;
+  psb->iPrecision = iPrecision;
+  psb->ctDeltas = 0;
+  QuantizeVector(v, iPrecision, psb->aslValue);
+};
+
+// Write rotation, possibly as a difference from the previous one sent for this entity
+void CExtEntityPacket::WriteAngles(CNetworkMessage &nm, const ANGLE3D &a, INDEX iChannel) {
+  // Clients of other patch versions only read whole values
+  if (IExtPacketStream::bWritingLegacy) {
+    INetCompress::Angle3D(nm, a);
+    return;
+  }
+
+  const ULONG ulChannel = GetType() * 4 + iChannel;
+
+  // Only remember values of specific entities that are being sent to clients
+  SStreamBaseline *psb = NULL;
+
+  if (&nm == IExtPacketStream::pnmWriting && ulEntity != 0 && IsEntityValid()) {
+    psb = &GetBaseline(_asbWriting, ulEntity, ulChannel);
+  }
+
+  SLONG aslValue[3];
+
+  for (INDEX i = 0; i < 3; i++) {
+    aslValue[i] = INetCompress::AngleToUnits(a(i + 1));
+  }
+
+  UBYTE ubDelta = (psb != NULL && MatchesBaseline(*psb, ulEntity, ulChannel) && psb->ctDeltas < ser_iExtPacketKeyframe);
+  nm.WriteBits(&ubDelta, 1);
+
+  // Write difference from the previous value, wrapped into the -180..180 range
+  if (ubDelta) {
+    for (INDEX i = 0; i < 3; i++) {
+      SLONG slDelta = (aslValue[i] - psb->aslValue[i]) & 0x7FFF;
+      if (slDelta >= 0x4000) slDelta -= 0x8000;
+
+      INetCompress::SignedInteger(nm, slDelta);
+      psb->aslValue[i] = aslValue[i];
+    }
+
+    psb->ctDeltas++;
+    _ctDeltaValues++;
+    return;
+  }
+
+  // Write the whole value
+  for (INDEX i = 0; i < 3; i++) {
+    INetCompress::AngleUnits(nm, (UWORD)aslValue[i]);
+  }
+
+  if (&nm == IExtPacketStream::pnmWriting) _ctWholeValues++;
+
+  if (psb == NULL) return;
+
+  psb->ulEntity = ulEntity;
+  psb->ulChannel = ulChannel;
+  psb->iPrecision = -1;
+  psb->ctDeltas = 0;
+  memcpy(psb->aslValue, aslValue, sizeof(aslValue));
+};
+
+// Read rotation, possibly as a difference from the previous one received for this entity
+void CExtEntityPacket::ReadAngles(CNetworkMessage &nm, ANGLE3D &a, INDEX iChannel) {
+  const ULONG ulChannel = GetType() * 4 + iChannel;
+
+  // Only remember values of specific entities that are being received from the server
+  SStreamBaseline *psb = NULL;
+
+  if (&nm == IExtPacketStream::pnmReading && ulEntity != 0 && IsEntityValid()) {
+    psb = &GetBaseline(_asbReading, ulEntity, ulChannel);
+  }
+
+  UBYTE ubDelta = FALSE;
+  nm.ReadBits(&ubDelta, 1);
+
+  // Read difference from the previous value
+  if (ubDelta) {
+    SLONG aslDelta[3];
+
+    for (INDEX i = 0; i < 3; i++) {
+      INetDecompress::SignedInteger(nm, aslDelta[i]);
+    }
+
+    a = ANGLE3D(0, 0, 0);
+
+    // Previous value has been missed (e.g. if started receiving the stream after it has been sent)
+    if (psb == NULL || !MatchesBaseline(*psb, ulEntity, ulChannel) || psb->iPrecision >= 0) {
+      ClassicsPackets_ServerReport(this, TRANS("Missing previous value of %u entity, skipping\n"), ulEntity);
+      ulEntity = 0x7FFFFFFF;
+      return;
+    }
+
+    for (INDEX i = 0; i < 3; i++) {
+      psb->aslValue[i] = (psb->aslValue[i] + aslDelta[i]) & 0x7FFF;
+      a(i + 1) = INetDecompress::UnitsToAngle((UWORD)psb->aslValue[i]);
+    }
+    return;
+  }
+
+  // Read the whole value
+  UWORD auwValue[3];
+
+  for (INDEX i = 0; i < 3; i++) {
+    INetDecompress::AngleUnits(nm, auwValue[i]);
+    a(i + 1) = INetDecompress::UnitsToAngle(auwValue[i]);
+  }
+
+  if (psb == NULL) return;
+
+  psb->ulEntity = ulEntity;
+  psb->ulChannel = ulChannel;
+  psb->iPrecision = -1;
+  psb->ctDeltas = 0;
+
+  for (INDEX i = 0; i < 3; i++) {
+    psb->aslValue[i] = auwValue[i];
+  }
+};
+
+#endif // _PATCHCONFIG_EXT_PACKETS
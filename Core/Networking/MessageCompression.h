@@ -68,18 +68,39 @@ inline void Integer(CNetworkMessage &nm, ULONG ul) {
   }
 };
 
-// Compress path character
-inline char PathChar(CNetworkMessage &nm, char ch) {
-  ch = toupper(ch);
-  UBYTE ubChar = 0; // First character can act as invalid one
+// Compress signed 32-bit integer (values closer to 0 take less space)
+inline void SignedInteger(CNetworkMessage &nm, SLONG sl) {
+  // Interleave negative and positive values (0, -1, 1, -2, 2 etc.)
+  Integer(nm, (ULONG(sl) << 1) ^ ULONG(sl >> 31));
+};
+
+// Get index of a character in the compressed path character table (first character can act as invalid one)
+inline UBYTE PathCharIndex(char ch) {
+  static UBYTE _aubIndices[256];
+  static bool _bTableReady = false;
+
+  // Fill the reverse lookup table for each possible character
+  if (!_bTableReady) {
+    memset(_aubIndices, 0, sizeof(_aubIndices));
 
-  for (UBYTE i = 0; i < 61; i++) {
-    if (ch == _achCompressedPathCharacters[i]) {
-      ubChar = i;
-      break;
+    // Go backwards, so the first matching character is in the table
+    for (INDEX i = 60; i >= 0; i--) {
+      const UBYTE ubChar = (UBYTE)_achCompressedPathCharacters[i];
+
+      _aubIndices[ubChar] = i;
+      _aubIndices[(UBYTE)tolower(ubChar)] = i;
     }
+
+    _bTableReady = true;
   }
 
+  return _aubIndices[(UBYTE)ch];
+};
+
+// Compress path character
+inline char PathChar(CNetworkMessage &nm, char ch) {
+  UBYTE ubChar = PathCharIndex(ch);
+
   nm.WriteBits(&ubChar, 6);
   return _achCompressedPathCharacters[ubChar];
 };
@@ -110,24 +131,32 @@ inline void Double(CNetworkMessage &nm, DOUBLE f) {
   }
 };
 
-// Compress angle in the 0-360 range
-inline void Angle(CNetworkMessage &nm, ANGLE f) {
+// Convert angle in the 0-360 range into a 15-bit integer (360 is turned into 0)
+inline UWORD AngleToUnits(ANGLE f) {
   f = WrapAngle(f);
 
-  if (f < 0.001f) {
+  UWORD uwAngle = Clamp((DOUBLE)f * (32768.0 / 360.0), 0.0, 32768.0);
+  return uwAngle & 0x7FFF;
+};
+
+// Compress angle that has been converted into a 15-bit integer
+inline void AngleUnits(CNetworkMessage &nm, UWORD uwAngle) {
+  if (uwAngle == 0) {
     UBYTE ub = 0;
     nm.WriteBits(&ub, 1);
 
   } else {
     UBYTE ub = 1;
     nm.WriteBits(&ub, 1);
-
-    // Compress angle into a 15-bit integer (32768 is written as 0)
-    UWORD uwAngle = Clamp((DOUBLE)f * (32768.0 / 360.0), 0.0, 32768.0);
     nm.WriteBits(&uwAngle, 15);
   }
 };
 
+// Compress angle in the 0-360 range
+inline void Angle(CNetworkMessage &nm, ANGLE f) {
+  AngleUnits(nm, AngleToUnits(f));
+};
+
 // Compress position
 inline void Float3D(CNetworkMessage &nm, const FLOAT3D &v) {
   Float(nm, v(1));
@@ -179,6 +208,14 @@ inline void Integer(CNetworkMessage &nm, ULONG &ul) {
   }
 };
 
+// Decompress signed 32-bit integer
+inline void SignedInteger(CNetworkMessage &nm, SLONG &sl) {
+  ULONG ul;
+  Integer(nm, ul);
+
+  sl = SLONG(ul >> 1) ^ -SLONG(ul & 1);
+};
+
 // Decompress path character
 inline char PathChar(CNetworkMessage &nm) {
   UBYTE ubChar = 0;
@@ -211,22 +248,31 @@ inline void Double(CNetworkMessage &nm, DOUBLE &f) {
   }
 };
 
-// Decompress angle in the 0-360 range
-inline void Angle(CNetworkMessage &nm, ANGLE &f) {
+// Convert 15-bit integer into an angle in the 0-360 range
+inline ANGLE UnitsToAngle(UWORD uwAngle) {
+  return (DOUBLE)uwAngle * (360.0 / 32768.0);
+};
+
+// Decompress angle as a 15-bit integer
+inline void AngleUnits(CNetworkMessage &nm, UWORD &uwAngle) {
   UBYTE ub = 0;
   nm.ReadBits(&ub, 1);
 
-  f = 0.0f;
+  uwAngle = 0;
 
   if (ub == 1) {
-    UWORD uwAngle = 0;
     nm.ReadBits(&uwAngle, 15);
-
-    // Decompress angle from a 15-bit integer
-    f = (DOUBLE)uwAngle * (360.0 / 32768.0);
   }
 };
 
+// Decompress angle in the 0-360 range
+inline void Angle(CNetworkMessage &nm, ANGLE &f) {
+  UWORD uwAngle;
+  AngleUnits(nm, uwAngle);
+
+  f = UnitsToAngle(uwAngle);
+};
+
 // Decompress position
 inline void Float3D(CNetworkMessage &nm, FLOAT3D &v) {
   Float(nm, v(1));
@@ -18,6 +18,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "MessageProcessing.h"
 #include "NetworkFunctions.h"
 #include "Modules.h"
+#include "ExtPackets.h"
 
 #include "Query/QueryManager.h"
 
@@ -30,6 +31,18 @@ INDEX IProcessPacket::_bReportSyncBadToClients = FALSE;
 // Prevent clients from joining unless they have the same patch installed
 INDEX IProcessPacket::_bForbidVanilla = FALSE;
 
+// Patch versions reported by clients upon connecting
+ULONG IProcessPacket::_aulClientVersions[ICore::MAX_GAME_COMPUTERS] = { 0 };
+
+// Check if a client is running the same patch version as the server
+BOOL IProcessPacket::HasSamePatch(INDEX iClient) {
+  // Server client always is
+  if (iClient == 0) return TRUE;
+  if (iClient < 0 || iClient >= ICore::MAX_GAME_COMPUTERS) return FALSE;
+
+  return _aulClientVersions[iClient] == ClassicsCore_GetVersion();
+};
+
 #if _PATCHCONFIG_GAMEPLAY_EXT
 
 // Gameplay extensions (reset to recommended settings)
@@ -217,6 +230,9 @@ static BOOL CheckClientPatch(INDEX iClient, CNetworkMessage &nmMessage) {
   const ULONG ctTagLen = sizeof(_aSessionStatePatchTag);
   ULONG ulClientVer;
 
+  // No version until it's verified
+  IProcessPacket::_aulClientVersions[iClient] = 0;
+
   // Desired position in the packet vs the last possible position
   const UBYTE *pubDesired = nmMessage.nm_pubPointer + ctTagLen + sizeof(ulClientVer);
   const UBYTE *pubEnd = nmMessage.nm_pubMessage + nmMessage.nm_slSize;
@@ -236,6 +252,11 @@ static BOOL CheckClientPatch(INDEX iClient, CNetworkMessage &nmMessage) {
     CPrintF(TRANS("Server: Client '%s' has provided an identification tag:\n"
                   "  Tag match: %d | Version match: %d\n"), strClient.str_String, bTagMatch, bVersionMatch);
 
+    // Remember which version the client is running
+    if (bTagMatch) {
+      IProcessPacket::_aulClientVersions[iClient] = ulClientVer;
+    }
+
     // Client is running the right patch
     return (bTagMatch && bVersionMatch);
 
@@ -250,8 +271,19 @@ static BOOL CheckClientPatch(INDEX iClient, CNetworkMessage &nmMessage) {
 // Client requesting the session state
 void IProcessPacket::OnConnectRemoteSessionStateRequest(INDEX iClient, CNetworkMessage &nmMessage)
 {
-  // [Cecil] Get identity of a remote client
   ASSERT(iClient > 0);
+
+  // [Cecil] Check client's address before doing anything else with it
+  if (!GetComm().Server_IsClientLocal(iClient)) {
+    const ULONG ulIP = StringToAddress(GetComm().Server_GetClientName(iClient));
+
+    if (!IAddressFilter::IsAllowed(ulIP)) {
+      INetwork::SendDisconnectMessage(iClient, TRANS("You are not allowed on this server!"), TRUE);
+      return;
+    }
+  }
+
+  // [Cecil] Get identity of a remote client
   CClientIdentity *pci = IClientLogging::GetIdentity(iClient);
 
   // [Cecil] Check if the client is banned
@@ -333,8 +365,11 @@ void IProcessPacket::OnConnectRemoteSessionStateRequest(INDEX iClient, CNetworkM
   // [Cecil] Check if vanilla clients are forbidden or using incompatible gameplay extensions
   const BOOL bForbid = (_bForbidVanilla || GameplayExtEnabled());
 
+  // [Cecil] Check which patch version the client is running
+  const BOOL bSamePatch = CheckClientPatch(iClient, nmMessage);
+
   // [Cecil] Disconnect unless the client has the right patch version installed
-  if (bForbid && !CheckClientPatch(iClient, nmMessage)) {
+  if (bForbid && !bSamePatch) {
     // Prompt to download the right patch version
     const CTString strVer = ClassicsCore_GetVersionName();
     const CTString strMod = "MOD:Classics Patch " + strVer + "\\" + CLASSICSPATCH_URL_TAGRELEASE(strVer);
@@ -440,6 +475,11 @@ void IProcessPacket::OnConnectRemoteSessionStateRequest(INDEX iClient, CNetworkM
     return;
   }
 
+#if _PATCHCONFIG_EXT_PACKETS
+  // [Cecil] Send whole values of extension packets again, since the new client hasn't received previous ones
+  IExtPacketStream::ResetWriting();
+#endif
+
   // Activate client socket and read parameters for it
   CSessionSocket &sso = _pNetwork->ga_srvServer.srv_assoSessions[iClient];
   sso.Activate();
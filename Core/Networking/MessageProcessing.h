@@ -37,6 +37,7 @@ class CORE_API IProcessPacket {
     enum {
       CLT_NONE = -1, // No client
       CLT_SAVE = -2, // In the process of saving the game
+      CLT_SYNC = -3, // Calculating shared world checksum for all clients
     };
 
     // Which client sent last packet to the server
@@ -48,6 +49,12 @@ class CORE_API IProcessPacket {
     // Prevent clients from joining unless they have the same patch installed
     static INDEX _bForbidVanilla;
 
+    // Patch versions reported by clients upon connecting (0 if they haven't reported any)
+    static ULONG _aulClientVersions[ICore::MAX_GAME_COMPUTERS];
+
+    // Check if a client is running the same patch version as the server
+    static BOOL HasSamePatch(INDEX iClient);
+
   #if _PATCHCONFIG_GAMEPLAY_EXT
 
     // Gameplay extensions
@@ -20,6 +20,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
   #pragma once
 #endif
 
+#include "Modules/AddressFilter.h"
 #include "Modules/AntiFlood.h"
 #include "Modules/SplitScreenClients.h"
 #include "Modules/ClientLogging.h"
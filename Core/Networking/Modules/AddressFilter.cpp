@@ -0,0 +1,344 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "AddressFilter.h"
+
+// Only let in clients from address ranges that are explicitly allowed
+INDEX ser_bRequireAllowedAddress = FALSE;
+
+// File with address ranges
+static const CTString _strAddressFilterFile = "Data\\ClassicsPatch\\AddressFilter.txt";
+
+// One node of a binary prefix trie, where each level is one bit of an address from the highest one
+struct SAddressNode {
+  INDEX aiChildren[2]; // Nodes for the next bit being 0 or 1 (-1 if none)
+  INDEX iRule; // Rule for the range that ends on this node
+};
+
+// All nodes of the trie, starting with the root
+static CStaticStackArray<SAddressNode> _aAddressNodes;
+
+// Amount of ranges with rules
+static INDEX _ctAddressRules = 0;
+
+// Add a new empty node
+static INDEX NewAddressNode(void) {
+  SAddressNode &node = _aAddressNodes.Push();
+  node.aiChildren[0] = -1;
+  node.aiChildren[1] = -1;
+  node.iRule = IAddressFilter::E_NONE;
+
+  return _aAddressNodes.Count() - 1;
+};
+
+// Get bit of an address at some trie level
+static inline INDEX AddressBit(ULONG ulIP, INDEX iLevel) {
+  return (ulIP >> (31 - iLevel)) & 1;
+};
+
+// Set rule for an address range (E_NONE removes it)
+void IAddressFilter::SetRule(ULONG ulIP, INDEX ctPrefixBits, ERule eRule) {
+  ctPrefixBits = Clamp(ctPrefixBits, (INDEX)0, (INDEX)32);
+
+  if (_aAddressNodes.Count() == 0) {
+    // Nothing to remove
+    if (eRule == E_NONE) return;
+
+    NewAddressNode();
+  }
+
+  INDEX iNode = 0;
+
+  for (INDEX iLevel = 0; iLevel < ctPrefixBits; iLevel++) {
+    const INDEX iBit = AddressBit(ulIP, iLevel);
+    INDEX iChild = _aAddressNodes[iNode].aiChildren[iBit];
+
+    if (iChild == -1) {
+      // Nothing to remove
+      if (eRule == E_NONE) return;
+
+      // Array may be reallocated, so the node is accessed again afterwards
+      iChild = NewAddressNode();
+      _aAddressNodes[iNode].aiChildren[iBit] = iChild;
+    }
+
+    iNode = iChild;
+  }
+
+  SAddressNode &node = _aAddressNodes[iNode];
+
+  if (node.iRule == E_NONE && eRule != E_NONE) {
+    _ctAddressRules++;
+  } else if (node.iRule != E_NONE && eRule == E_NONE) {
+    _ctAddressRules--;
+  }
+
+  node.iRule = eRule;
+};
+
+// Get rule of the most specific range that contains an address
+IAddressFilter::ERule IAddressFilter::GetRule(ULONG ulIP) {
+  if (_ctAddressRules == 0) return E_NONE;
+
+  INDEX iRule = E_NONE;
+  INDEX iNode = 0;
+
+  for (INDEX iLevel = 0; iNode != -1; iLevel++) {
+    const SAddressNode &node = _aAddressNodes[iNode];
+
+    if (node.iRule != E_NONE) {
+      iRule = node.iRule;
+    }
+
+    if (iLevel == 32) break;
+
+    iNode = node.aiChildren[AddressBit(ulIP, iLevel)];
+  }
+
+  return (ERule)iRule;
+};
+
+// Check if connections from an address are allowed
+BOOL IAddressFilter::IsAllowed(ULONG ulIP) {
+  const ERule eRule = GetRule(ulIP);
+
+  if (eRule == E_NONE) {
+    return !ser_bRequireAllowedAddress;
+  }
+
+  return (eRule == E_ALLOW);
+};
+
+// Parse address range from a string ("1.2.3.4" or "1.2.3.0/24")
+BOOL IAddressFilter::ParseRange(const char *strRange, ULONG &ulIP, INDEX &ctPrefixBits) {
+  UINT a, b, c, d, bits = 32;
+  int iParsed = -1;
+
+  // Address
+  if (sscanf(strRange, "%u.%u.%u.%u%n", &a, &b, &c, &d, &iParsed) != 4 || iParsed < 0) return FALSE;
+  const char *strRest = strRange + iParsed;
+
+  // Optional prefix length
+  if (*strRest == '/') {
+    iParsed = -1;
+
+    if (sscanf(strRest + 1, "%u%n", &bits, &iParsed) != 1 || iParsed < 0) return FALSE;
+    strRest += 1 + iParsed;
+  }
+
+  // Only whitespace may follow
+  for (; *strRest != '\0'; strRest++) {
+    if (!isspace((UBYTE)*strRest)) return FALSE;
+  }
+
+  if (a > 255 || b > 255 || c > 255 || d > 255 || bits > 32) return FALSE;
+
+  ulIP = (a << 24) | (b << 16) | (c << 8) | d;
+  ctPrefixBits = bits;
+
+  // Clear bits past the prefix
+  if (ctPrefixBits < 32) {
+    ulIP &= ~(0xFFFFFFFF >> ctPrefixBits);
+  }
+
+  return TRUE;
+};
+
+// Remove all rules
+void IAddressFilter::Clear(void) {
+  _aAddressNodes.PopAll();
+  _ctAddressRules = 0;
+};
+
+// Load rules from the filter file
+void IAddressFilter::Load(void) {
+  Clear();
+
+  if (!FileExists(_strAddressFilterFile)) return;
+
+  INDEX ctInvalid = 0;
+
+  try {
+    CTFileStream strm;
+    strm.Open_t(_strAddressFilterFile);
+
+    while (!strm.AtEOF()) {
+      CTString strLine;
+      strm.GetLine_t(strLine);
+      strLine.TrimSpacesLeft();
+      strLine.TrimSpacesRight();
+
+      // Skip empty lines and comments
+      if (strLine == "" || strLine.str_String[0] == '#' || strLine.str_String[0] == ';') continue;
+
+      // Ranges without a rule are banned
+      ERule eRule = E_BAN;
+
+      if (strLine.RemovePrefix("allow ")) {
+        eRule = E_ALLOW;
+      } else {
+        strLine.RemovePrefix("ban ");
+      }
+
+      strLine.TrimSpacesLeft();
+
+      ULONG ulIP;
+      INDEX ctBits;
+
+      if (!ParseRange(strLine.str_String, ulIP, ctBits)) {
+        ctInvalid++;
+        continue;
+      }
+
+      SetRule(ulIP, ctBits, eRule);
+    }
+
+    strm.Close();
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot load address filter: %s\n"), strError);
+  }
+
+  CPrintF(TRANS("Loaded %d address ranges (%d trie nodes)\n"), _ctAddressRules, _aAddressNodes.Count());
+
+  if (ctInvalid != 0) {
+    CPrintF(TRANS("Skipped %d invalid address ranges\n"), ctInvalid);
+  }
+};
+
+// Go through ranges with rules under some node
+static void ListRanges(CTString &strList, INDEX iNode, ULONG ulIP, INDEX iLevel, BOOL bForFile) {
+  const SAddressNode &node = _aAddressNodes[iNode];
+
+  if (node.iRule != IAddressFilter::E_NONE) {
+    const char *strRule = (node.iRule == IAddressFilter::E_ALLOW) ? "allow" : "ban";
+
+    strList += CTString(0, bForFile ? "%s %u.%u.%u.%u/%d\n" : "  %-5s %u.%u.%u.%u/%d\n", strRule,
+      (ulIP >> 24) & 0xFF, (ulIP >> 16) & 0xFF, (ulIP >> 8) & 0xFF, ulIP & 0xFF, iLevel);
+  }
+
+  if (iLevel == 32) return;
+
+  for (INDEX iBit = 0; iBit < 2; iBit++) {
+    const INDEX iChild = _aAddressNodes[iNode].aiChildren[iBit];
+
+    if (iChild != -1) {
+      ListRanges(strList, iChild, ulIP | (ULONG(iBit) << (31 - iLevel)), iLevel + 1, bForFile);
+    }
+  }
+};
+
+// Save rules into the filter file
+void IAddressFilter::Save(void) {
+  CTString strList = "# Address ranges: \"ban 1.2.3.0/24\" or \"allow 1.2.3.4\"\n";
+
+  if (_aAddressNodes.Count() != 0) {
+    ListRanges(strList, 0, 0, 0, TRUE);
+  }
+
+  try {
+    IDir::CreateDir(_strAddressFilterFile);
+
+    CTFileStream strm;
+    strm.Create_t(_strAddressFilterFile);
+    strm.Write_t(strList.str_String, strList.Length());
+    strm.Close();
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot save address filter: %s\n"), strError);
+  }
+};
+
+// Set rule for a range from the console
+static void SetRangeRule(const CTString &strRange, IAddressFilter::ERule eRule) {
+  ULONG ulIP;
+  INDEX ctBits;
+
+  if (!IAddressFilter::ParseRange(strRange.str_String, ulIP, ctBits)) {
+    CPrintF(TRANS("Invalid address range: %s\n"), strRange.str_String);
+    return;
+  }
+
+  IAddressFilter::SetRule(ulIP, ctBits, eRule);
+};
+
+static void BanRange(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strRange = *NEXT_ARG(CTString *);
+
+  SetRangeRule(strRange, IAddressFilter::E_BAN);
+};
+
+static void AllowRange(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strRange = *NEXT_ARG(CTString *);
+
+  SetRangeRule(strRange, IAddressFilter::E_ALLOW);
+};
+
+static void RemoveRange(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strRange = *NEXT_ARG(CTString *);
+
+  SetRangeRule(strRange, IAddressFilter::E_NONE);
+};
+
+static void CheckAddress(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const CTString &strAddress = *NEXT_ARG(CTString *);
+
+  ULONG ulIP;
+  INDEX ctBits;
+
+  if (!IAddressFilter::ParseRange(strAddress.str_String, ulIP, ctBits)) {
+    CPrintF(TRANS("Invalid address: %s\n"), strAddress.str_String);
+    return;
+  }
+
+  CPrintF(IAddressFilter::IsAllowed(ulIP) ? TRANS("%s is allowed\n") : TRANS("%s is not allowed\n"), strAddress.str_String);
+};
+
+static void ListAddressRanges(void) {
+  CTString strList;
+
+  if (_aAddressNodes.Count() != 0) {
+    ListRanges(strList, 0, 0, 0, FALSE);
+  }
+
+  CPrintF(TRANS("%d address ranges:\n"), _ctAddressRules);
+  CPutString(strList);
+};
+
+static void LoadAddressFilter(void) {
+  IAddressFilter::Load();
+};
+
+static void SaveAddressFilter(void) {
+  IAddressFilter::Save();
+};
+
+// Declare shell symbols
+void IAddressFilter::DeclareSymbols(void) {
+  _pShell->DeclareSymbol("persistent user INDEX ser_bRequireAllowedAddress;", &ser_bRequireAllowedAddress);
+  _pShell->DeclareSymbol("user void AddressBan(CTString);", &BanRange);
+  _pShell->DeclareSymbol("user void AddressAllow(CTString);", &AllowRange);
+  _pShell->DeclareSymbol("user void AddressRemove(CTString);", &RemoveRange);
+  _pShell->DeclareSymbol("user void AddressCheck(CTString);", &CheckAddress);
+  _pShell->DeclareSymbol("user void AddressList(void);", &ListAddressRanges);
+  _pShell->DeclareSymbol("user void AddressFilterLoad(void);", &LoadAddressFilter);
+  _pShell->DeclareSymbol("user void AddressFilterSave(void);", &SaveAddressFilter);
+};
@@ -0,0 +1,62 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_ADDRESSFILTER_H
+#define CECIL_INCL_ADDRESSFILTER_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Only let in clients from address ranges that are explicitly allowed
+CORE_API extern INDEX ser_bRequireAllowedAddress;
+
+// Interface for filtering connections by address ranges
+class CORE_API IAddressFilter {
+  public:
+    // Rules for address ranges
+    enum ERule {
+      E_NONE  = 0, // No rule
+      E_BAN   = 1, // Disallow connections
+      E_ALLOW = 2, // Allow connections (overrides bans of wider ranges)
+    };
+
+  public:
+    // Set rule for an address range (E_NONE removes it)
+    static void SetRule(ULONG ulIP, INDEX ctPrefixBits, ERule eRule);
+
+    // Get rule of the most specific range that contains an address
+    static ERule GetRule(ULONG ulIP);
+
+    // Check if connections from an address are allowed
+    static BOOL IsAllowed(ULONG ulIP);
+
+    // Parse address range from a string ("1.2.3.4" or "1.2.3.0/24")
+    static BOOL ParseRange(const char *strRange, ULONG &ulIP, INDEX &ctPrefixBits);
+
+    // Remove all rules
+    static void Clear(void);
+
+    // Load rules from the filter file
+    static void Load(void);
+
+    // Save rules into the filter file
+    static void Save(void);
+
+    // Declare shell symbols
+    static void DeclareSymbols(void);
+};
+
+#endif
@@ -61,6 +61,10 @@ BOOL CClientIdentity::AddNewCharacter(const CPlayerCharacter &pc) {
   if (iChar == -1) {
     aCharacters.Push() = pc;
 
+    // [Cecil] Make it searchable and remember it
+    IClientLogging::IndexCharacter(this, pc);
+    IClientLogging::JournalIdentity(this);
+
     // Added a new character
     return TRUE;
   }
@@ -18,6 +18,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "ClientLogging.h"
 #include "Networking/CommInterface.h"
 
+#include <io.h>
+
 // Get client's address by the client ID on the server
 void IClientLogging::GetAddress(SClientAddress &addr, INDEX iClient) {
   const BOOL bServer = GetComm().Server_IsClientLocal(iClient);
@@ -58,14 +60,234 @@ CClientIdentity *IClientLogging::GetIdentity(INDEX iClient) {
   CClientIdentity *pci = &_aClientIdentities.Push();
   pci->aAddresses.Push() = addr;
 
+  // [Cecil] Remember it right away
+  JournalIdentity(pci);
+
   // Activate a new client
   _aActiveClients[iClient].Set(pci, addr);
 
   return pci;
 };
 
+// [Cecil] Use hash indices for finding client identities instead of going through all of them
+INDEX ser_bClientLogIndex = TRUE;
+
+// [Cecil] Open addressing hash table of client identity indices
+class CIdentityIndex {
+  public:
+    struct Slot {
+      ULONG ulHash;
+      INDEX iIdentity; // -1 if the slot is empty
+    };
+
+    CStaticArray<Slot> aSlots;
+    INDEX ctUsed;
+
+  public:
+    CIdentityIndex() : ctUsed(0) {};
+
+    void Clear(void) {
+      aSlots.Clear();
+      ctUsed = 0;
+    };
+
+    // Find identity by a key hash that's verified by a matching function
+    template<class Match> INDEX Find(ULONG ulHash, const Match &match) const {
+      if (ctUsed == 0) return -1;
+
+      const ULONG ulMask = aSlots.Count() - 1;
+
+      for (ULONG ulSlot = ulHash & ulMask;; ulSlot = (ulSlot + 1) & ulMask) {
+        const Slot &slot = aSlots[ulSlot];
+
+        if (slot.iIdentity == -1) return -1;
+        if (slot.ulHash == ulHash && match(slot.iIdentity)) return slot.iIdentity;
+      }
+    };
+
+    // Add identity under a key hash (keeps the first identity with the same key, like a linear search)
+    template<class Match> void Add(ULONG ulHash, INDEX iIdentity, const Match &match) {
+      // Keep the table at most half full
+      if ((ctUsed + 1) * 2 > aSlots.Count()) {
+        Grow();
+      }
+
+      const ULONG ulMask = aSlots.Count() - 1;
+
+      for (ULONG ulSlot = ulHash & ulMask;; ulSlot = (ulSlot + 1) & ulMask) {
+        Slot &slot = aSlots[ulSlot];
+
+        if (slot.iIdentity == -1) {
+          slot.ulHash = ulHash;
+          slot.iIdentity = iIdentity;
+          ctUsed++;
+          return;
+        }
+
+        // Same key is already there
+        if (slot.ulHash == ulHash && match(slot.iIdentity)) {
+          slot.iIdentity = Min(slot.iIdentity, iIdentity);
+          return;
+        }
+      }
+    };
+
+  private:
+    // Double the amount of slots
+    void Grow(void) {
+      CStaticArray<Slot> aOld;
+      aOld.MoveArray(aSlots);
+
+      const INDEX ctSlots = Max(aOld.Count() * 2, (INDEX)1024);
+      aSlots.New(ctSlots);
+
+      for (INDEX iSlot = 0; iSlot < ctSlots; iSlot++) {
+        aSlots[iSlot].iIdentity = -1;
+      }
+
+      // Reinsert by stored hashes
+      const ULONG ulMask = ctSlots - 1;
+
+      for (INDEX iOld = 0; iOld < aOld.Count(); iOld++) {
+        const Slot &slotOld = aOld[iOld];
+        if (slotOld.iIdentity == -1) continue;
+
+        ULONG ulSlot = slotOld.ulHash & ulMask;
+
+        while (aSlots[ulSlot].iIdentity != -1) {
+          ulSlot = (ulSlot + 1) & ulMask;
+        }
+
+        aSlots[ulSlot] = slotOld;
+      }
+    };
+};
+
+// [Cecil] Identity matching functions for verifying hashed keys
+struct SMatchAddress {
+  const SClientAddress &addr;
+  SMatchAddress(const SClientAddress &addrSet) : addr(addrSet) {};
+
+  inline BOOL operator()(INDEX i) const {
+    return _aClientIdentities[i].FindAddress(addr) != -1;
+  };
+};
+
+struct SMatchCharacter {
+  const CPlayerCharacter &pc;
+  SMatchCharacter(const CPlayerCharacter &pcSet) : pc(pcSet) {};
+
+  inline BOOL operator()(INDEX i) const {
+    return _aClientIdentities[i].FindCharacter(pc) != -1;
+  };
+};
+
+struct SMatchIdentity {
+  const CClientIdentity *pci;
+  SMatchIdentity(const CClientIdentity *pciSet) : pci(pciSet) {};
+
+  inline BOOL operator()(INDEX i) const {
+    return &_aClientIdentities[i] == pci;
+  };
+};
+
+// [Cecil] Key hashes
+static inline ULONG HashBytes(const UBYTE *pub, INDEX ct) {
+  ULONG ulHash = 2166136261UL;
+
+  for (INDEX i = 0; i < ct; i++) {
+    ulHash ^= pub[i];
+    ulHash *= 16777619UL;
+  }
+
+  return ulHash;
+};
+
+static inline ULONG HashAddress(const SClientAddress &addr) {
+  const ULONG ulIP = addr.GetIP();
+  return HashBytes((const UBYTE *)&ulIP, sizeof(ulIP));
+};
+
+static inline ULONG HashCharacter(const CPlayerCharacter &pc) {
+  return HashBytes(pc.pc_aubGUID, sizeof(pc.pc_aubGUID));
+};
+
+static inline ULONG HashIdentity(const CClientIdentity *pci) {
+  return HashBytes((const UBYTE *)&pci, sizeof(pci));
+};
+
+// [Cecil] Hash indices of identities by their addresses, characters and themselves
+static CIdentityIndex _iiAddresses;
+static CIdentityIndex _iiCharacters;
+static CIdentityIndex _iiIdentities;
+
+// [Cecil] Amount of identities that have been added to the indices
+static INDEX _ctIndexedIdentities = 0;
+
+// [Cecil] Add all data of some identity to the indices
+static void IndexIdentity(INDEX iIdentity) {
+  const CClientIdentity &ci = _aClientIdentities[iIdentity];
+  INDEX i;
+
+  _iiIdentities.Add(HashIdentity(&ci), iIdentity, SMatchIdentity(&ci));
+
+  for (i = 0; i < ci.aAddresses.Count(); i++) {
+    const SClientAddress &addr = ci.aAddresses[i];
+    _iiAddresses.Add(HashAddress(addr), iIdentity, SMatchAddress(addr));
+  }
+
+  for (i = 0; i < ci.aCharacters.Count(); i++) {
+    const CPlayerCharacter &pc = ci.aCharacters[i];
+    _iiCharacters.Add(HashCharacter(pc), iIdentity, SMatchCharacter(pc));
+  }
+};
+
+// [Cecil] Add identities that have been pushed since the last time
+static void SyncIndex(void) {
+  const INDEX ct = _aClientIdentities.Count();
+
+  // Some identities have been removed without invalidation
+  if (_ctIndexedIdentities > ct) {
+    IClientLogging::InvalidateIndex();
+  }
+
+  for (INDEX i = _ctIndexedIdentities; i < ct; i++) {
+    IndexIdentity(i);
+  }
+
+  _ctIndexedIdentities = ct;
+};
+
+// [Cecil] Add a new character of an existing identity to the hash index
+void IClientLogging::IndexCharacter(CClientIdentity *pci, const CPlayerCharacter &pc) {
+  // New identities are indexed entirely
+  SyncIndex();
+
+  const INDEX iIdentity = _iiIdentities.Find(HashIdentity(pci), SMatchIdentity(pci));
+
+  if (iIdentity != -1) {
+    _iiCharacters.Add(HashCharacter(pc), iIdentity, SMatchCharacter(pc));
+  }
+};
+
+// [Cecil] Rebuild hash indices on the next lookup after identities or their data have been removed
+void IClientLogging::InvalidateIndex(void) {
+  _iiAddresses.Clear();
+  _iiCharacters.Clear();
+  _iiIdentities.Clear();
+  _ctIndexedIdentities = 0;
+};
+
 // Find client index in the list from an address and return address index
 INDEX IClientLogging::FindByAddress(INDEX &iClient, const SClientAddress &addr) {
+  // [Cecil] Use hash index
+  if (ser_bClientLogIndex) {
+    SyncIndex();
+    iClient = _iiAddresses.Find(HashAddress(addr), SMatchAddress(addr));
+
+    return (iClient != -1) ? _aClientIdentities[iClient].FindAddress(addr) : -1;
+  }
+
   const INDEX ctClients = _aClientIdentities.Count();
 
   // Go through clients
@@ -86,6 +308,14 @@ INDEX IClientLogging::FindByAddress(INDEX &iClient, const SClientAddress &addr)
 
 // Find client index in the list from a character and return character index
 INDEX IClientLogging::FindByCharacter(INDEX &iClient, const CPlayerCharacter &pc) {
+  // [Cecil] Use hash index
+  if (ser_bClientLogIndex) {
+    SyncIndex();
+    iClient = _iiCharacters.Find(HashCharacter(pc), SMatchCharacter(pc));
+
+    return (iClient != -1) ? _aClientIdentities[iClient].FindCharacter(pc) : -1;
+  }
+
   const INDEX ctClients = _aClientIdentities.Count();
 
   // Go through clients
@@ -107,62 +337,583 @@ INDEX IClientLogging::FindByCharacter(INDEX &iClient, const CPlayerCharacter &pc
 // Client log file
 static const CTString _strClientLogFile = "Data\\ClassicsPatch\\ClientLog.dat";
 
+// [Cecil] Journal of client log changes since the last snapshot
+static const CTString _strClientJournalFile = "Data\\ClassicsPatch\\ClientLog.jrn";
+
+// [Cecil] Compact the journal into the log once it grows past this size
+#define JOURNAL_COMPACT_SIZE (1024 * 1024)
+
+// [Cecil] Journal records cannot be bigger than this
+#define JOURNAL_MAX_RECORD (1024 * 1024)
+
+// [Cecil] Beginning of the journal file
+struct SJournalHeader {
+  char aID[4];     // "CLJR" (CLient log JouRnal)
+  ULONG ulVersion; // Format version
+  ULONG ulSerial;  // Journal number, increased after each compaction
+};
+
+static const ULONG _ulJournalVersion = 1;
+
+// [Cecil] One journal record with the entire state of one identity
+struct SJournalRecord {
+  ULONG ulSize; // Size of data after the record (identity index + identity)
+  ULONG ulCRC;  // Checksum of the data
+};
+
+// [Cecil] Current journal
+static FILE *_fJournal = NULL;
+static ULONG _ulJournalSerial = 0;
+static SLONG _slJournalSize = 0;
+
+// [Cecil] Snapshot of the client log that's being written on another thread
+struct SLogCompaction {
+  CTFileName fnmLog; // Full path to the log
+  UBYTE *pubData;    // Serialized log
+  SLONG slSize;      // Size of the serialized log
+  SLONG slJournalOffset; // Size of the journal at the moment of serialization
+  HANDLE hThread;
+  volatile LONG bDone;
+  DWORD dwError; // ERROR_SUCCESS if the log has been written
+};
+
+static SLogCompaction *_pCompaction = NULL;
+
+// [Cecil] Get full path to a client log file for writing
+static CTFileName ClientLogPath(const CTString &strFile) {
+  CTFileName fnmFull;
+  ExpandFilePath(EFP_WRITE, strFile, fnmFull);
+
+  return fnmFull;
+};
+
+// [Cecil] Copy contents of a memory stream into a new buffer
+static UBYTE *StreamToBuffer(CTMemoryStream &strm, SLONG &slSize) {
+  slSize = strm.GetStreamSize();
+  UBYTE *pub = (UBYTE *)AllocMemory(Max(slSize, (SLONG)1));
+
+  strm.SetPos_t(0);
+  strm.Read_t(pub, slSize);
+
+  return pub;
+};
+
+// [Cecil] Write an entire file through a temporary one, so it's never left half-written
+// Returns ERROR_SUCCESS or a system error code
+static DWORD ReplaceFileAtomically(const CTFileName &fnmFull, const UBYTE *pub, SLONG slSize) {
+  const CTString strTemp = fnmFull + ".tmp";
+
+  FILE *f = fopen(strTemp.str_String, "wb");
+  if (f == NULL) return GetLastError();
+
+  const BOOL bWritten = (fwrite(pub, 1, slSize, f) == (size_t)slSize);
+  const DWORD dwWriteError = GetLastError();
+  fclose(f);
+
+  if (!bWritten) return dwWriteError;
+
+  if (!MoveFileExA(strTemp.str_String, fnmFull.str_String, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    return GetLastError();
+  }
+
+  return ERROR_SUCCESS;
+};
+
+// [Cecil] Start a new journal, optionally with some records that aren't in the snapshot yet
+static void StartJournal(ULONG ulSerial, const UBYTE *pubRecords, SLONG slRecords) {
+  if (_fJournal != NULL) {
+    fclose(_fJournal);
+    _fJournal = NULL;
+  }
+
+  const CTFileName fnmJournal = ClientLogPath(_strClientJournalFile);
+
+  CStaticArray<UBYTE> aubFile;
+  aubFile.New(sizeof(SJournalHeader) + slRecords);
+
+  SJournalHeader &jh = *(SJournalHeader *)&aubFile[0];
+  memcpy(jh.aID, "CLJR", 4);
+  jh.ulVersion = _ulJournalVersion;
+  jh.ulSerial = ulSerial;
+
+  if (slRecords > 0) {
+    memcpy(&aubFile[sizeof(SJournalHeader)], pubRecords, slRecords);
+  }
+
+  _ulJournalSerial = ulSerial;
+  _slJournalSize = aubFile.Count();
+
+  const DWORD dwError = ReplaceFileAtomically(fnmJournal, &aubFile[0], aubFile.Count());
+
+  if (dwError != ERROR_SUCCESS) {
+    CPrintF(TRANS("Cannot create client log journal: %s\n"), GetWindowsError(dwError));
+    return;
+  }
+
+  _fJournal = fopen(fnmJournal.str_String, "ab");
+};
+
+// [Cecil] Append current state of some identity to the journal
+static void AppendToJournal(INDEX iIdentity) {
+  if (_fJournal == NULL) return;
+
+  SLONG slSize;
+  UBYTE *pubData;
+
+  try {
+    CTMemoryStream strm;
+    strm << iIdentity;
+    _aClientIdentities[iIdentity].Write(&strm);
+
+    pubData = StreamToBuffer(strm, slSize);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot write client log journal: %s\n"), strError);
+    return;
+  }
+
+  SJournalRecord jr;
+  jr.ulSize = slSize;
+
+  CRC_Start(jr.ulCRC);
+  CRC_AddBlock(jr.ulCRC, pubData, slSize);
+  CRC_Finish(jr.ulCRC);
+
+  fwrite(&jr, sizeof(jr), 1, _fJournal);
+  fwrite(pubData, 1, slSize, _fJournal);
+  fflush(_fJournal);
+
+  _slJournalSize += sizeof(jr) + slSize;
+  FreeMemory(pubData);
+};
+
+// [Cecil] Serialize the entire client log along with the journal position it includes
+static void SerializeLog_t(CTMemoryStream &strm, ULONG ulJournalSerial, SLONG slJournalOffset) {
+  strm.WriteID_t("CLLG"); // CLient LoG
+
+  // Write clients
+  const INDEX ctClients = _aClientIdentities.Count();
+  strm << ctClients;
+
+  for (INDEX i = 0; i < ctClients; i++) {
+    CClientIdentity &ci = _aClientIdentities[i];
+    ci.Write(&strm);
+  }
+
+  // Journal position (ignored by older versions)
+  strm.WriteID_t("JRNL");
+  strm << ulJournalSerial;
+  strm << slJournalOffset;
+};
+
+// [Cecil] Write serialized log in the background
+static DWORD WINAPI LogCompactionThread(LPVOID lpParam) {
+  SLogCompaction &lc = *(SLogCompaction *)lpParam;
+
+  lc.dwError = ReplaceFileAtomically(lc.fnmLog, lc.pubData, lc.slSize);
+  InterlockedExchange(&lc.bDone, TRUE);
+
+  return 0;
+};
+
+// [Cecil] Finish writing the snapshot and move journal records that came after it into a new journal
+static void FinishCompaction(BOOL bWait) {
+  if (_pCompaction == NULL) return;
+
+  SLogCompaction &lc = *_pCompaction;
+  if (!bWait && !lc.bDone) return;
+
+  if (lc.hThread != NULL) {
+    WaitForSingleObject(lc.hThread, INFINITE);
+    CloseHandle(lc.hThread);
+  }
+
+  if (lc.dwError == ERROR_SUCCESS) {
+    // Take records that have been added since the serialization
+    CStaticArray<UBYTE> aubTail;
+    const SLONG slTail = _slJournalSize - lc.slJournalOffset;
+
+    if (_fJournal != NULL) {
+      fclose(_fJournal);
+      _fJournal = NULL;
+    }
+
+    if (slTail > 0) {
+      aubTail.New(slTail);
+
+      FILE *f = fopen(ClientLogPath(_strClientJournalFile).str_String, "rb");
+
+      if (f != NULL) {
+        fseek(f, lc.slJournalOffset, SEEK_SET);
+        fread(&aubTail[0], 1, slTail, f);
+        fclose(f);
+      }
+    }
+
+    StartJournal(_ulJournalSerial + 1, (slTail > 0) ? &aubTail[0] : NULL, Max(slTail, (SLONG)0));
+
+  } else {
+    CPrintF(TRANS("Cannot save client log file: %s\n"), GetWindowsError(lc.dwError));
+  }
+
+  FreeMemory(lc.pubData);
+  delete _pCompaction;
+  _pCompaction = NULL;
+};
+
+// [Cecil] Get index of an identity from the log
+static INDEX GetIdentityIndex(CClientIdentity *pci) {
+  SyncIndex();
+  return _iiIdentities.Find(HashIdentity(pci), SMatchIdentity(pci));
+};
+
+// [Cecil] Remember new or changed identity in the journal
+void IClientLogging::JournalIdentity(CClientIdentity *pci) {
+  FinishCompaction(FALSE);
+
+  const INDEX iIdentity = GetIdentityIndex(pci);
+
+  if (iIdentity != -1) {
+    AppendToJournal(iIdentity);
+  }
+};
+
+// [Cecil] Flush the journal and compact it in the background if it's grown too big
+void IClientLogging::FlushLog(void) {
+  FinishCompaction(FALSE);
+
+  if (_fJournal == NULL) return;
+  fflush(_fJournal);
+
+  // Already compacting or nothing to compact yet
+  if (_pCompaction != NULL || _slJournalSize < JOURNAL_COMPACT_SIZE) return;
+
+  SLogCompaction *plc = new SLogCompaction;
+
+  try {
+    CTMemoryStream strm;
+    SerializeLog_t(strm, _ulJournalSerial, _slJournalSize);
+
+    plc->pubData = StreamToBuffer(strm, plc->slSize);
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot save client log file: %s\n"), strError);
+    delete plc;
+    return;
+  }
+
+  IDir::CreateDir(_strClientLogFile);
+
+  plc->fnmLog = ClientLogPath(_strClientLogFile);
+  plc->slJournalOffset = _slJournalSize;
+  plc->bDone = FALSE;
+  plc->dwError = ERROR_SUCCESS;
+
+  DWORD dwThreadID;
+  plc->hThread = CreateThread(NULL, 0, &LogCompactionThread, plc, 0, &dwThreadID);
+
+  // Write it right away without a thread
+  if (plc->hThread == NULL) {
+    LogCompactionThread(plc);
+  }
+
+  _pCompaction = plc;
+};
+
 // Save client log
 void IClientLogging::SaveLog(void) {
+  // [Cecil] Don't race with the background compaction
+  FinishCompaction(TRUE);
+
   // Make sure the directory exists
   IDir::CreateDir(_strClientLogFile);
 
   try {
-    CTFileStream strm;
-    strm.Create_t(_strClientLogFile);
+    // [Cecil] Snapshot includes everything, so the next journal is replayed from the start
+    CTMemoryStream strm;
+    SerializeLog_t(strm, _ulJournalSerial + 1, sizeof(SJournalHeader));
 
-    strm.WriteID_t("CLLG"); // CLient LoG
+    SLONG slSize;
+    UBYTE *pubData = StreamToBuffer(strm, slSize);
 
-    // Write clients
-    const INDEX ctClients = _aClientIdentities.Count();
-    strm << ctClients;
+    const DWORD dwError = ReplaceFileAtomically(ClientLogPath(_strClientLogFile), pubData, slSize);
+    FreeMemory(pubData);
 
-    for (INDEX i = 0; i < ctClients; i++) {
-      CClientIdentity &ci = _aClientIdentities[i];
-      ci.Write(&strm);
+    if (dwError != ERROR_SUCCESS) {
+      ThrowF_t("%s", GetWindowsError(dwError));
     }
 
-    strm.Close();
-
   } catch (char *strError) {
     CPrintF(TRANS("Cannot save client log file: %s\n"), strError);
+    return;
+  }
+
+  StartJournal(_ulJournalSerial + 1, NULL, 0);
+};
+
+// [Cecil] Replay journal records that aren't in the loaded snapshot
+static void ReplayJournal(ULONG ulSnapshotSerial, SLONG slSnapshotOffset) {
+  const CTFileName fnmJournal = ClientLogPath(_strClientJournalFile);
+  FILE *f = fopen(fnmJournal.str_String, "rb");
+
+  SLONG slStart = -1;
+  SLONG slValid = 0;
+  INDEX ctReplayed = 0;
+  SJournalHeader jh;
+
+  if (f != NULL && fread(&jh, sizeof(jh), 1, f) == 1
+   && memcmp(jh.aID, "CLJR", 4) == 0 && jh.ulVersion == _ulJournalVersion)
+  {
+    // Journal that the snapshot has been made from
+    if (jh.ulSerial == ulSnapshotSerial) {
+      slStart = slSnapshotOffset;
+
+    // Journal that has been started after the snapshot
+    } else if (jh.ulSerial == ulSnapshotSerial + 1) {
+      slStart = sizeof(jh);
+    }
+  }
+
+  if (slStart >= (SLONG)sizeof(jh) && fseek(f, slStart, SEEK_SET) == 0 && ftell(f) == slStart) {
+    slValid = slStart;
+
+    for (;;) {
+      SJournalRecord jr;
+      if (fread(&jr, sizeof(jr), 1, f) != 1) break;
+      if (jr.ulSize < sizeof(INDEX) || jr.ulSize > JOURNAL_MAX_RECORD) break;
+
+      CStaticArray<UBYTE> aubData;
+      aubData.New(jr.ulSize);
+
+      if (fread(&aubData[0], 1, jr.ulSize, f) != jr.ulSize) break;
+
+      // Incomplete or damaged record from a crash
+      ULONG ulCRC;
+      CRC_Start(ulCRC);
+      CRC_AddBlock(ulCRC, &aubData[0], jr.ulSize);
+      CRC_Finish(ulCRC);
+
+      if (ulCRC != jr.ulCRC) break;
+
+      try {
+        CTMemoryStream strm;
+        strm.Write_t(&aubData[0], jr.ulSize);
+        strm.SetPos_t(0);
+
+        INDEX iIdentity;
+        strm >> iIdentity;
+
+        // Identities can only be changed or added at the end
+        const INDEX ctIdentities = _aClientIdentities.Count();
+        if (iIdentity < 0 || iIdentity > ctIdentities) break;
+
+        CClientIdentity &ci = (iIdentity == ctIdentities) ? _aClientIdentities.Push() : _aClientIdentities[iIdentity];
+        ci.Clear();
+        ci.Read(&strm);
+
+      } catch (char *) {
+        break;
+      }
+
+      slValid += sizeof(jr) + jr.ulSize;
+      ctReplayed++;
+    }
+  }
+
+  if (f != NULL) {
+    fclose(f);
+  }
+
+  // Journal doesn't match the snapshot
+  if (slStart < (SLONG)sizeof(jh)) {
+    StartJournal(ulSnapshotSerial + 1, NULL, 0);
+    return;
+  }
+
+  // Cut off anything after the last valid record and keep appending to it
+  f = fopen(fnmJournal.str_String, "r+b");
+
+  if (f != NULL) {
+    _chsize(_fileno(f), slValid);
+    fclose(f);
+  }
+
+  _ulJournalSerial = jh.ulSerial;
+  _slJournalSize = slValid;
+  _fJournal = fopen(fnmJournal.str_String, "ab");
+
+  if (ctReplayed != 0) {
+    CPrintF(TRANS("Replayed %d client log journal records\n"), ctReplayed);
   }
 };
 
 // Load client log
 void IClientLogging::LoadLog(void) {
-  // No log file
-  if (!FileExists(_strClientLogFile)) return;
+  // [Cecil] Finish with the current journal
+  FinishCompaction(TRUE);
+
+  if (_fJournal != NULL) {
+    fclose(_fJournal);
+    _fJournal = NULL;
+  }
+
+  // [Cecil] Journal position that's included in the snapshot
+  ULONG ulSnapshotSerial = 0;
+  SLONG slSnapshotOffset = 0;
+
+  // [Cecil] Read the snapshot if there is one
+  if (FileExists(_strClientLogFile)) {
+    try {
+      CTFileStream strm;
+      strm.Open_t(_strClientLogFile);
+
+      strm.ExpectID_t("CLLG"); // CLient LoG
+
+      // Read clients
+      INDEX ctClients;
+      strm >> ctClients;
+
+      // [Cecil] Empty snapshots are fine as long as they have the journal position
+      if (ctClients > 0) {
+        CClientIdentity *aci = _aClientIdentities.Push(ctClients);
+
+        for (INDEX i = 0; i < ctClients; i++) {
+          aci[i].Read(&strm);
+        }
+      }
+
+      // [Cecil] Journal position
+      if (strm.GetPos_t() < strm.GetStreamSize()) {
+        strm.ExpectID_t("JRNL");
+        strm >> ulSnapshotSerial;
+        strm >> slSnapshotOffset;
+      }
+
+      strm.Close();
+
+    } catch (char *strError) {
+      CPrintF(TRANS("Cannot load client log file: %s\n"), strError);
+    }
+  }
+
+  // [Cecil] Apply changes since the snapshot
+  IDir::CreateDir(_strClientJournalFile);
+  ReplayJournal(ulSnapshotSerial, slSnapshotOffset);
+};
+
+// [Cecil] Measure lookups among synthetic identities with and without hash indices
+void IClientLogging::Benchmark(INDEX ctIdentities, INDEX ctLookups) {
+  ctIdentities = ClampDn(ctIdentities, (INDEX)1);
+  ctLookups = ClampDn(ctLookups, (INDEX)1);
+
+  // Active clients point to identities in the log
+  if (_pNetwork->IsServer()) {
+    CPutString(TRANS("Cannot benchmark the client log while running a server!\n"));
+    return;
+  }
+
+  // Put the real log aside
+  CTMemoryStream strmBackup;
 
   try {
-    CTFileStream strm;
-    strm.Open_t(_strClientLogFile);
+    const INDEX ctReal = _aClientIdentities.Count();
+    strmBackup << ctReal;
+
+    for (INDEX i = 0; i < ctReal; i++) {
+      _aClientIdentities[i].Write(&strmBackup);
+    }
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot back up the client log: %s\n"), strError);
+    return;
+  }
+
+  _aClientIdentities.Clear();
+  InvalidateIndex();
+
+  // Generate identities with unique addresses and characters
+  CClientIdentity *aci = _aClientIdentities.Push(ctIdentities);
+  INDEX i;
 
-    strm.ExpectID_t("CLLG"); // CLient LoG
+  for (i = 0; i < ctIdentities; i++) {
+    aci[i].aAddresses.Push() = SClientAddress(ULONG(0x0A000000 + i));
 
-    // Read clients
-    INDEX ctClients;
-    strm >> ctClients;
+    CPlayerCharacter &pc = aci[i].aCharacters.Push();
+    memset(pc.pc_aubGUID, 0xCE, sizeof(pc.pc_aubGUID));
+    memcpy(pc.pc_aubGUID, &i, sizeof(i));
+  }
+
+  // Pick random keys with about half of them missing from the log
+  CStaticArray<SClientAddress> aAddresses;
+  CStaticArray<CPlayerCharacter> aCharacters;
+  aAddresses.New(ctLookups);
+  aCharacters.New(ctLookups);
+
+  ULONG ulSeed = 12345;
+
+  for (i = 0; i < ctLookups; i++) {
+    ulSeed = ulSeed * 1103515245UL + 12345UL;
+    const INDEX iKey = (ulSeed >> 8) % (ctIdentities * 2);
+
+    aAddresses[i] = SClientAddress(ULONG(0x0A000000 + iKey));
+
+    memset(aCharacters[i].pc_aubGUID, 0xCE, sizeof(aCharacters[i].pc_aubGUID));
+    memcpy(aCharacters[i].pc_aubGUID, &iKey, sizeof(iKey));
+  }
 
-    // Warning for safety
-    if (ctClients == 0) {
-      ThrowF_t(TRANS("Client count is zero"));
+  CPrintF(TRANS("Client log lookups among %d identities (%d lookups each):\n"), ctIdentities, ctLookups);
+  const INDEX iOldIndex = ser_bClientLogIndex;
+
+  for (INDEX iMode = 0; iMode < 2; iMode++) {
+    ser_bClientLogIndex = iMode;
+    InvalidateIndex();
+
+    INDEX iIdentity, ctFound = 0;
+
+    // Building the index happens on the first lookup
+    CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+    FindByAddress(iIdentity, SClientAddress(ULONG(0)));
+    const DOUBLE dBuild = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() * 1000.0;
+
+    tvStart = _pTimer->GetHighPrecisionTimer();
+
+    for (i = 0; i < ctLookups; i++) {
+      if (FindByAddress(iIdentity, aAddresses[i]) != -1) ctFound++;
     }
 
-    CClientIdentity *aci = _aClientIdentities.Push(ctClients);
+    const DOUBLE dAddresses = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() * 1000.0;
+    tvStart = _pTimer->GetHighPrecisionTimer();
 
-    for (INDEX i = 0; i < ctClients; i++) {
-      aci[i].Read(&strm);
+    for (i = 0; i < ctLookups; i++) {
+      if (FindByCharacter(iIdentity, aCharacters[i]) != -1) ctFound++;
     }
 
-    strm.Close();
+    const DOUBLE dCharacters = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() * 1000.0;
+
+    CPrintF(TRANS("  %s: first lookup %.3f ms, by address %.5f ms, by character %.5f ms (%d found)\n"),
+      iMode ? "hashed" : "linear", dBuild, dAddresses / ctLookups, dCharacters / ctLookups, ctFound);
+  }
+
+  // Restore the real log
+  ser_bClientLogIndex = iOldIndex;
+  _aClientIdentities.Clear();
+  InvalidateIndex();
+
+  try {
+    strmBackup.SetPos_t(0);
+
+    INDEX ctReal;
+    strmBackup >> ctReal;
+
+    if (ctReal > 0) {
+      aci = _aClientIdentities.Push(ctReal);
+
+      for (i = 0; i < ctReal; i++) {
+        aci[i].Read(&strmBackup);
+      }
+    }
 
   } catch (char *strError) {
-    CPrintF(TRANS("Cannot load client log file: %s\n"), strError);
+    CPrintF(TRANS("Cannot restore the client log: %s\n"), strError);
   }
 };
@@ -102,6 +102,9 @@ struct CORE_API SClientAddress {
     };
 };
 
+// [Cecil] Use hash indices for finding client identities instead of going through all of them
+CORE_API extern INDEX ser_bClientLogIndex;
+
 // Interface with methods for client logging
 class CORE_API IClientLogging {
   public:
@@ -118,12 +121,27 @@ class CORE_API IClientLogging {
     // Find client index in the list from a character and return character index
     static INDEX FindByCharacter(INDEX &iClient, const CPlayerCharacter &pc);
 
+    // [Cecil] Add a new character of an existing identity to the hash index
+    static void IndexCharacter(class CClientIdentity *pci, const CPlayerCharacter &pc);
+
+    // [Cecil] Rebuild hash indices on the next lookup after identities or their data have been removed
+    static void InvalidateIndex(void);
+
   public:
     // Save client log
     static void SaveLog(void);
 
+    // [Cecil] Remember new or changed identity in the journal
+    static void JournalIdentity(class CClientIdentity *pci);
+
+    // [Cecil] Flush the journal and compact it in the background if it's grown too big
+    static void FlushLog(void);
+
     // Load client log
     static void LoadLog(void);
+
+    // [Cecil] Measure lookups among synthetic identities with and without hash indices
+    static void Benchmark(INDEX ctIdentities, INDEX ctLookups);
 };
 
 // Declare all elements of client logging system
@@ -19,18 +19,226 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "ActiveClients.h"
 #include "Networking/NetworkFunctions.h"
 
-// Records of all client restrictions
-static CDynamicContainer<CClientRestriction> _cClientRestrictions;
+// [Cecil] Records of all client restrictions by client identities
+// Each slot has the first record of some identity, the rest are linked from it
+static CStaticArray<CClientRestriction *> _apcrByClient;
+static INDEX _ctRestrictedClients = 0;
+
+// [Cecil] Min-heap of records that can expire, ordered by expiration time
+static CStaticStackArray<CClientRestriction *> _apcrExpirations;
+
+// [Cecil] Hash of a client identity pointer
+static inline ULONG HashClient(const CClientIdentity *pci) {
+  ULONG ulHash = (ULONG)(size_t)pci;
+  ulHash ^= ulHash >> 16;
+  ulHash *= 0x45D9F3B;
+  ulHash ^= ulHash >> 16;
+
+  return ulHash;
+};
+
+// [Cecil] Find slot with records of some client or an empty slot for it
+static INDEX FindClientSlot(const CClientIdentity *pci) {
+  const ULONG ulMask = _apcrByClient.Count() - 1;
+  ULONG ulSlot = HashClient(pci) & ulMask;
+
+  while (_apcrByClient[ulSlot] != NULL && _apcrByClient[ulSlot]->pciClient != pci) {
+    ulSlot = (ulSlot + 1) & ulMask;
+  }
+
+  return ulSlot;
+};
+
+// [Cecil] Get the first record of some client
+static CClientRestriction *FirstClientRecord(const CClientIdentity *pci) {
+  if (_ctRestrictedClients == 0) return NULL;
+
+  return _apcrByClient[FindClientSlot(pci)];
+};
+
+// [Cecil] Resize the table of records by clients
+static void ResizeClientTable(INDEX ctSlots) {
+  CStaticArray<CClientRestriction *> apcrOld;
+  apcrOld.MoveArray(_apcrByClient);
+
+  _apcrByClient.New(ctSlots);
+
+  for (INDEX iSlot = 0; iSlot < ctSlots; iSlot++) {
+    _apcrByClient[iSlot] = NULL;
+  }
+
+  for (INDEX iOld = 0; iOld < apcrOld.Count(); iOld++) {
+    CClientRestriction *pcr = apcrOld[iOld];
+
+    if (pcr != NULL) {
+      _apcrByClient[FindClientSlot(pcr->pciClient)] = pcr;
+    }
+  }
+};
+
+// [Cecil] Add a record to the table of records by clients
+static void AddClientRecord(CClientRestriction *pcr) {
+  // Keep the table at most half full
+  if ((_ctRestrictedClients + 1) * 2 > _apcrByClient.Count()) {
+    ResizeClientTable(Max(_apcrByClient.Count() * 2, (INDEX)64));
+  }
+
+  CClientRestriction *&pcrFirst = _apcrByClient[FindClientSlot(pcr->pciClient)];
+
+  if (pcrFirst == NULL) {
+    _ctRestrictedClients++;
+  }
+
+  // Link in front of other records of the same client
+  pcr->pcrNextForClient = pcrFirst;
+  pcrFirst = pcr;
+};
+
+// [Cecil] Remove a record from the table of records by clients
+static void RemoveClientRecord(CClientRestriction *pcr) {
+  const ULONG ulMask = _apcrByClient.Count() - 1;
+  ULONG ulSlot = FindClientSlot(pcr->pciClient);
+
+  // Unlink from other records of the same client
+  CClientRestriction **ppcr = &_apcrByClient[ulSlot];
+
+  while (*ppcr != NULL && *ppcr != pcr) {
+    ppcr = &(*ppcr)->pcrNextForClient;
+  }
+
+  if (*ppcr == NULL) {
+    ASSERT(FALSE);
+    return;
+  }
+
+  *ppcr = pcr->pcrNextForClient;
+  pcr->pcrNextForClient = NULL;
+
+  // Client still has other records
+  if (_apcrByClient[ulSlot] != NULL) return;
+
+  _ctRestrictedClients--;
+
+  // Shift following records back into the freed slot to keep probing sequences intact
+  ULONG ulNext = (ulSlot + 1) & ulMask;
+
+  while (_apcrByClient[ulNext] != NULL) {
+    const ULONG ulHome = HashClient(_apcrByClient[ulNext]->pciClient) & ulMask;
+
+    // Move if the record's home slot isn't cyclically between the freed slot and its current one
+    const BOOL bMove = (ulSlot <= ulNext)
+      ? (ulHome <= ulSlot || ulHome > ulNext)
+      : (ulHome <= ulSlot && ulHome > ulNext);
+
+    if (bMove) {
+      _apcrByClient[ulSlot] = _apcrByClient[ulNext];
+      _apcrByClient[ulNext] = NULL;
+      ulSlot = ulNext;
+    }
+
+    ulNext = (ulNext + 1) & ulMask;
+  }
+};
+
+// [Cecil] Check which of two records expires earlier
+static inline BOOL ExpiresBefore(const CClientRestriction *pcr1, const CClientRestriction *pcr2) {
+  return pcr1->GetExpiration() < pcr2->GetExpiration();
+};
+
+// [Cecil] Put a record at some heap position
+static inline void SetHeapRecord(INDEX i, CClientRestriction *pcr) {
+  _apcrExpirations[i] = pcr;
+  pcr->iExpirationHeap = i;
+};
+
+// [Cecil] Move record in the heap until it's in order
+static void RestoreHeapOrder(INDEX i) {
+  CClientRestriction *pcr = _apcrExpirations[i];
+
+  // Sift up
+  while (i > 0) {
+    const INDEX iParent = (i - 1) / 2;
+    if (!ExpiresBefore(pcr, _apcrExpirations[iParent])) break;
+
+    SetHeapRecord(i, _apcrExpirations[iParent]);
+    i = iParent;
+  }
+
+  // Sift down
+  const INDEX ct = _apcrExpirations.Count();
+
+  for (;;) {
+    INDEX iChild = i * 2 + 1;
+    if (iChild >= ct) break;
+
+    if (iChild + 1 < ct && ExpiresBefore(_apcrExpirations[iChild + 1], _apcrExpirations[iChild])) {
+      iChild++;
+    }
+
+    if (!ExpiresBefore(_apcrExpirations[iChild], pcr)) break;
+
+    SetHeapRecord(i, _apcrExpirations[iChild]);
+    i = iChild;
+  }
+
+  SetHeapRecord(i, pcr);
+};
+
+// [Cecil] Remove a record from the expiration heap
+static void RemoveFromHeap(CClientRestriction *pcr) {
+  const INDEX i = pcr->iExpirationHeap;
+  if (i == -1) return;
+
+  pcr->iExpirationHeap = -1;
+
+  // Replace with the last record
+  CClientRestriction *pcrLast = _apcrExpirations.Pop();
+
+  if (pcrLast != pcr) {
+    SetHeapRecord(i, pcrLast);
+    RestoreHeapOrder(i);
+  }
+};
+
+// [Cecil] Time when the entire record expires (negative if never)
+CTimerValue CClientRestriction::GetExpiration(void) const {
+  // Indefinite restrictions
+  if (tvBanExpiration.tv_llValue < 0 || tvMuteExpiration.tv_llValue < 0) {
+    CTimerValue tvNever;
+    tvNever.tv_llValue = -1;
+    return tvNever;
+  }
+
+  return (tvBanExpiration < tvMuteExpiration) ? tvMuteExpiration : tvBanExpiration;
+};
+
+// [Cecil] Update record position in the expiration heap after changing its times
+void CClientRestriction::UpdateExpiration(void) {
+  // Records that never expire aren't in the heap
+  if (GetExpiration().tv_llValue < 0) {
+    RemoveFromHeap(this);
+    return;
+  }
+
+  if (iExpirationHeap == -1) {
+    iExpirationHeap = _apcrExpirations.Count();
+    _apcrExpirations.Push() = this;
+  }
+
+  RestoreHeapOrder(iExpirationHeap);
+};
 
 // Set new ban time
 void CClientRestriction::SetBanTime(CTimerValue tvTime) {
   // Indefinite ban
   if (tvTime.tv_llValue < 0) {
     tvBanExpiration.tv_llValue = -1;
-    return;
+  } else {
+    tvBanExpiration = _pTimer->GetHighPrecisionTimer() + tvTime;
   }
 
-  tvBanExpiration = _pTimer->GetHighPrecisionTimer() + tvTime;
+  // [Cecil] Keep the expiration order
+  UpdateExpiration();
 };
 
 // Get remaining ban time
@@ -64,10 +272,12 @@ void CClientRestriction::SetMuteTime(CTimerValue tvTime) {
   // Indefinite mute
   if (tvTime.tv_llValue < 0) {
     tvMuteExpiration.tv_llValue = -1;
-    return;
+  } else {
+    tvMuteExpiration = _pTimer->GetHighPrecisionTimer() + tvTime;
   }
 
-  tvMuteExpiration = _pTimer->GetHighPrecisionTimer() + tvTime;
+  // [Cecil] Keep the expiration order
+  UpdateExpiration();
 };
 
 // Get remaining mute time
@@ -98,31 +308,18 @@ void CClientRestriction::PrintMuteTime(CTString &str) const {
 
 // Check if any records have expired and remove them from the list
 void CClientRestriction::UpdateExpirations(void) {
-  // Container of expired records
-  CDynamicContainer<CClientRestriction> cExpired;
-
   const CTimerValue tvNow = _pTimer->GetHighPrecisionTimer();
 
-  // Go through all restriction records
-  FOREACHINDYNAMICCONTAINER(_cClientRestrictions, CClientRestriction, itcrCheck) {
-    CClientRestriction *pcr = itcrCheck;
-
-    // Skip records with indefinite times
-    if (pcr->tvBanExpiration.tv_llValue < 0 || pcr->tvMuteExpiration.tv_llValue < 0) {
-      continue;
-    }
+  // [Cecil] Only go through records that are due
+  while (_apcrExpirations.Count() != 0) {
+    CClientRestriction *pcr = _apcrExpirations[0];
 
     // If both times are behind the current time
-    if (pcr->tvBanExpiration < tvNow && pcr->tvMuteExpiration < tvNow) {
-      // Add to the expired list
-      cExpired.Add(pcr);
-    }
-  }
+    if (!(pcr->GetExpiration() < tvNow)) break;
 
-  // Remove expired records from the record list
-  FOREACHINDYNAMICCONTAINER(cExpired, CClientRestriction, itcrExpired) {
-    _cClientRestrictions.Remove(itcrExpired);
-    delete &*itcrExpired;
+    RemoveFromHeap(pcr);
+    RemoveClientRecord(pcr);
+    delete pcr;
   }
 };
 
@@ -132,26 +329,20 @@ CClientRestriction *CClientRestriction::AddNew(CClientIdentity *pci) {
   CClientRestriction *pcrNew = new CClientRestriction();
   pcrNew->pciClient = pci;
 
-  _cClientRestrictions.Add(pcrNew);
+  // [Cecil] Records without any times expire right away
+  AddClientRecord(pcrNew);
+  pcrNew->UpdateExpiration();
 
   return pcrNew;
 };
 
 // Check if some client is banned and return a record with the ban
 CClientRestriction *CClientRestriction::IsBanned(CClientIdentity *pci) {
-  const CTimerValue tvNow = _pTimer->GetHighPrecisionTimer();
-  const INDEX ct = _cClientRestrictions.Count();
-
-  // Go through all restriction records
-  for (INDEX i = 0; i < ct; i++) {
-    CClientRestriction *pcr = _cClientRestrictions.Pointer(i);
-
-    // Found matching client identity
-    if (pcr->pciClient == pci) {
-      // Time hasn't expired yet
-      if (pcr->IsBanned()) {
-        return pcr;
-      }
+  // [Cecil] Go through records of this client
+  for (CClientRestriction *pcr = FirstClientRecord(pci); pcr != NULL; pcr = pcr->pcrNextForClient) {
+    // Time hasn't expired yet
+    if (pcr->IsBanned()) {
+      return pcr;
     }
   }
 
@@ -161,19 +352,11 @@ CClientRestriction *CClientRestriction::IsBanned(CClientIdentity *pci) {
 
 // Check if some client is muted and return a record with the mute
 CClientRestriction *CClientRestriction::IsMuted(CClientIdentity *pci) {
-  const CTimerValue tvNow = _pTimer->GetHighPrecisionTimer();
-  const INDEX ct = _cClientRestrictions.Count();
-
-  // Go through all restriction records
-  for (INDEX i = 0; i < ct; i++) {
-    CClientRestriction *pcr = _cClientRestrictions.Pointer(i);
-
-    // Found matching client identity
-    if (pcr->pciClient == pci) {
-      // Time hasn't expired yet
-      if (pcr->IsMuted()) {
-        return pcr;
-      }
+  // [Cecil] Go through records of this client
+  for (CClientRestriction *pcr = FirstClientRecord(pci); pcr != NULL; pcr = pcr->pcrNextForClient) {
+    // Time hasn't expired yet
+    if (pcr->IsMuted()) {
+      return pcr;
     }
   }
 
@@ -30,13 +30,25 @@ class CORE_API CClientRestriction {
     CTimerValue tvBanExpiration; // Time when the ban expires
     CTimerValue tvMuteExpiration; // Time when the mute expires
 
+    // [Cecil] Next record of the same client identity
+    CClientRestriction *pcrNextForClient;
+
+    // [Cecil] Position in the expiration heap (-1 if it never expires)
+    INDEX iExpirationHeap;
+
   public:
     // Default constructor
-    CClientRestriction() : pciClient(NULL) {
+    CClientRestriction() : pciClient(NULL), pcrNextForClient(NULL), iExpirationHeap(-1) {
       tvBanExpiration.Clear();
       tvMuteExpiration.Clear();
     };
 
+    // [Cecil] Time when the entire record expires (negative if never)
+    CTimerValue GetExpiration(void) const;
+
+    // [Cecil] Update record position in the expiration heap after changing its times
+    void UpdateExpiration(void);
+
   // Ban methods
   public:
 
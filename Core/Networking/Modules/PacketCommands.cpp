@@ -92,7 +92,7 @@ void EntityCreate(SHELL_FUNC_ARGS) {
   const CTString &strClass = *NEXT_ARG(CTString *);
 
   CExtEntityCreate pck;
-  pck("fnmClass", "Classes\\" + strClass + ".ecl");
+  pck.fnmClass = "Classes\\" + strClass + ".ecl";
   pck.SendToClients();
 };
 
@@ -103,8 +103,8 @@ void EntityDelete(SHELL_FUNC_ARGS) {
   INDEX iSameClass = NEXT_ARG(INDEX);
 
   CExtEntityDelete pck;
-  pck("ulEntity", (int)iEntity);
-  pck("bSameClass", bool(iSameClass != 0));
+  pck.ulEntity = iEntity;
+  pck.bSameClass = (iSameClass != 0);
   pck.SendToClients();
 };
 
@@ -115,8 +115,8 @@ void EntityCopy(SHELL_FUNC_ARGS) {
   INDEX iCopies = NEXT_ARG(INDEX);
 
   CExtEntityCopy pck;
-  pck("ulEntity", (int)iEntity);
-  pck("iCopies", Clamp(iCopies, (INDEX)0, (INDEX)31));
+  pck.ulEntity = iEntity;
+  pck.iCopies = Clamp(iCopies, (INDEX)0, (INDEX)31);
   pck.SendToClients();
 };
 
@@ -126,7 +126,7 @@ void EntityEvent(SHELL_FUNC_ARGS) {
   INDEX iEntity = NEXT_ARG(INDEX);
 
   CExtEntityEvent pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.Copy(_eePacketEvent, _ctPacketEventFields);
   pck.SendToClients();
 };
@@ -137,7 +137,7 @@ void EntityItem(SHELL_FUNC_ARGS) {
   INDEX iEntity = NEXT_ARG(INDEX);
 
   CExtEntityItem pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.Copy(_eePacketEvent, _ctPacketEventFields);
   pck.SendToClients();
 };
@@ -148,7 +148,7 @@ void EntityInit(SHELL_FUNC_ARGS) {
   INDEX iEntity = NEXT_ARG(INDEX);
 
   CExtEntityInit pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.SetEvent(EVoid(), sizeof(EVoid));
   pck.SendToClients();
 };
@@ -159,7 +159,7 @@ void EntityInitEvent(SHELL_FUNC_ARGS) {
   INDEX iEntity = NEXT_ARG(INDEX);
 
   CExtEntityInit pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.Copy(_eePacketEvent, _ctPacketEventFields);
   pck.SendToClients();
 };
@@ -174,10 +174,10 @@ void EntitySetPos(SHELL_FUNC_ARGS) {
   INDEX iRelative = NEXT_ARG(INDEX);
 
   CExtEntityPosition pck;
-  pck("ulEntity", (int)iEntity);
-  pck("vSet", FLOAT3D(fX, fY, fZ));
-  pck("bRotation", false);
-  pck("bRelative", bool(iRelative != 0));
+  pck.ulEntity = iEntity;
+  pck.vSet = FLOAT3D(fX, fY, fZ);
+  pck.bRotation = FALSE;
+  pck.bRelative = (iRelative != 0);
   pck.SendToClients();
 };
 
@@ -191,10 +191,10 @@ void EntitySetRot(SHELL_FUNC_ARGS) {
   INDEX iRelative = NEXT_ARG(INDEX);
 
   CExtEntityPosition pck;
-  pck("ulEntity", (int)iEntity);
-  pck("vSet", FLOAT3D(fH, fP, fB));
-  pck("bRotation", true);
-  pck("bRelative", bool(iRelative != 0));
+  pck.ulEntity = iEntity;
+  pck.vSet = FLOAT3D(fH, fP, fB);
+  pck.bRotation = TRUE;
+  pck.bRelative = (iRelative != 0);
   pck.SendToClients();
 };
 
@@ -211,9 +211,9 @@ void EntityTeleport(SHELL_FUNC_ARGS) {
   INDEX iRelative = NEXT_ARG(INDEX);
 
   CExtEntityTeleport pck;
-  pck("ulEntity", (int)iEntity);
-  pck("plSet", CPlacement3D(FLOAT3D(fX, fY, fZ), ANGLE3D(fH, fP, fB)));
-  pck("bRelative", bool(iRelative != 0));
+  pck.ulEntity = iEntity;
+  pck.plSet = CPlacement3D(FLOAT3D(fX, fY, fZ), ANGLE3D(fH, fP, fB));
+  pck.bRelative = (iRelative != 0);
   pck.SendToClients();
 };
 
@@ -224,8 +224,8 @@ void EntityParent(SHELL_FUNC_ARGS) {
   INDEX iParent = NEXT_ARG(INDEX);
 
   CExtEntityParent pck;
-  pck("ulEntity", (int)iEntity);
-  pck("ulParent", (int)iParent);
+  pck.ulEntity = iEntity;
+  pck.ulParent = iParent;
   pck.SendToClients();
 };
 
@@ -238,7 +238,7 @@ void EntityNumberProp(SHELL_FUNC_ARGS) {
   FLOAT fValue = NEXT_ARG(FLOAT);
 
   CExtEntityProp pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
 
   if (strProp != "") {
     pck.SetProperty(strProp);
@@ -259,7 +259,7 @@ void EntityStringProp(SHELL_FUNC_ARGS) {
   const CTString &strValue = *NEXT_ARG(CTString *);
 
   CExtEntityProp pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
 
   if (strProp != "") {
     pck.SetProperty(strProp);
@@ -278,8 +278,8 @@ void EntityHealth(SHELL_FUNC_ARGS) {
   FLOAT fHealth = NEXT_ARG(FLOAT);
 
   CExtEntityHealth pck;
-  pck("ulEntity", (int)iEntity);
-  pck("fHealth", fHealth);
+  pck.ulEntity = iEntity;
+  pck.fHealth = fHealth;
   pck.SendToClients();
 };
 
@@ -291,7 +291,7 @@ void EntityFlags(SHELL_FUNC_ARGS) {
   INDEX iRemove = NEXT_ARG(INDEX);
 
   CExtEntityFlags pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.EntityFlags(iFlags, (iRemove != 0));
   pck.SendToClients();
 };
@@ -304,7 +304,7 @@ void EntityPhysicalFlags(SHELL_FUNC_ARGS) {
   INDEX iRemove = NEXT_ARG(INDEX);
 
   CExtEntityFlags pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.PhysicalFlags(iFlags, (iRemove != 0));
   pck.SendToClients();
 };
@@ -317,7 +317,7 @@ void EntityCollisionFlags(SHELL_FUNC_ARGS) {
   INDEX iRemove = NEXT_ARG(INDEX);
 
   CExtEntityFlags pck;
-  pck("ulEntity", (int)iEntity);
+  pck.ulEntity = iEntity;
   pck.CollisionFlags(iFlags, (iRemove != 0));
   pck.SendToClients();
 };
@@ -331,8 +331,8 @@ void EntityMove(SHELL_FUNC_ARGS) {
   FLOAT fZ = NEXT_ARG(FLOAT);
 
   CExtEntityMove pck;
-  pck("ulEntity", (int)iEntity);
-  pck("vSpeed", FLOAT3D(fX, fY, fZ));
+  pck.ulEntity = iEntity;
+  pck.vSpeed = FLOAT3D(fX, fY, fZ);
   pck.SendToClients();
 };
 
@@ -345,8 +345,8 @@ void EntityRotate(SHELL_FUNC_ARGS) {
   FLOAT fB = NEXT_ARG(FLOAT);
 
   CExtEntityRotate pck;
-  pck("ulEntity", (int)iEntity);
-  pck("vSpeed", FLOAT3D(fH, fP, fB));
+  pck.ulEntity = iEntity;
+  pck.vSpeed = FLOAT3D(fH, fP, fB);
   pck.SendToClients();
 };
 
@@ -359,8 +359,8 @@ void EntityImpulse(SHELL_FUNC_ARGS) {
   FLOAT fZ = NEXT_ARG(FLOAT);
 
   CExtEntityImpulse pck;
-  pck("ulEntity", (int)iEntity);
-  pck("vSpeed", FLOAT3D(fX, fY, fZ));
+  pck.ulEntity = iEntity;
+  pck.vSpeed = FLOAT3D(fX, fY, fZ);
   pck.SendToClients();
 };
 
@@ -442,35 +442,35 @@ void EntityDamage(void) {
   switch (_iDamageSetup) {
     case 0: {
       CExtEntityDirectDamage pck;
-      pck("ulEntity", (int)_ulDamageInflictor);
-      pck("eDamageType", (int)_ulDamageType);
-      pck("fDamage", _fDamageAmount);
+      pck.ulEntity = _ulDamageInflictor;
+      pck.eDamageType = _ulDamageType;
+      pck.fDamage = _fDamageAmount;
 
-      pck("ulTarget", (int)_ulDamageTarget);
-      pck("vHitPoint", _vDamageVec1);
-      pck("vDirection", _vDamageVec2);
+      pck.ulTarget = _ulDamageTarget;
+      pck.vHitPoint = _vDamageVec1;
+      pck.vDirection = _vDamageVec2;
       pck.SendToClients();
     } break;
 
     case 1: {
       CExtEntityRangeDamage pck;
-      pck("ulEntity", (int)_ulDamageInflictor);
-      pck("eDamageType", (int)_ulDamageType);
-      pck("fDamage", _fDamageAmount);
+      pck.ulEntity = _ulDamageInflictor;
+      pck.eDamageType = _ulDamageType;
+      pck.fDamage = _fDamageAmount;
 
-      pck("vCenter", _vDamageVec1);
-      pck("fFallOff", _vDamageVec2(1));
-      pck("fHotSpot", _vDamageVec2(2));
+      pck.vCenter = _vDamageVec1;
+      pck.fFallOff = _vDamageVec2(1);
+      pck.fHotSpot = _vDamageVec2(2);
       pck.SendToClients();
     } break;
 
     case 2: {
       CExtEntityBoxDamage pck;
-      pck("ulEntity", (int)_ulDamageInflictor);
-      pck("eDamageType", (int)_ulDamageType);
-      pck("fDamage", _fDamageAmount);
+      pck.ulEntity = _ulDamageInflictor;
+      pck.eDamageType = _ulDamageType;
+      pck.fDamage = _fDamageAmount;
 
-      pck("boxArea", FLOATaabbox3D(_vDamageVec1, _vDamageVec2));
+      pck.boxArea = FLOATaabbox3D(_vDamageVec1, _vDamageVec2);
       pck.SendToClients();
     } break;
   }
@@ -482,7 +482,7 @@ void ChangeLevel(SHELL_FUNC_ARGS) {
   const CTString &strWorld = *NEXT_ARG(CTString *);
 
   CExtChangeLevel pck;
-  pck("strWorld", strWorld);
+  pck.strWorld = strWorld;
   pck.SendToClients();
 };
 
@@ -492,7 +492,7 @@ void ChangeWorld(SHELL_FUNC_ARGS) {
   const CTString &strWorld = *NEXT_ARG(CTString *);
 
   CExtChangeWorld pck;
-  pck("strWorld", strWorld);
+  pck.strWorld = strWorld;
   pck.SendToClients();
 };
 
@@ -571,10 +571,10 @@ void PlayQuickSound(SHELL_FUNC_ARGS) {
   FLOAT fVolume = NEXT_ARG(FLOAT);
 
   CExtPlaySound pck;
-  pck("strFile", strFile);
-  pck("iChannel", (int)iChannel);
-  pck("fVolumeL", fVolume);
-  pck("fVolumeR", fVolume);
+  pck.strFile = strFile;
+  pck.iChannel = iChannel;
+  pck.fVolumeL = fVolume;
+  pck.fVolumeR = fVolume;
   pck.SendToClients();
 };
 
@@ -592,17 +592,17 @@ void PlayGlobalSound(SHELL_FUNC_ARGS) {
   FLOAT fPitch = NEXT_ARG(FLOAT);
 
   CExtPlaySound pck;
-  pck("strFile", strFile);
-  pck("iChannel", (int)iChannel);
-  pck("ulFlags", (int)iFlags);
-  pck("fDelay", fDelay);
-  pck("fOffset", fOffset);
-
-  pck("fVolumeL", fVolume);
-  pck("fVolumeR", fVolume);
-  pck("fFilterL", fFilter);
-  pck("fFilterR", fFilter);
-  pck("fPitch", fPitch);
+  pck.strFile = strFile;
+  pck.iChannel = iChannel;
+  pck.ulFlags = iFlags;
+  pck.fDelay = fDelay;
+  pck.fOffset = fOffset;
+
+  pck.fVolumeL = fVolume;
+  pck.fVolumeR = fVolume;
+  pck.fFilterL = fFilter;
+  pck.fFilterR = fFilter;
+  pck.fPitch = fPitch;
   pck.SendToClients();
 };
 
@@ -28,6 +28,10 @@ void INetwork::Initialize(void) {
   // Load client log
   IClientLogging::LoadLog();
 
+  // [Cecil] Load address filter
+  IAddressFilter::Load();
+  IAddressFilter::DeclareSymbols();
+
   // Server commands
   _pShell->DeclareSymbol("persistent user INDEX ser_bEnableAntiFlood;",      &ser_bEnableAntiFlood);
   _pShell->DeclareSymbol("persistent user INDEX ser_iPacketFloodThreshold;", &ser_iPacketFloodThreshold);
@@ -146,7 +150,7 @@ BOOL INetwork::ServerHandle(CMessageDispatcher *pmd, INDEX iClient, CNetworkMess
   }
 
   // Read and process the packet
-  pPacket->Read(nmMessage);
+  IExtPacketStream::Read(pPacket, nmMessage);
   pPacket->Process();
 
   // No extra processing needed
@@ -161,18 +165,10 @@ BOOL INetwork::ServerHandle(CMessageDispatcher *pmd, INDEX iClient, CNetworkMess
 #endif // _PATCHCONFIG_EXT_PACKETS
 };
 
-// Handle packets coming from a server
-// If output is TRUE, it will pass packets into engine's CSessionState::ProcessGameStreamBlock()
-BOOL INetwork::ClientHandle(CSessionState *pses, CNetworkMessage &nmMessage) {
 #if _PATCHCONFIG_EXT_PACKETS
 
-  // Let default methods handle packets of other types
-  if (nmMessage.GetType() != PCK_EXTENSION) return TRUE;
-
-  // Handle specific packet types
-  ULONG ulType;
-  INetDecompress::Integer(nmMessage, ulType);
-
+// Handle one extension packet of a specific type (returns FALSE if the rest of the message can't be read)
+static BOOL HandleClientExtPacket(CNetworkMessage &nmMessage, ULONG ulType) {
   // Let plugins handle packets
   FOREACHPLUGIN(itPlugin) {
     if (itPlugin->pm_events.m_network->OnClientPacket == NULL) continue;
@@ -180,7 +176,7 @@ BOOL INetwork::ClientHandle(CSessionState *pses, CNetworkMessage &nmMessage) {
     // Handle packet through this plugin handler
     if (itPlugin->pm_events.m_network->OnClientPacket(nmMessage, ulType)) {
       // Quit if packet has been handled
-      return FALSE;
+      return TRUE;
     }
   }
 
@@ -200,11 +196,46 @@ BOOL INetwork::ClientHandle(CSessionState *pses, CNetworkMessage &nmMessage) {
   }
 
   // Read and process the packet
-  pPacket->Read(nmMessage);
+  IExtPacketStream::Read(pPacket, nmMessage);
   pPacket->Process();
 
-  // No extra processing needed
   delete pPacket;
+  return TRUE;
+};
+
+#endif // _PATCHCONFIG_EXT_PACKETS
+
+// Handle packets coming from a server
+// If output is TRUE, it will pass packets into engine's CSessionState::ProcessGameStreamBlock()
+BOOL INetwork::ClientHandle(CSessionState *pses, CNetworkMessage &nmMessage) {
+#if _PATCHCONFIG_EXT_PACKETS
+
+  // Let default methods handle packets of other types
+  if (nmMessage.GetType() != PCK_EXTENSION) return TRUE;
+
+  // Handle specific packet types
+  ULONG ulType;
+  INetDecompress::Integer(nmMessage, ulType);
+
+  // [Cecil] Handle multiple packets from one block
+  if (ulType == IExtPacketBatch::ulBatchType) {
+    FOREVER {
+      // No more packets
+      UBYTE ubNext = 0;
+      nmMessage.ReadBits(&ubNext, 1);
+      if (ubNext == 0) break;
+
+      INetDecompress::Integer(nmMessage, ulType);
+
+      // Can't read any further
+      if (!HandleClientExtPacket(nmMessage, ulType)) break;
+    }
+
+  } else {
+    HandleClientExtPacket(nmMessage, ulType);
+  }
+
+  // No extra processing needed
   return FALSE;
 
 #else
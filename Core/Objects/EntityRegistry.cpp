@@ -0,0 +1,277 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#include "EntityRegistry.h"
+
+// Base class names for each category
+static const char *_astrCategoryClasses[ECAT_MAX] = {
+  "Enemy Base",
+  "Enemy Spawner",
+  "NavigationMarker",
+  "ModelHolder2",
+  "SoundHolder",
+  "Trigger",
+};
+
+// Computed categories of an entity class
+struct SClassMask {
+  CEntityClass *pec;
+  CDLLEntityClass *pdec; // In case the class has been reloaded at the same address
+  ULONG ulMask;
+};
+
+// Fixed hash table of entity classes (there are never this many of them in one game)
+static const INDEX _ctClassMasks = 512;
+static SClassMask _aClassMasks[_ctClassMasks];
+
+// Entities of a specific world
+struct SWorldEntities {
+  CWorld *pwo; // NULL if unused
+  INDEX ctEntities; // Amount of entities that have been registered in total
+  ULONG ulNextID; // Next entity ID of the world after the last registered entity
+  CStaticStackArray<CEntity *> aLists[ECAT_MAX]; // Entities in each category
+};
+
+// Worlds that are tracked at the same time (game world, editor worlds and temporary ones)
+static const INDEX _ctWorlds = 8;
+static SWorldEntities _aWorlds[_ctWorlds];
+
+// Whether entities are being registered through hooks
+static BOOL _bActive = FALSE;
+
+// Determine categories of an entity class by going through its base classes
+static ULONG ComputeClassMask(CEntityClass *pec) {
+  ULONG ulMask = 0;
+
+  for (CDLLEntityClass *pdec = pec->ec_pdecDLLClass; pdec != NULL; pdec = pdec->dec_pdecBase) {
+    for (INDEX i = 0; i < ECAT_MAX; i++) {
+      if (strcmp(pdec->dec_strName, _astrCategoryClasses[i]) == 0) {
+        ulMask |= (1UL << i);
+      }
+    }
+  }
+
+  return ulMask;
+};
+
+// Find entities of a world and optionally start tracking a new one
+static SWorldEntities *FindWorld(CWorld *pwo, BOOL bAdd) {
+  SWorldEntities *pweFree = NULL;
+
+  for (INDEX i = 0; i < _ctWorlds; i++) {
+    SWorldEntities &we = _aWorlds[i];
+    if (we.pwo == pwo) return &we;
+
+    // Worlds without any entities are no longer in use
+    if (pweFree == NULL && (we.pwo == NULL || we.ctEntities <= 0)) {
+      pweFree = &we;
+    }
+  }
+
+  if (!bAdd || pweFree == NULL) return NULL;
+
+  pweFree->pwo = pwo;
+  pweFree->ctEntities = 0;
+  pweFree->ulNextID = pwo->wo_ulNextEntityID;
+
+  for (INDEX iList = 0; iList < ECAT_MAX; iList++) {
+    pweFree->aLists[iList].PopAll();
+  }
+
+  return pweFree;
+};
+
+// Register an entity in the lists of its world
+static void AddEntity(SWorldEntities &we, CEntity *pen) {
+  we.ctEntities++;
+  we.ulNextID = we.pwo->wo_ulNextEntityID;
+
+  const ULONG ulMask = IEntityRegistry::GetClassMask(pen->en_pecClass);
+  if (ulMask == 0) return;
+
+  for (INDEX i = 0; i < ECAT_MAX; i++) {
+    if (ulMask & (1UL << i)) {
+      we.aLists[i].Push() = pen;
+    }
+  }
+};
+
+// Sort entities by their IDs, so they are listed in the same order on every machine
+static void SortByID(CStaticStackArray<CEntity *> &aList) {
+  const INDEX ct = aList.Count();
+
+  // Entities are mostly registered in the order of their IDs already
+  for (INDEX i = 1; i < ct; i++) {
+    CEntity *pen = aList[i];
+    INDEX j = i - 1;
+
+    for (; j >= 0 && aList[j]->en_ulID > pen->en_ulID; j--) {
+      aList[j + 1] = aList[j];
+    }
+
+    aList[j + 1] = pen;
+  }
+};
+
+// Check if some entities have been created or destroyed without hooks (e.g. before tracking the world)
+static BOOL HasDrifted(const SWorldEntities &we) {
+  // Any entity creation takes a new ID from the world, even if another one has been destroyed in the meantime
+  return we.ctEntities != we.pwo->wo_cenEntities.Count() || we.ulNextID != we.pwo->wo_ulNextEntityID;
+};
+
+// Register all existing entities of a world anew
+static void RebuildWorld(SWorldEntities &we) {
+  we.ctEntities = 0;
+  we.ulNextID = we.pwo->wo_ulNextEntityID;
+
+  for (INDEX iList = 0; iList < ECAT_MAX; iList++) {
+    we.aLists[iList].PopAll();
+  }
+
+  FOREACHINDYNAMICCONTAINER(we.pwo->wo_cenEntities, CEntity, iten) {
+    AddEntity(we, iten);
+  }
+};
+
+namespace IEntityRegistry {
+
+// Get categories of an entity class as a bit mask (computed once per class)
+ULONG GetClassMask(CEntityClass *pec) {
+  if (pec == NULL) return 0;
+
+  const ULONG ulHash = ULONG(size_t(pec) >> 4) * 2654435761UL;
+
+  for (INDEX iProbe = 0; iProbe < _ctClassMasks; iProbe++) {
+    SClassMask &cm = _aClassMasks[(ulHash + iProbe) % _ctClassMasks];
+
+    if (cm.pec == pec && cm.pdec == pec->ec_pdecDLLClass) return cm.ulMask;
+
+    // Compute categories for a new class
+    if (cm.pec == NULL || cm.pec == pec) {
+      cm.pec = pec;
+      cm.pdec = pec->ec_pdecDLLClass;
+      cm.ulMask = ComputeClassMask(pec);
+      return cm.ulMask;
+    }
+  }
+
+  // No more space
+  return ComputeClassMask(pec);
+};
+
+// Add all existing entities of some category in a world to the container in the order of their IDs
+void GetEntities(CWorld *pwo, EEntityCategory eCategory, CDynamicContainer<CEntity> &cenEntities) {
+  SWorldEntities *pwe = (_bActive ? FindWorld(pwo, TRUE) : NULL);
+
+  // Go through all entities if the world can't be tracked
+  if (pwe == NULL) {
+    CStaticStackArray<CEntity *> aFound;
+
+    FOREACHINDYNAMICCONTAINER(pwo->wo_cenEntities, CEntity, iten) {
+      if (IsOfCategory(iten, eCategory)) {
+        aFound.Push() = iten;
+      }
+    }
+
+    // List them in the same order as tracked entities
+    SortByID(aFound);
+
+    for (INDEX i = 0; i < aFound.Count(); i++) {
+      cenEntities.Add(aFound[i]);
+    }
+    return;
+  }
+
+  if (HasDrifted(*pwe)) {
+    RebuildWorld(*pwe);
+  }
+
+  // IDs may be assigned after registering entities (e.g. when reading the world state)
+  CStaticStackArray<CEntity *> &aList = pwe->aLists[eCategory];
+  SortByID(aList);
+
+  const INDEX ct = aList.Count();
+
+  for (INDEX i = 0; i < ct; i++) {
+    CEntity *pen = aList[i];
+
+    if (!(pen->en_ulFlags & ENF_DELETED)) {
+      cenEntities.Add(pen);
+    }
+  }
+};
+
+// Start tracking entities through creation and destruction hooks
+void Activate(void) {
+  _bActive = TRUE;
+};
+
+// Register a newly created entity
+void OnCreate(CEntity *pen) {
+  SWorldEntities *pwe = FindWorld(pen->en_pwoWorld, TRUE);
+
+  if (pwe != NULL) {
+    AddEntity(*pwe, pen);
+  }
+};
+
+// Unregister an entity that's about to be destroyed
+void OnDestroy(CEntity *pen) {
+  SWorldEntities *pwe = FindWorld(pen->en_pwoWorld, FALSE);
+  if (pwe == NULL) return;
+
+  pwe->ctEntities--;
+
+  const ULONG ulMask = GetClassMask(pen->en_pecClass);
+  if (ulMask == 0) return;
+
+  // Remove the entity from each list while keeping the order of other entities
+  for (INDEX iList = 0; iList < ECAT_MAX; iList++) {
+    if (!(ulMask & (1UL << iList))) continue;
+
+    CStaticStackArray<CEntity *> &aList = pwe->aLists[iList];
+    const INDEX ct = aList.Count();
+
+    for (INDEX i = 0; i < ct; i++) {
+      if (aList[i] != pen) continue;
+
+      for (INDEX j = i + 1; j < ct; j++) {
+        aList[j - 1] = aList[j];
+      }
+
+      aList.Pop();
+      break;
+    }
+  }
+};
+
+// Forget all tracked worlds and class categories (entity classes may be reloaded afterwards)
+void Reset(void) {
+  for (INDEX i = 0; i < _ctWorlds; i++) {
+    SWorldEntities &we = _aWorlds[i];
+    we.pwo = NULL;
+    we.ctEntities = 0;
+
+    for (INDEX iList = 0; iList < ECAT_MAX; iList++) {
+      we.aLists[iList].PopAll();
+    }
+  }
+
+  memset(_aClassMasks, 0, sizeof(_aClassMasks));
+};
+
+}; // namespace
@@ -0,0 +1,63 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#ifndef CECIL_INCL_ENTITYREGISTRY_H
+#define CECIL_INCL_ENTITYREGISTRY_H
+
+#ifdef PRAGMA_ONCE
+  #pragma once
+#endif
+
+// Entity categories that are tracked in each world
+enum EEntityCategory {
+  ECAT_ENEMY,       // "Enemy Base" and derived classes
+  ECAT_SPAWNER,     // "Enemy Spawner" and derived classes
+  ECAT_NAVMARKER,   // "NavigationMarker" and derived classes
+  ECAT_MODELHOLDER, // "ModelHolder2" and derived classes
+  ECAT_SOUNDHOLDER, // "SoundHolder" and derived classes
+  ECAT_TRIGGER,     // "Trigger" and derived classes
+
+  ECAT_MAX,
+};
+
+// Lists of entities of specific classes for each world
+namespace IEntityRegistry {
+
+// Get categories of an entity class as a bit mask (computed once per class)
+CORE_API ULONG GetClassMask(CEntityClass *pec);
+
+// Check if an entity belongs to some category
+inline BOOL IsOfCategory(CEntity *pen, EEntityCategory eCategory) {
+  return (GetClassMask(pen->en_pecClass) & (1UL << eCategory)) != 0;
+};
+
+// Add all existing entities of some category in a world to the container in the order of their IDs
+CORE_API void GetEntities(CWorld *pwo, EEntityCategory eCategory, CDynamicContainer<CEntity> &cenEntities);
+
+// Start tracking entities through creation and destruction hooks
+void Activate(void);
+
+// Register a newly created entity
+void OnCreate(CEntity *pen);
+
+// Unregister an entity that's about to be destroyed
+void OnDestroy(CEntity *pen);
+
+// Forget all tracked worlds and class categories (entity classes may be reloaded afterwards)
+void Reset(void);
+
+}; // namespace
+
+#endif
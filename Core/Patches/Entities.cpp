@@ -23,6 +23,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 // Original function pointers
 void (CEntity::*pSendEvent)(const CEntityEvent &) = NULL;
+void (CEntity::*pDestroy)(void) = NULL;
+void (CEntity::*pWriteProperties)(CTStream &) = NULL;
 CEntityPatch::CReceiveItem pReceiveItem = NULL;
 CEntityPatch::CRenderGameView pRenderGameView = NULL;
 CEntityPatch::CGetForce pWorldBase_GetForce = NULL;
@@ -135,7 +137,13 @@ void CEntityPatch::P_ReadProperties(CTStream &istrm) {
           HANDLE_UNKNOWN(fnmDummy);
         } break;
 
+        // [Cecil] Resources are only loaded if there's anything to handle them
         case CEntityProperty::EPT_MODELOBJECT: {
+          if (pHandleUnknownProperty == NULL) {
+            IRes::Models::Skip_t(istrm);
+            break;
+          }
+
           CModelObject mo;
           IRes::Models::Read_t(istrm, mo);
           HANDLE_UNKNOWN(mo);
@@ -143,6 +151,11 @@ void CEntityPatch::P_ReadProperties(CTStream &istrm) {
 
       #if SE1_VER >= SE1_107
         case CEntityProperty::EPT_MODELINSTANCE: {
+          if (pHandleUnknownProperty == NULL) {
+            IRes::SKA::Skip_t(istrm);
+            break;
+          }
+
           CModelInstance mi;
           IRes::SKA::Read_t(istrm, mi);
           HANDLE_UNKNOWN(mi);
@@ -150,6 +163,11 @@ void CEntityPatch::P_ReadProperties(CTStream &istrm) {
       #endif
 
         case CEntityProperty::EPT_ANIMOBJECT: {
+          if (pHandleUnknownProperty == NULL) {
+            IRes::Anims::Skip_t(istrm);
+            break;
+          }
+
           CAnimObject ao;
           IRes::Anims::Read_t(istrm, ao);
           HANDLE_UNKNOWN(ao);
@@ -281,6 +299,117 @@ void CEntityPatch::P_ReadProperties(CTStream &istrm) {
       default: ASSERTALWAYS("Unknown property type");
     }
   }
+
+  #undef GET_PROP
+  #undef READ_PROP
+};
+
+// Write entity property values
+void CEntityPatch::P_WriteProperties(CTStream &ostrm) {
+  // Proceed to the original function unless resources should be skippable
+  if (!_EnginePatches._bSkippableResources) {
+    (this->*pWriteProperties)(ostrm);
+    return;
+  }
+
+  // Helper macros
+  #define GET_PROP(_Type) ENTITYPROPERTY(this, epProp.ep_slOffset, _Type)
+  #define WRITE_PROP(_Type) ostrm.Write_t(&GET_PROP(_Type), sizeof(_Type))
+
+  // Count properties in the class hierarchy
+  INDEX ctProperties = 0;
+  CDLLEntityClass *pdec;
+
+  for (pdec = en_pecClass->ec_pdecDLLClass; pdec != NULL; pdec = pdec->dec_pdecBase) {
+    ctProperties += pdec->dec_ctProperties;
+  }
+
+  ostrm.WriteID_t("PRPS"); // Properties
+  ostrm << ctProperties;
+
+  for (pdec = en_pecClass->ec_pdecDLLClass; pdec != NULL; pdec = pdec->dec_pdecBase) {
+    for (INDEX iProp = 0; iProp < pdec->dec_ctProperties; iProp++) {
+      CEntityProperty &epProp = pdec->dec_aepProperties[iProp];
+
+      // Pack property ID and property type
+      const ULONG ulID = (epProp.ep_ulID << 8) | (ULONG(epProp.ep_eptType) & 0xFF);
+      ostrm << ulID;
+
+      switch (epProp.ep_eptType)
+      {
+        // 32-bit long numerical values
+        case CEntityProperty::EPT_ENUM: case CEntityProperty::EPT_BOOL:
+        case CEntityProperty::EPT_COLOR: case CEntityProperty::EPT_FLAGS:
+        case CEntityProperty::EPT_INDEX: case CEntityProperty::EPT_FLOAT:
+        case CEntityProperty::EPT_RANGE: case CEntityProperty::EPT_ANGLE:
+        case CEntityProperty::EPT_ANIMATION: case CEntityProperty::EPT_ILLUMINATIONTYPE: {
+          ostrm << GET_PROP(INDEX);
+        } break;
+
+        // [Cecil] Rev: 64-bit integer (EPT_U64)
+        case 28: {
+          ostrm.Write_t(&GET_PROP(__int64), sizeof(__int64));
+        } break;
+
+        // [Cecil] Rev: DOUBLE written as FLOAT (EPT_DOUBLE)
+        case 29: {
+          ostrm << (FLOAT)GET_PROP(DOUBLE);
+        } break;
+
+        // Entity pointer
+        case CEntityProperty::EPT_ENTITYPTR: {
+          WriteEntityPointer_t(&ostrm, GET_PROP(CEntityPointer));
+        } break;
+
+        // Translatable and normal strings
+        case CEntityProperty::EPT_STRINGTRANS:
+          // [Cecil] "DTRS" in the DLL as is gets picked up by the Depend utility
+          ostrm.WriteID_t((CTString("DT") + "RS").str_String);
+        case CEntityProperty::EPT_FILENAMENODEP:
+        case CEntityProperty::EPT_STRING: {
+          ostrm << GET_PROP(CTString);
+        } break;
+
+        // Resources
+        case CEntityProperty::EPT_FILENAME: {
+          ostrm << GET_PROP(CTFileName);
+        } break;
+
+        // [Cecil] Prefix resource objects with their length, so they can be skipped without loading them
+        case CEntityProperty::EPT_MODELOBJECT: {
+          IRes::Models::Write_t(ostrm, GET_PROP(CModelObject), TRUE);
+        } break;
+
+      #if SE1_VER >= SE1_107
+        case CEntityProperty::EPT_MODELINSTANCE: {
+          IRes::SKA::Write_t(ostrm, GET_PROP(CModelInstance), TRUE);
+        } break;
+      #endif
+
+        case CEntityProperty::EPT_ANIMOBJECT: {
+          IRes::Anims::Write_t(ostrm, GET_PROP(CAnimObject), TRUE);
+        } break;
+
+        case CEntityProperty::EPT_SOUNDOBJECT: {
+          GET_PROP(CSoundObject).Write_t(&ostrm);
+        } break;
+
+        // 3D environment
+        case CEntityProperty::EPT_FLOAT3D:       WRITE_PROP(FLOAT3D); break;
+        case CEntityProperty::EPT_ANGLE3D:       WRITE_PROP(ANGLE3D); break;
+        case CEntityProperty::EPT_PLACEMENT3D:   WRITE_PROP(CPlacement3D); break;
+        case CEntityProperty::EPT_FLOATAABBOX3D: WRITE_PROP(FLOATaabbox3D); break;
+        case CEntityProperty::EPT_FLOATplane3D:  WRITE_PROP(FLOATplane3D); break;
+        case CEntityProperty::EPT_FLOATQUAT3D:   WRITE_PROP(FLOATquat3D); break;
+        case CEntityProperty::EPT_FLOATMATRIX3D: WRITE_PROP(FLOATmatrix3D); break;
+
+        default: ASSERTALWAYS("Unknown property type");
+      }
+    }
+  }
+
+  #undef GET_PROP
+  #undef WRITE_PROP
 };
 
 // Send an event to this entity
@@ -297,6 +426,22 @@ void CEntityPatch::P_SendEvent(const CEntityEvent &ee)
   (this->*pSendEvent)(ee);
 };
 
+#if _PATCHCONFIG_ENTITY_REGISTRY
+
+// Destroy this entity
+void CEntityPatch::P_Destroy(void)
+{
+  // [Cecil] Unregister the entity before it can be released
+  if (!(en_ulFlags & ENF_DELETED)) {
+    IEntityRegistry::OnDestroy(this);
+  }
+
+  // Proceed to the original function
+  (this->*pDestroy)();
+};
+
+#endif // _PATCHCONFIG_ENTITY_REGISTRY
+
 // Receive item by a player entity
 BOOL CEntityPatch::P_ReceiveItem(const CEntityEvent &ee)
 {
@@ -37,9 +37,17 @@ class CEntityPatch : public CEntity {
     // Read entity property values
     void P_ReadProperties(CTStream &istrm);
 
+    // Write entity property values
+    void P_WriteProperties(CTStream &ostrm);
+
     // Send an event to this entity
     void P_SendEvent(const CEntityEvent &ee);
 
+  #if _PATCHCONFIG_ENTITY_REGISTRY
+    // Destroy this entity
+    void P_Destroy(void);
+  #endif
+
     // Receive item by a player entity
     BOOL P_ReceiveItem(const CEntityEvent &ee);
 
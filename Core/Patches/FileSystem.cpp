@@ -435,7 +435,44 @@ static inline BOOL CheckFileAt(const CTString &strBaseDir, const CTFileName &fnm
   return IFiles::IsReadable(fnmExpanded);
 };
 
+// [Cecil] Time spent on resolving paths for reading
+static CTimerValue _tvPathResolution(0.0f);
+static INDEX _ctPathResolutions = 0;
+
+// [Cecil] Measure path resolution time within the current scope
+class CPathResolutionTimer {
+  private:
+    CTimerValue prt_tvStart;
+
+  public:
+    CPathResolutionTimer() : prt_tvStart(_pTimer->GetHighPrecisionTimer()) {
+      _ctPathResolutions++;
+    };
+
+    ~CPathResolutionTimer() {
+      _tvPathResolution += _pTimer->GetHighPrecisionTimer() - prt_tvStart;
+    };
+};
+
+// [Cecil] Print out time spent on resolving paths for reading
+void ReportPathResolution(void) {
+  const DOUBLE dTotal = _tvPathResolution.GetSeconds() * 1000.0;
+  const DOUBLE dAverage = (_ctPathResolutions != 0) ? dTotal / _ctPathResolutions : 0.0;
+
+  CPrintF(TRANS("Path resolution (%s lookup):\n"), fil_bHashedZipLookup ? "hashed" : "linear");
+  CPrintF(TRANS("  %d files in archives\n"), IUnzip::GetFileCount());
+  CPrintF(TRANS("  %d paths resolved in %.3f ms (%.4f ms per path)\n"), _ctPathResolutions, dTotal, dAverage);
+};
+
+// [Cecil] Reset path resolution statistics
+void ResetPathResolution(void) {
+  _tvPathResolution = CTimerValue(0.0f);
+  _ctPathResolutions = 0;
+};
+
 static INDEX ExpandPathForReading(ULONG ulType, const CTFileName &fnmFile, CTFileName &fnmExpanded) {
+  CPathResolutionTimer prt;
+
   // Search for the file in archives
   const INDEX iFileInZip = IUnzip::GetFileIndex(fnmFile);
   const BOOL bFoundInZip = (iFileInZip >= 0);
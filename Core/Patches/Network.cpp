@@ -21,6 +21,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <Core/Query/QueryManager.h>
 #include <Core/Networking/NetworkFunctions.h>
+#include <Core/Networking/ExtPackets.h>
 
 #if _PATCHCONFIG_EXTEND_NETWORK
 
@@ -174,8 +175,18 @@ BOOL CMessageDisPatch::P_ReceiveFromClient(INDEX iClient, CNetworkMessage &nmMes
   return FALSE;
 };
 
+#if _PATCHCONFIG_EXT_PACKETS
+// Write values received through the game stream after the session state (for joining clients)
+static BOOL _bSerializeStreamState = FALSE;
+#endif
+
 // Server receives a reliable packet
 BOOL CMessageDisPatch::P_ReceiveFromClientReliable(INDEX iClient, CNetworkMessage &nmMessage) {
+#if _PATCHCONFIG_EXT_PACKETS
+  // [Cecil] Previous message has already been handled by the engine
+  _bSerializeStreamState = FALSE;
+#endif
+
   FOREVER {
     // Process reliable message
     if (ReceiveFromClientSpecific(iClient, nmMessage, &CCommunicationInterface::Server_Receive_Reliable)) {
@@ -184,7 +195,13 @@ BOOL CMessageDisPatch::P_ReceiveFromClientReliable(INDEX iClient, CNetworkMessag
       BOOL bPass = INetwork::ServerHandle(this, iClient, nmMessage);
 
       // Exit to process through engine's CServer::Handle()
-      if (bPass) return TRUE;
+      if (bPass) {
+      #if _PATCHCONFIG_EXT_PACKETS
+        // [Cecil] Session state is about to be sent to a client that can read extra data after it
+        _bSerializeStreamState = (nmMessage.GetType() == MSG_REQ_STATEDELTA && IProcessPacket::HasSamePatch(iClient));
+      #endif
+        return TRUE;
+      }
 
     // Proceed to unreliable messages
     } else {
@@ -348,6 +365,13 @@ void CNetworkPatch::P_StartDemoRec(const CTFileName &fnDemo) {
   ga_strmDemoRec.WriteID_t("DEMO");
   ga_strmDemoRec.WriteID_t("MVER");
   ga_strmDemoRec << ULONG(_SE_BUILD_MINOR);
+
+#if _PATCHCONFIG_EXT_PACKETS
+  // [Cecil] Write values and remembered resource paths that have been received through the game stream,
+  // so the demo can read differences and indexed paths from them right away
+  _bSerializeStreamState = TRUE;
+#endif
+
   ga_sesSessionState.Write_t(&ga_strmDemoRec);
 
   // Set demo recording state
@@ -564,6 +588,13 @@ void CSessionStatePatch::P_ProcessGameStreamBlock(CNetworkMessage &nmMessage) {
 
       // Process the tick
       ProcessGameTick(nmMessage, tmPacket);
+
+    #if _PATCHCONFIG_EXT_PACKETS
+      // [Cecil] Send extension packets that have been queued during this tick right after it
+      if (_pNetwork->IsServer()) {
+        IExtPacketBatch::Flush();
+      }
+    #endif
     } break;
 
     // Pause message
@@ -793,6 +824,13 @@ void CSessionStatePatch::P_Read(CTStream *pstr) {
   }
 
   _bSerializeServerInfo = FALSE;
+
+#if _PATCHCONFIG_EXT_PACKETS
+  // [Cecil] Read values that have been received through the game stream before joining, if there are any
+  if (!_pNetwork->IsServer()) {
+    IExtPacketStream::ReadState(*pstr);
+  }
+#endif
 };
 
 // Write session state
@@ -806,10 +844,173 @@ void CSessionStatePatch::P_Write(CTStream *pstr) {
   }
 
   _bSerializeServerInfo = FALSE;
+
+#if _PATCHCONFIG_EXT_PACKETS
+  // [Cecil] Write values that have been received through the game stream for the joining client,
+  // so it can read differences from them right away
+  if (_bSerializeStreamState) {
+    IExtPacketStream::WriteState(*pstr);
+  }
+
+  _bSerializeStreamState = FALSE;
+#endif
 };
 
 #if _PATCHCONFIG_GUID_MASKING
 
+// Place in the world checksum where a player entity adds its GUID
+struct SSyncPlayerPoint {
+  ULONG ulSegment; // Checksum of the shared part before this point, starting from zero
+  ULONG ulShift;   // Shift of the preceding checksum over the same part
+  CPlayerEntity *pen;
+  CPlayerBuffer *pplb;
+};
+
+// Player points of the current shared world checksum
+static CStaticStackArray<SSyncPlayerPoint> _aSyncPoints;
+static INDEX _iSyncPoint = 0;
+static BOOL _bSyncShiftPass = FALSE;
+static BOOL _bSyncPointsValid = TRUE;
+
+// CRC polynomial taken from the engine table (0 if the table can't be used for combining)
+static ULONG _ulSyncPoly = 0;
+
+// Zero checksum value and a checksum that represents the identity when shifting
+static const ULONG _ulSyncZero = 0x00000000;
+static const ULONG _ulSyncOne  = 0x80000000;
+
+// Multiply two reflected CRC values modulo the polynomial
+static ULONG SyncMultiply(ULONG ulA, ULONG ulB) {
+  ULONG ulResult = 0;
+
+  for (ULONG ulMask = _ulSyncOne; ulMask != 0; ulMask >>= 1) {
+    if (ulA & ulMask) {
+      ulResult ^= ulB;
+    }
+
+    ulB = (ulB & 1) ? (ulB >> 1) ^ _ulSyncPoly : (ulB >> 1);
+  }
+
+  return ulResult;
+};
+
+// Check if the engine checksum can be split into parts and combined back
+static BOOL CanCombineSyncChecksums(void) {
+  static BOOL bChecked = FALSE;
+
+  if (!bChecked) {
+    bChecked = TRUE;
+
+    // Reflected table always has the polynomial in the middle
+    _ulSyncPoly = crc_aulCRCTable[128];
+
+    // Adding a zero byte must be the same as multiplying by x^8
+    const ULONG aulTest[4] = { 0xFFFFFFFF, 0x12345678, 0x80000000, 0x00000001 };
+
+    for (INDEX i = 0; i < 4; i++) {
+      ULONG ulByte = aulTest[i];
+      CRC_AddByte(ulByte, 0);
+
+      if (ulByte != SyncMultiply(aulTest[i], _ulSyncOne >> 8)) {
+        _ulSyncPoly = 0;
+        break;
+      }
+    }
+  }
+
+  return (_ulSyncPoly != 0);
+};
+
+// Add GUID and appearance of some player to the checksum for a specific client
+static void AddPlayerToChecksum(ULONG &ulCRC, CPlayerEntity *pen, CPlayerBuffer *pplb, INDEX iClient) {
+  UBYTE aubGUID[16];
+
+  // Use GUID from the buffer for the current client
+  if (iClient == pplb->plb_iClient) {
+    memcpy(aubGUID, pplb->plb_pcCharacter.pc_aubGUID, sizeof(aubGUID));
+
+  } else {
+    IProcessPacket::MaskGUID(aubGUID, *pplb);
+  }
+
+  CRC_AddBlock(ulCRC, aubGUID, sizeof(aubGUID));
+  CRC_AddBlock(ulCRC, pen->en_pcCharacter.pc_aubAppearance, sizeof(pen->en_pcCharacter.pc_aubAppearance));
+};
+
+// Finish the shared part before the next player point or the end of the world checksum
+static void EndSyncSegment(ULONG &ulCRC, CPlayerEntity *pen, CPlayerBuffer *pplb) {
+  // First pass records the parts starting from zero
+  if (!_bSyncShiftPass) {
+    SSyncPlayerPoint &pt = _aSyncPoints.Push();
+    pt.ulSegment = ulCRC;
+    pt.ulShift = 0;
+    pt.pen = pen;
+    pt.pplb = pplb;
+
+    ulCRC = _ulSyncZero;
+    return;
+  }
+
+  // Second pass starts from one, which leaves only the shift after removing the zero part
+  if (_iSyncPoint < _aSyncPoints.Count() && _aSyncPoints[_iSyncPoint].pen == pen) {
+    SSyncPlayerPoint &pt = _aSyncPoints[_iSyncPoint];
+    pt.ulShift = ulCRC ^ pt.ulSegment;
+
+  } else {
+    _bSyncPointsValid = FALSE;
+  }
+
+  _iSyncPoint++;
+  ulCRC = _ulSyncOne;
+};
+
+// Calculate shared parts of the world checksum between all player points
+static BOOL CalculateSharedChecksum(CSessionState *pses) {
+  IProcessPacket::_iHandlingClient = IProcessPacket::CLT_SYNC;
+
+  _aSyncPoints.PopAll();
+  _iSyncPoint = 0;
+  _bSyncPointsValid = TRUE;
+
+  // Parts starting from zero
+  ULONG ulCRC = _ulSyncZero;
+  _bSyncShiftPass = FALSE;
+
+  pses->ChecksumForSync(ulCRC, pses->ses_iExtensiveSyncCheck);
+  EndSyncSegment(ulCRC, NULL, NULL);
+
+  // Same parts starting from one
+  ulCRC = _ulSyncOne;
+  _bSyncShiftPass = TRUE;
+
+  pses->ChecksumForSync(ulCRC, pses->ses_iExtensiveSyncCheck);
+  EndSyncSegment(ulCRC, NULL, NULL);
+
+  _bSyncShiftPass = FALSE;
+  return _bSyncPointsValid && _iSyncPoint == _aSyncPoints.Count();
+};
+
+// Combine shared parts of the world checksum with player GUIDs for a specific client
+static ULONG CombineSyncChecksum(INDEX iClient) {
+  ULONG ulCRC;
+  CRC_Start(ulCRC);
+
+  const INDEX ctPoints = _aSyncPoints.Count();
+
+  for (INDEX i = 0; i < ctPoints; i++) {
+    const SSyncPlayerPoint &pt = _aSyncPoints[i];
+    ulCRC = SyncMultiply(ulCRC, pt.ulShift) ^ pt.ulSegment;
+
+    // Last point is the end of the world checksum
+    if (pt.pen != NULL) {
+      AddPlayerToChecksum(ulCRC, pt.pen, pt.pplb, iClient);
+    }
+  }
+
+  CRC_Finish(ulCRC);
+  return ulCRC;
+};
+
 // Send synchronization packet to the server (as client) or add it to the buffer (as server)
 void CSessionStatePatch::P_MakeSynchronisationCheck(void) {
   if (!IsCommInitialized()) return;
@@ -828,6 +1029,21 @@ void CSessionStatePatch::P_MakeSynchronisationCheck(void) {
   if (IProcessPacket::ShouldMaskGUIDs()) {
     CServer &srv = _pNetwork->ga_srvServer;
 
+    INDEX ctSessions = 0;
+
+    for (INDEX iCount = 0; iCount < srv.srv_assoSessions.Count(); iCount++) {
+      if (iCount == 0 || srv.srv_assoSessions[iCount].sso_bActive) {
+        ctSessions++;
+      }
+    }
+
+    // Shared checksum takes two passes over the world, so it only pays off with more sessions
+    BOOL bShared = (ctSessions > 2 && CanCombineSyncChecksums());
+
+    if (bShared) {
+      bShared = CalculateSharedChecksum(this);
+    }
+
     // Make local checksum for each session separately
     for (INDEX iSession = 0; iSession < srv.srv_assoSessions.Count(); iSession++) {
       CSessionSocket &sso = srv.srv_assoSessions[iSession];
@@ -836,11 +1052,17 @@ void CSessionStatePatch::P_MakeSynchronisationCheck(void) {
         continue;
       }
 
-      IProcessPacket::_iHandlingClient = iSession;
+      // Combine shared world checksum with player GUIDs for this client
+      if (bShared) {
+        ulLocalCRC = CombineSyncChecksum(iSession);
 
-      CRC_Start(ulLocalCRC);
-      ChecksumForSync(ulLocalCRC, ses_iExtensiveSyncCheck);
-      CRC_Finish(ulLocalCRC);
+      } else {
+        IProcessPacket::_iHandlingClient = iSession;
+
+        CRC_Start(ulLocalCRC);
+        ChecksumForSync(ulLocalCRC, ses_iExtensiveSyncCheck);
+        CRC_Finish(ulLocalCRC);
+      }
 
       // Create sync check
       CSyncCheck sc;
@@ -955,18 +1177,13 @@ void CPlayerEntityPatch::P_ChecksumForSync(ULONG &ulCRC, INDEX iExtensiveSyncChe
   // Get player buffer for this entity
   CPlayerBuffer *pplb = PlayerBufferFromEntity(this);
 
-  UBYTE aubGUID[16];
-
-  // Use GUID from the buffer for the current client
-  if (iClient == pplb->plb_iClient) {
-    memcpy(aubGUID, pplb->plb_pcCharacter.pc_aubGUID, sizeof(aubGUID));
-
-  } else {
-    IProcessPacket::MaskGUID(aubGUID, *pplb);
+  // Split the shared world checksum at this player
+  if (iClient == IProcessPacket::CLT_SYNC) {
+    EndSyncSegment(ulCRC, this, pplb);
+    return;
   }
 
-  CRC_AddBlock(ulCRC, aubGUID, sizeof(aubGUID));
-  CRC_AddBlock(ulCRC, en_pcCharacter.pc_aubAppearance, sizeof(en_pcCharacter.pc_aubAppearance));
+  AddPlayerToChecksum(ulCRC, this, pplb, iClient);
 };
 
 #endif // _PATCHCONFIG_GUID_MASKING
@@ -43,13 +43,160 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // Enough memory for writing (128 MB)
 static const ULONG _ulMaxWriteMemory = (1 << 20) * 128;
 
+// [Cecil] Buffers of this size and above are allocated directly from virtual memory (1 MB)
+static const ULONG _ulVirtualMemoryThreshold = (1 << 20);
+
+// [Cecil] Write buffers only reserve address space and pages are committed in chunks of this size as they grow
+static const ULONG _ulCommitChunk = (1 << 10) * 256;
+
+// [Cecil] Size of a reserved write buffer with the padding
+static const ULONG _ulReservedSize = (_ulMaxWriteMemory / 64 + 2) * 64;
+
+// [Cecil] Reserved write buffers
+struct SReservedBuffer {
+  UBYTE *pubBegin; // NULL if unused
+  UBYTE *pubEnd;
+  UBYTE *pubCommitted; // End of the committed memory
+};
+
+static const INDEX _ctReservedBuffers = 64;
+static SReservedBuffer _aReservedBuffers[_ctReservedBuffers];
+
+static CRITICAL_SECTION _csReservedBuffers;
+static BOOL _bReservedBuffers = FALSE;
+
+// [Cecil] Write buffers can only be reserved if writing into streams and moving in them has been patched
+// to commit more memory, otherwise all of it is committed right away
+BOOL _bCommitStreamsOnWrite = FALSE;
+
+// [Cecil] Original function pointers
+void (CTStream::*pStreamWrite)(const void *, SLONG) = NULL;
+void (CTStream::*pStreamSetPos)(SLONG) = NULL;
+void (CTStream::*pStreamSeek)(SLONG, CTStream::SeekDir) = NULL;
+
+// [Cecil] Find a reserved buffer by its beginning
+// NOTE: Doesn't need to be locked if looking for a buffer of a living stream, since only that stream can change it
+static SReservedBuffer *FindReservedBuffer(const UBYTE *pubBegin) {
+  for (INDEX i = 0; i < _ctReservedBuffers; i++) {
+    SReservedBuffer &rb = _aReservedBuffers[i];
+
+    if (rb.pubBegin == pubBegin) return &rb;
+  }
+
+  return NULL;
+};
+
+// [Cecil] Reserve a write buffer without committing any memory
+static UBYTE *ReserveBuffer(ULONG ulSize) {
+  // Commit everything if the buffer cannot grow on demand
+  if (!_bCommitStreamsOnWrite) {
+    return (UBYTE *)VirtualAlloc(NULL, ulSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+  }
+
+  if (!_bReservedBuffers) {
+    InitializeCriticalSection(&_csReservedBuffers);
+    _bReservedBuffers = TRUE;
+  }
+
+  UBYTE *pub = (UBYTE *)VirtualAlloc(NULL, ulSize, MEM_RESERVE, PAGE_READWRITE);
+  if (pub == NULL) return NULL;
+
+  EnterCriticalSection(&_csReservedBuffers);
+
+  SReservedBuffer *prbFree = FindReservedBuffer(NULL);
+
+  if (prbFree != NULL) {
+    prbFree->pubEnd = pub + ulSize;
+    prbFree->pubCommitted = pub;
+    prbFree->pubBegin = pub;
+  }
+
+  LeaveCriticalSection(&_csReservedBuffers);
+
+  // Too many buffers at once, so commit all the memory right away
+  if (prbFree == NULL) {
+    VirtualAlloc(pub, ulSize, MEM_COMMIT, PAGE_READWRITE);
+  }
+
+  return pub;
+};
+
+// [Cecil] Stop tracking a reserved buffer (returns FALSE if it isn't reserved)
+static BOOL ReleaseBuffer(UBYTE *pub) {
+  if (!_bReservedBuffers) return FALSE;
+
+  EnterCriticalSection(&_csReservedBuffers);
+
+  SReservedBuffer *prb = FindReservedBuffer(pub);
+
+  if (prb != NULL) {
+    prb->pubBegin = NULL;
+    prb->pubEnd = NULL;
+    prb->pubCommitted = NULL;
+  }
+
+  LeaveCriticalSection(&_csReservedBuffers);
+  return (prb != NULL);
+};
+
+// [Cecil] Make sure that the buffer is committed up to some point
+void CUnpageStreamPatch::CommitUntil(const UBYTE *pubUntil) {
+  // Only write buffers are reserved
+  if (!_bReservedBuffers || ULONG(strm_pubBufferEnd - strm_pubBufferBegin) != _ulReservedSize) return;
+
+  SReservedBuffer *prb = FindReservedBuffer(strm_pubBufferBegin);
+  if (prb == NULL || pubUntil <= prb->pubCommitted) return;
+
+  // Commit whole chunks from the current end of the committed memory
+  const size_t iSize = (pubUntil - prb->pubBegin + _ulCommitChunk - 1) / _ulCommitChunk * _ulCommitChunk;
+  UBYTE *pubCommit = Min(prb->pubBegin + iSize, prb->pubEnd);
+
+  if (VirtualAlloc(prb->pubCommitted, pubCommit - prb->pubCommitted, MEM_COMMIT, PAGE_READWRITE) == NULL) {
+    ThrowF_t(TRANS("Cannot allocate %u bytes for the stream!"), ULONG(pubCommit - prb->pubBegin));
+  }
+
+  prb->pubCommitted = pubCommit;
+};
+
+// [Cecil] Write a block of data into the stream
+void CUnpageStreamPatch::P_Write(const void *pvBuffer, SLONG slSize) {
+  CommitUntil(strm_pubCurrentPos + slSize);
+  (this->*pStreamWrite)(pvBuffer, slSize);
+};
+
+// [Cecil] Set absolute position in the stream
+void CUnpageStreamPatch::P_SetPos(SLONG slPosition) {
+  CommitUntil(strm_pubBufferBegin + slPosition);
+  (this->*pStreamSetPos)(slPosition);
+};
+
+// [Cecil] Seek in the stream
+void CUnpageStreamPatch::P_Seek(SLONG slOffset, CTStream::SeekDir sd) {
+  (this->*pStreamSeek)(slOffset, sd);
+  CommitUntil(strm_pubCurrentPos);
+};
+
 // Allocate memory normally
 void CUnpageStreamPatch::P_AllocVirtualMemory(ULONG ulBytesToAllocate)
 {
   // Allocate at least 128 bytes and align them to blocks of 64
   ULONG ulAlloc = (ulBytesToAllocate / 64 + 2) * 64;
 
-  strm_pubBufferBegin = (UBYTE *)calloc(ulAlloc, 1);
+  // [Cecil] Write buffers are committed on demand
+  if (ulBytesToAllocate == _ulMaxWriteMemory) {
+    strm_pubBufferBegin = ReserveBuffer(ulAlloc);
+
+  } else if (ulAlloc >= _ulVirtualMemoryThreshold) {
+    strm_pubBufferBegin = (UBYTE *)VirtualAlloc(NULL, ulAlloc, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+  } else {
+    strm_pubBufferBegin = (UBYTE *)calloc(ulAlloc, 1);
+  }
+
+  if (strm_pubBufferBegin == NULL) {
+    FatalError(TRANS("Cannot allocate %u bytes for the stream!"), ulAlloc);
+  }
+
   strm_pubBufferEnd = strm_pubBufferBegin + ulAlloc;
 
   strm_pubCurrentPos = strm_pubBufferBegin;
@@ -62,7 +209,14 @@ void CUnpageStreamPatch::P_AllocVirtualMemory(ULONG ulBytesToAllocate)
 void CUnpageStreamPatch::P_FreeBuffer(void)
 {
   if (strm_pubBufferBegin != NULL) {
-    free(strm_pubBufferBegin);
+    // [Cecil] Determine how the buffer has been allocated from its reservation or size
+    const ULONG ulAlloc = ULONG(strm_pubBufferEnd - strm_pubBufferBegin);
+
+    if (ReleaseBuffer(strm_pubBufferBegin) || ulAlloc >= _ulVirtualMemoryThreshold) {
+      VirtualFree(strm_pubBufferBegin, 0, MEM_RELEASE);
+    } else {
+      free(strm_pubBufferBegin);
+    }
 
     strm_pubBufferBegin = NULL;
     strm_pubBufferEnd   = NULL;
@@ -133,10 +287,30 @@ void CFileStreamPatch::P_Open(const CTFileName &fnFileName, CTStream::OpenMode o
       // Allocate as much memory as the decompressed file size
       const SLONG slFileSize = IUnzip::GetSize(fstrm_iZipHandle);
 
-      P_AllocVirtualMemory(slFileSize);
+      // [Cecil] Read big stored files directly from the mapped archive without copying them
+      // NOTE: Small files are still copied into their own buffers because those have zeroed padding past the end
+      // of the data, which text parsing may rely on, while the mapping continues with the next archive entry
+      const UBYTE *pubMapped = NULL;
 
-      // Read file contents into the stream
-      IUnzip::ReadBlock_t(fstrm_iZipHandle, strm_pubBufferBegin, 0, slFileSize);
+      if (ULONG(slFileSize) >= _ulVirtualMemoryThreshold) {
+        pubMapped = IUnzip::GetMappedData(fstrm_iZipHandle);
+      }
+
+      if (pubMapped != NULL) {
+        strm_pubBufferBegin = (UBYTE *)pubMapped;
+        strm_pubBufferEnd = strm_pubBufferBegin + slFileSize;
+
+        strm_pubCurrentPos = strm_pubBufferBegin;
+        strm_pubMaxPos = strm_pubBufferBegin;
+        strm_pubEOF = strm_pubBufferEnd;
+
+      } else {
+        P_AllocVirtualMemory(slFileSize);
+        CommitUntil(strm_pubBufferBegin + slFileSize); // [Cecil] In case it matches the write buffer size
+
+        // Read file contents into the stream
+        IUnzip::ReadBlock_t(fstrm_iZipHandle, strm_pubBufferBegin, 0, slFileSize);
+      }
 
     } else if (iFile == EFP_FILE) {
       // Open file for reading
@@ -148,6 +322,7 @@ void CFileStreamPatch::P_Open(const CTFileName &fnFileName, CTStream::OpenMode o
       fseek(fstrm_pFile, 0, SEEK_SET);
 
       P_AllocVirtualMemory(slFileSize);
+      CommitUntil(strm_pubBufferBegin + slFileSize); // [Cecil] In case it matches the write buffer size
 
       // Read file contents into the stream
       fread(strm_pubBufferBegin, slFileSize, 1, fstrm_pFile);
@@ -199,6 +374,15 @@ void CFileStreamPatch::P_Close(void)
     fstrm_pFile = NULL;
 
   } else if (fstrm_iZipHandle >= 0) {
+    // [Cecil] Buffer in the mapped archive isn't owned by the stream
+    if (strm_pubBufferBegin != NULL && strm_pubBufferBegin == IUnzip::GetMappedData(fstrm_iZipHandle)) {
+      strm_pubBufferBegin = NULL;
+      strm_pubBufferEnd   = NULL;
+      strm_pubCurrentPos  = NULL;
+      strm_pubEOF         = NULL;
+      strm_pubMaxPos      = NULL;
+    }
+
     IUnzip::Close(fstrm_iZipHandle);
 
     fstrm_iZipHandle = -1;
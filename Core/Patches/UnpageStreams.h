@@ -32,6 +32,18 @@ class CUnpageStreamPatch : public CTStream {
 
     // Free memory normally
     void P_FreeBuffer(void);
+
+    // Make sure that the buffer is committed up to some point
+    void CommitUntil(const UBYTE *pubUntil);
+
+    // Write a block of data into the stream
+    void P_Write(const void *pvBuffer, SLONG slSize);
+
+    // Set absolute position in the stream
+    void P_SetPos(SLONG slPosition);
+
+    // Seek in the stream
+    void P_Seek(SLONG slOffset, CTStream::SeekDir sd);
 };
 
 // CTFileStream patches
@@ -253,4 +253,22 @@ CEntity *CWorldPatch::P_CreateEntity(const CPlacement3D &plPlacement, const CTFi
   return penNew;
 };
 
+#if _PATCHCONFIG_EXTEND_ENTITIES && _PATCHCONFIG_ENTITY_REGISTRY
+
+// Original function pointer
+CEntity *(CWorld::*pCreateEntityOfClass)(const CPlacement3D &, CEntityClass *) = NULL;
+
+// Create a new entity from an obtained class
+CEntity *CWorldPatch::P_CreateEntityOfClass(const CPlacement3D &plPlacement, CEntityClass *pecClass) {
+  // Proceed to the original function
+  CEntity *penNew = (this->*pCreateEntityOfClass)(plPlacement, pecClass);
+
+  // [Cecil] Register the entity in its world
+  IEntityRegistry::OnCreate(penNew);
+
+  return penNew;
+};
+
+#endif // _PATCHCONFIG_ENTITY_REGISTRY
+
 #endif // _PATCHCONFIG_ENGINEPATCHES
@@ -35,6 +35,11 @@ class CWorldPatch : public CWorld {
 
     // Create a new entity of a given class
     CEntity *P_CreateEntity(const CPlacement3D &plPlacement, const CTFileName &fnmClass);
+
+  #if _PATCHCONFIG_EXTEND_ENTITIES && _PATCHCONFIG_ENTITY_REGISTRY
+    // Create a new entity from an obtained class
+    CEntity *P_CreateEntityOfClass(const CPlacement3D &plPlacement, CEntityClass *pecClass);
+  #endif
 };
 
 #endif // _PATCHCONFIG_ENGINEPATCHES
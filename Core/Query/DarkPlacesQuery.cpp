@@ -230,12 +230,19 @@ static void ClientParsePacket(INDEX iLength) {
   }
 };
 
-// Compose status response packet
-static void ComposeStatusPacket(CTString &strPacket, const char *strChallenge, BOOL bFullStatus) {
+// [Cecil] Cached status responses without a challenge
+static IQuery::SReplyCache _rcInfo;
+static IQuery::SReplyCache _rcStatus;
+
+// [Cecil] Compose status response packet without a challenge
+static void ComposeStatusBody(IQuery::SReplyCache &rc, BOOL bFullStatus) {
+  IQuery::BeginReply(rc);
+
   const INDEX ctMaxPlayers = _pNetwork->ga_sesSessionState.ses_ctMaxPlayers;
   const INDEX ctClients = INetwork::CountClients(FALSE);
 
   // Compose the packet
+  CTString strPacket;
   strPacket.PrintF("\xFF\xFF\xFF\xFF%s\x0A"
     "\\gamename\\%s\\modname\\%s\\gameversion\\%s"
     "\\sv_maxclients\\%d\\clients\\%d\\bots\\%d\\mapname\\%s\\hostname\\%s\\protocol\\%d"
@@ -249,6 +256,20 @@ static void ComposeStatusPacket(CTString &strPacket, const char *strChallenge, B
     // Server status
     GetGameAPI()->GetCurrentGameTypeNameSS(), "0.8.2", 0, ctMaxPlayers - ctClients, 0, sam_strGameName);
 
+  IQuery::AddReply(rc, strPacket);
+};
+
+// Compose status response packet
+static void ComposeStatusPacket(CTString &strPacket, const char *strChallenge, BOOL bFullStatus) {
+  // [Cecil] Reuse the response until the server state changes
+  IQuery::SReplyCache &rc = (bFullStatus ? _rcStatus : _rcInfo);
+
+  if (!IQuery::IsReplyCached(rc)) {
+    ComposeStatusBody(rc, bFullStatus);
+  }
+
+  strPacket = rc.aPackets[0];
+
   // Optional challenge
   if (strChallenge != NULL) {
     strPacket += "\\challenge\\" + CTString(strChallenge);
@@ -266,7 +287,7 @@ void IDarkPlaces::BuildHearthbeatPacket(CTString &strPacket, INDEX iChallenge) {
 
 void IDarkPlaces::EnumTrigger(BOOL bInternet) {
   // Reset requests
-  IQuery::aRequests.Clear();
+  SServerRequest::ClearRequests();
 
   // Initialize as a client
   IQuery::bServer = FALSE;
@@ -281,13 +302,21 @@ void IDarkPlaces::EnumTrigger(BOOL bInternet) {
 };
 
 void IDarkPlaces::EnumUpdate(void) {
-  int iLength = IQuery::ReceivePacket();
+  // Handle all received packets
+  for (;;) {
+    int iLength = IQuery::ReceivePacket();
 
-  if (iLength == -1) {
-    return;
+    if (iLength == -1) {
+      break;
+    }
+
+    // End with a null terminator
+    IQuery::pBuffer[iLength] = '\0';
+    ClientParsePacket(iLength);
   }
 
-  ClientParsePacket(iLength);
+  // Send out more server requests
+  SServerRequest::UpdateRequests();
 };
 
 void IDarkPlaces::ServerParsePacket(INDEX iLength) {
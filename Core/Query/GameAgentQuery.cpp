@@ -165,7 +165,7 @@ void IGameAgent::BuildHearthbeatPacket(CTString &strPacket, INDEX iChallenge)
 
 void IGameAgent::EnumTrigger(BOOL bInternet) {
   // Reset requests
-  IQuery::aRequests.Clear();
+  SServerRequest::ClearRequests();
 
   // Initialize as a client
   IQuery::bServer = FALSE;
@@ -177,17 +177,27 @@ void IGameAgent::EnumTrigger(BOOL bInternet) {
 };
 
 void IGameAgent::EnumUpdate(void) {
-  int iLength = IQuery::ReceivePacket();
+  // Handle all received packets
+  for (;;) {
+    int iLength = IQuery::ReceivePacket();
 
-  if (iLength == -1) {
-    return;
+    if (iLength == -1) {
+      break;
+    }
+
+    // End with a null terminator
+    IQuery::pBuffer[iLength] = '\0';
+    ClientParsePacket(iLength);
   }
 
-  // End with a null terminator
-  IQuery::pBuffer[iLength] = '\0';
-  ClientParsePacket(iLength);
+  // Send out more server requests
+  SServerRequest::UpdateRequests();
 };
 
+// [Cecil] Cached status responses
+static IQuery::SReplyCache _rcStatus;
+static IQuery::SReplyCache _rcPlayers;
+
 void IGameAgent::ServerParsePacket(INDEX iLength) {
   // Data buffer and player count
   const char *pData = IQuery::pBuffer;
@@ -208,45 +218,57 @@ void IGameAgent::ServerParsePacket(INDEX iLength) {
 
     // Server status request
     case 2: {
-      // Send status response
-      strPacket.PrintF("0;players;%d;maxplayers;%d;level;%s;gametype;%s;version;%s;gamename;%s;sessionname;%s",
-        ctPlayers, _pNetwork->ga_sesSessionState.ses_ctMaxPlayers,
-        IWorld::GetWorld()->wo_strName, GetGameAPI()->GetCurrentGameTypeNameSS(),
-        _SE_VER_STRING, sam_strGameName, GetGameAPI()->SessionName());
+      // [Cecil] Compose status response only if it's outdated
+      if (!IQuery::IsReplyCached(_rcStatus)) {
+        IQuery::BeginReply(_rcStatus);
 
-      IQuery::SendReply(strPacket);
+        strPacket.PrintF("0;players;%d;maxplayers;%d;level;%s;gametype;%s;version;%s;gamename;%s;sessionname;%s",
+          ctPlayers, _pNetwork->ga_sesSessionState.ses_ctMaxPlayers,
+          IWorld::GetWorld()->wo_strName, GetGameAPI()->GetCurrentGameTypeNameSS(),
+          _SE_VER_STRING, sam_strGameName, GetGameAPI()->SessionName());
+
+        IQuery::AddReply(_rcStatus, strPacket);
+      }
+
+      // Send status response
+      IQuery::SendCachedReply(_rcStatus);
     } break;
 
     // Player status request
     case 3: {
-      // Compose player status response
-      strPacket.PrintF("\x01players\x02%d\x03", ctPlayers);
-
-      // Go through server players
-      for (INDEX i = 0; i < ctPlayers; i++) {
-        CPlayerTarget &plt = _pNetwork->ga_sesSessionState.ses_apltPlayers[i];
-        CPlayerBuffer &plb = _pNetwork->ga_srvServer.srv_aplbPlayers[i];
-
-        if (plt.plt_bActive) {
-          // Get info about an individual player
-          CTString strPlayer;
-          plt.plt_penPlayerEntity->GetGameSpyPlayerInfo(plb.plb_Index, strPlayer);
-
-          // If not enough space for the next player info
-          if (strPacket.Length() + strPlayer.Length() > 2048) {
-            // Send existing packet and reset it
-            IQuery::SendReply(strPacket);
-            strPacket = "";
-          }
+      // [Cecil] Compose player status response only if it's outdated
+      if (!IQuery::IsReplyCached(_rcPlayers)) {
+        IQuery::BeginReply(_rcPlayers);
+        strPacket.PrintF("\x01players\x02%d\x03", ctPlayers);
+
+        // Go through server players
+        for (INDEX i = 0; i < ctPlayers; i++) {
+          CPlayerTarget &plt = _pNetwork->ga_sesSessionState.ses_apltPlayers[i];
+          CPlayerBuffer &plb = _pNetwork->ga_srvServer.srv_aplbPlayers[i];
+
+          if (plt.plt_bActive) {
+            // Get info about an individual player
+            CTString strPlayer;
+            plt.plt_penPlayerEntity->GetGameSpyPlayerInfo(plb.plb_Index, strPlayer);
+
+            // If not enough space for the next player info
+            if (strPacket.Length() + strPlayer.Length() > 2048) {
+              // Add existing packet and reset it
+              IQuery::AddReply(_rcPlayers, strPacket);
+              strPacket = "";
+            }
 
-          // Append player info
-          strPacket += strPlayer;
+            // Append player info
+            strPacket += strPlayer;
+          }
         }
+
+        strPacket += "\x04";
+        IQuery::AddReply(_rcPlayers, strPacket);
       }
 
-      // Send the packet
-      strPacket += "\x04";
-      IQuery::SendReply(strPacket);
+      // Send the packets
+      IQuery::SendCachedReply(_rcPlayers);
     } break;
 
     // Ping request
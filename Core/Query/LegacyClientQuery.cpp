@@ -46,7 +46,7 @@ static BOOL _bActivatedLocal = FALSE;
 // Start local server search
 static void StartLocalSearch(void) {
   // Reset requests
-  IQuery::aRequests.Clear();
+  SServerRequest::ClearRequests();
 
   // Not a server
   IQuery::bServer = FALSE;
@@ -197,7 +197,7 @@ CTString GetSocketError(void) {
 // Start internet server search
 static void StartInternetSearch(void) {
   // Reset requests
-  IQuery::aRequests.Clear();
+  SServerRequest::ClearRequests();
 
   // Not a server
   IQuery::bServer = FALSE;
@@ -550,9 +550,11 @@ static BOOL ReceiveServerData(SOCKET &iSocketUDP, BOOL bLocal) {
   FD_SET(iSocketUDP, &fdsReadUDP);
 
   // Define a time value
+  // [Cecil] NOTE: Wait just a little bit because replies to all pending requests are received
+  // in any order and more requests need to be sent out as soon as there's space for them
   timeval timeoutUDP;
   timeoutUDP.tv_sec = 0; // 0 second timeout
-  timeoutUDP.tv_usec = (bLocal ? 250000 : 50000); // Add 0.25 or 0.05 seconds
+  timeoutUDP.tv_usec = 10000; // Add 0.01 seconds
 
   int iNumber = select(iSocketUDP + 1, &fdsReadUDP, NULL, NULL, &timeoutUDP);
 
@@ -600,12 +602,8 @@ static BOOL ReceiveServerData(SOCKET &iSocketUDP, BOOL bLocal) {
     }
 
   } else {
-    // Search for a request to clear it
-    SServerRequest *preq = SServerRequest::Find(sinClient);
-
-    if (preq != NULL) {
-      preq->Clear();
-    }
+    // Discard request for this server
+    SServerRequest::Discard(sinClient);
   }
 
   return FALSE;
@@ -631,11 +629,13 @@ static DWORD WINAPI MasterServerThread(LPVOID lpParam) {
       break;
     }
 
-    // Add server request from the address at the current position
+    // Queue server request from the address at the current position
     IQuery::Address addr = *(IQuery::Address *)pServers;
-    addr.AddServerRequest(&pServers, _ctOnlineBuffer, addr.uwPort, "\\status\\", iSocketUDP);
+    addr.AddServerRequest(&pServers, _ctOnlineBuffer, addr.uwPort, "\\status\\");
+  }
 
-    // Receive server data for enumeration
+  // Keep sending requests and receiving server data for enumeration until all of them are done
+  while (SServerRequest::UpdateRequests(iSocketUDP)) {
     if (ReceiveServerData(iSocketUDP, FALSE)) {
       return 0;
     }
@@ -703,11 +703,13 @@ static DWORD WINAPI LocalNetworkThread(LPVOID lpParam) {
       break;
     }
 
-    // Add server request from the address at the current position
+    // Queue server request from the address at the current position
     IQuery::Address addr = *(IQuery::Address *)pServers;
-    addr.AddServerRequest(&pServers, _ctLocalBuffer, addr.uwPort, "\\status\\", iSocketUDP);
+    addr.AddServerRequest(&pServers, _ctLocalBuffer, addr.uwPort, "\\status\\");
+  }
 
-    // Receive server data for enumeration
+  // Keep sending requests and receiving server data for enumeration until all of them are done
+  while (SServerRequest::UpdateRequests(iSocketUDP)) {
     if (ReceiveServerData(iSocketUDP, TRUE)) {
       return 0;
     }
@@ -35,178 +35,229 @@ void ILegacy::BuildHearthbeatPacket(CTString &strPacket, INDEX iChallenge) {
   strPacket.PrintF("\\heartbeat\\%hu\\gamename\\%s", (_piNetPort.GetIndex() + 1), SAM_MS_NAME);
 };
 
-void ILegacy::ServerParsePacket(INDEX iLength) {
-  // End with a null terminator
-  IQuery::pBuffer[iLength] = '\0';
+// [Cecil] Request types in the order of priority
+enum ERequestType {
+  E_REQ_STATUS,
+  E_REQ_INFO,
+  E_REQ_BASIC,
+  E_REQ_PLAYERS,
+  E_REQ_SECURE,
+  E_REQ_UNKNOWN,
+};
 
-  // String of data
-  const char *strData = IQuery::pBuffer;
+// [Cecil] Determine request type by going through all keys in the packet once
+static ERequestType GetRequestType(const char *strData) {
+  ERequestType eType = E_REQ_UNKNOWN;
+  const char *pchKey = strchr(strData, '\\');
 
-  // Check for packet types
-  const char *pStatus  = strstr(strData, "\\status\\");
-  const char *pInfo    = strstr(strData, "\\info\\");
-  const char *pBasic   = strstr(strData, "\\basic\\");
-  const char *pPlayers = strstr(strData, "\\players\\");
-  const char *pSecure  = strstr(strData, "\\secure\\");
+  while (pchKey != NULL) {
+    const char *pchEnd = strchr(pchKey + 1, '\\');
+    if (pchEnd == NULL) break;
 
-  if (ms_bDebugOutput) {
-    CPrintF("Received data (%d bytes):\n%s\n", iLength, IQuery::pBuffer);
+    const size_t ctLen = pchEnd - (pchKey + 1);
+    ERequestType eKey = E_REQ_UNKNOWN;
+
+    #define CHECK_KEY(_Key, _Type) \
+      if (ctLen == sizeof(_Key) - 1 && strncmp(pchKey + 1, _Key, ctLen) == 0) eKey = _Type;
+
+    CHECK_KEY("status",  E_REQ_STATUS)
+    else CHECK_KEY("info",    E_REQ_INFO)
+    else CHECK_KEY("basic",   E_REQ_BASIC)
+    else CHECK_KEY("players", E_REQ_PLAYERS)
+    else CHECK_KEY("secure",  E_REQ_SECURE)
+
+    #undef CHECK_KEY
+
+    if (eKey < eType) eType = eKey;
+    pchKey = pchEnd;
   }
 
+  return eType;
+};
+
+// [Cecil] Cached replies for each request type that doesn't depend on the request itself
+static IQuery::SReplyCache _rcStatus;
+static IQuery::SReplyCache _rcInfo;
+static IQuery::SReplyCache _rcBasic;
+static IQuery::SReplyCache _rcPlayers;
+
+// [Cecil] Append info about each player and split packets that become too long
+static void AppendPlayers(IQuery::SReplyCache &rc, CTString &strPacket) {
+  const INDEX ctPlayers = INetwork::CountPlayers(FALSE);
+
+  // Go through server players
+  for (INDEX i = 0; i < ctPlayers; i++) {
+    CPlayerTarget &plt = _pNetwork->ga_sesSessionState.ses_apltPlayers[i];
+    CPlayerBuffer &plb = _pNetwork->ga_srvServer.srv_aplbPlayers[i];
+
+    if (plt.plt_bActive) {
+      // Get info about an individual player
+      CTString strPlayer;
+      plt.plt_penPlayerEntity->GetGameSpyPlayerInfo(plb.plb_Index, strPlayer);
+
+      // If not enough space for the next player info
+      if (strPacket.Length() + strPlayer.Length() > 2048) {
+        // Add existing packet and reset it
+        IQuery::AddReply(rc, strPacket);
+        strPacket = "";
+      }
+
+      // Append player info
+      strPacket += strPlayer;
+    }
+  }
+};
+
+// [Cecil] Compose status response
+static void ComposeStatus(void) {
+  IQuery::BeginReply(_rcStatus);
+
+  // Get location
+  CTString strLocation;
+  strLocation = _pstrLocalHost.GetString();
+
+  if (strLocation == "") {
+    strLocation = "Heartland";
+  }
+
+  // Retrieve symbols once
+  static CSymbolPtr symptrFF("gam_bFriendlyFire");
+  static CSymbolPtr symptrWeap("gam_bWeaponsStay");
+  static CSymbolPtr symptrAmmo("gam_bAmmoStays");
+  static CSymbolPtr symptrVital("gam_bHealthArmorStays");
+  static CSymbolPtr symptrHP("gam_bAllowHealth");
+  static CSymbolPtr symptrAR("gam_bAllowArmor");
+  static CSymbolPtr symptrIA("gam_bInfiniteAmmo");
+  static CSymbolPtr symptrResp("gam_bRespawnInPlace");
+
   // Player count
   const INDEX ctPlayers = INetwork::CountPlayers(FALSE);
   const INDEX ctMaxPlayers = _pNetwork->ga_sesSessionState.ses_ctMaxPlayers;
 
-  // Status request
-  if (pStatus != NULL) {
-    // Get location
-    CTString strLocation;
-    strLocation = _pstrLocalHost.GetString();
+  CTString strPacket;
+  strPacket.PrintF(_strStatusResponseFormat,
+    sam_strGameName, _SE_VER_STRING, strLocation, GetGameAPI()->SessionName(), _piNetPort.GetIndex(),
+    IWorld::GetWorld()->wo_strName, GetGameAPI()->GetCurrentGameTypeNameSS(),
+    ctPlayers, ctMaxPlayers, symptrFF.GetIndex(), symptrWeap.GetIndex(), symptrAmmo.GetIndex(),
+    symptrVital.GetIndex(), symptrHP.GetIndex(), symptrAR.GetIndex(), symptrIA.GetIndex(), symptrResp.GetIndex());
 
-    if (strLocation == "") {
-      strLocation = "Heartland";
-    }
+  AppendPlayers(_rcStatus, strPacket);
 
-    // Retrieve symbols once
-    static CSymbolPtr symptrFF("gam_bFriendlyFire");
-    static CSymbolPtr symptrWeap("gam_bWeaponsStay");
-    static CSymbolPtr symptrAmmo("gam_bAmmoStays");
-    static CSymbolPtr symptrVital("gam_bHealthArmorStays");
-    static CSymbolPtr symptrHP("gam_bAllowHealth");
-    static CSymbolPtr symptrAR("gam_bAllowArmor");
-    static CSymbolPtr symptrIA("gam_bInfiniteAmmo");
-    static CSymbolPtr symptrResp("gam_bRespawnInPlace");
-
-    // Compose status response
-    CTString strPacket;
-    strPacket.PrintF(_strStatusResponseFormat,
-      sam_strGameName, _SE_VER_STRING, strLocation, GetGameAPI()->SessionName(), _piNetPort.GetIndex(),
-      IWorld::GetWorld()->wo_strName, GetGameAPI()->GetCurrentGameTypeNameSS(),
-      ctPlayers, ctMaxPlayers, symptrFF.GetIndex(), symptrWeap.GetIndex(), symptrAmmo.GetIndex(),
-      symptrVital.GetIndex(), symptrHP.GetIndex(), symptrAR.GetIndex(), symptrIA.GetIndex(), symptrResp.GetIndex());
-
-    // Go through server players
-    for (INDEX i = 0; i < ctPlayers; i++) {
-      CPlayerTarget &plt = _pNetwork->ga_sesSessionState.ses_apltPlayers[i];
-      CPlayerBuffer &plb = _pNetwork->ga_srvServer.srv_aplbPlayers[i];
-
-      if (plt.plt_bActive) {
-        // Get info about an individual player
-        CTString strPlayer;
-        plt.plt_penPlayerEntity->GetGameSpyPlayerInfo(plb.plb_Index, strPlayer);
-
-        // If not enough space for the next player info
-        if (strPacket.Length() + strPlayer.Length() > 2048) {
-          // Send existing packet and reset it
-          IQuery::SendReply(strPacket);
-          strPacket = "";
-        }
-
-        // Append player info
-        strPacket += strPlayer;
-      }
-    }
+  strPacket += "\\final\\\\queryid\\333.1";
+  IQuery::AddReply(_rcStatus, strPacket);
+};
 
-    // Send the packet
-    strPacket += "\\final\\\\queryid\\333.1";
-    IQuery::SendReply(strPacket);
+// [Cecil] Compose information response
+static void ComposeInfo(void) {
+  IQuery::BeginReply(_rcInfo);
 
-    if (ms_bDebugOutput) {
-      CPrintF("Sending status answer:\n%s\n", strPacket);
-    }
+  // Player count
+  const INDEX ctPlayers = INetwork::CountPlayers(FALSE);
+  const INDEX ctMaxPlayers = _pNetwork->ga_sesSessionState.ses_ctMaxPlayers;
 
-  // Information request
-  } else if (pInfo != NULL) {
-    // Send information response
-    CTString strPacket;
-    strPacket.PrintF("\\hostname\\%s\\hostport\\%hu\\mapname\\%s\\gametype\\%s"
-      "\\numplayers\\%d\\maxplayers\\%d\\gamemode\\openplaying\\final\\"
-      "\\queryid\\8.1",
-      GetGameAPI()->SessionName(), _piNetPort.GetIndex(),
-      IWorld::GetWorld()->wo_strName, GetGameAPI()->GetCurrentGameTypeNameSS(),
-      ctPlayers, ctMaxPlayers);
-
-    IQuery::SendReply(strPacket);
-
-    if (ms_bDebugOutput) {
-      CPrintF("Sending info answer:\n%s\n", strPacket);
-    }
+  CTString strPacket;
+  strPacket.PrintF("\\hostname\\%s\\hostport\\%hu\\mapname\\%s\\gametype\\%s"
+    "\\numplayers\\%d\\maxplayers\\%d\\gamemode\\openplaying\\final\\"
+    "\\queryid\\8.1",
+    GetGameAPI()->SessionName(), _piNetPort.GetIndex(),
+    IWorld::GetWorld()->wo_strName, GetGameAPI()->GetCurrentGameTypeNameSS(),
+    ctPlayers, ctMaxPlayers);
 
-  // Basic request
-  } else if (pBasic != NULL) {
-    // Get location
-    CTString strLocation;
-    strLocation = _pstrLocalHost.GetString();
+  IQuery::AddReply(_rcInfo, strPacket);
+};
 
-    if (strLocation == "") {
-      strLocation = "Heartland";
-    }
+// [Cecil] Compose basic response
+static void ComposeBasic(void) {
+  IQuery::BeginReply(_rcBasic);
 
-    // Send basic response
-    CTString strPacket;
-    strPacket.PrintF("\\gamename\\%s\\gamever\\%s\\location\\EU\\final\\" "\\queryid\\1.1",
-      sam_strGameName, _SE_VER_STRING, strLocation); // [Cecil] NOTE: Unused location
+  // Get location
+  CTString strLocation;
+  strLocation = _pstrLocalHost.GetString();
 
-    IQuery::SendReply(strPacket);
+  if (strLocation == "") {
+    strLocation = "Heartland";
+  }
 
-    if (ms_bDebugOutput) {
-      CPrintF("Sending basic answer:\n%s\n", strPacket);
-    }
+  CTString strPacket;
+  strPacket.PrintF("\\gamename\\%s\\gamever\\%s\\location\\EU\\final\\" "\\queryid\\1.1",
+    sam_strGameName, _SE_VER_STRING, strLocation); // [Cecil] NOTE: Unused location
 
-  // Player status request
-  } else if (pPlayers != NULL) {
-    // Compose player status response
-    CTString strPacket;
-    strPacket = "";
-
-    // Go through server players
-    for (INDEX i = 0; i < ctPlayers; i++) {
-      CPlayerTarget &plt = _pNetwork->ga_sesSessionState.ses_apltPlayers[i];
-      CPlayerBuffer &plb = _pNetwork->ga_srvServer.srv_aplbPlayers[i];
-
-      if (plt.plt_bActive) {
-        // Get info about an individual player
-        CTString strPlayer;
-        plt.plt_penPlayerEntity->GetGameSpyPlayerInfo(plb.plb_Index, strPlayer);
-
-        // If not enough space for the next player info
-        if (strPacket.Length() + strPlayer.Length() > 2048) {
-          // Send existing packet and reset it
-          IQuery::SendReply(strPacket);
-          strPacket = "";
-        }
-
-        // Append player info
-        strPacket += strPlayer;
-      }
-    }
+  IQuery::AddReply(_rcBasic, strPacket);
+};
 
-    // Send the packet
-    strPacket += "\\final\\\\queryid\\6.1";
-    IQuery::SendReply(strPacket);
+// [Cecil] Compose player status response
+static void ComposePlayers(void) {
+  IQuery::BeginReply(_rcPlayers);
 
-    if (ms_bDebugOutput) {
-      CPrintF("Sending players answer:\n%s\n", strPacket);
-    }
+  CTString strPacket;
+  strPacket = "";
 
-  // Validation request
-  } else if (pSecure != NULL) {
-    UBYTE *pValidateKey = gsseckey((UBYTE *)(strData + 8), (UBYTE *)SAM_MS_KEY, 0);
+  AppendPlayers(_rcPlayers, strPacket);
 
-    // Send validation response
-    CTString strPacket;
-    strPacket.PrintF("\\validate\\%s\\final\\" "\\queryid\\2.1", pValidateKey);
+  strPacket += "\\final\\\\queryid\\6.1";
+  IQuery::AddReply(_rcPlayers, strPacket);
+};
 
-    IQuery::SendReply(strPacket);
+// [Cecil] Send cached replies, composing them again if they're outdated
+static void SendReplies(IQuery::SReplyCache &rc, void (*pComposeFunc)(void), const char *strName) {
+  if (!IQuery::IsReplyCached(rc)) {
+    pComposeFunc();
+  }
 
-    if (ms_bDebugOutput) {
-      CPrintF("Sending validation answer:\n%s\n", strPacket);
-    }
+  IQuery::SendCachedReply(rc);
+
+  if (ms_bDebugOutput) {
+    CPrintF("Sending %s answer:\n%s\n", strName, rc.aPackets[rc.aPackets.Count() - 1]);
+  }
+};
+
+void ILegacy::ServerParsePacket(INDEX iLength) {
+  // End with a null terminator
+  IQuery::pBuffer[iLength] = '\0';
 
-  // Unknown request
-  } else if (ms_bDebugOutput) {
-    CPrintF("Unknown query server request!\n"
-            "Data (%d bytes): %s\n", iLength, strData);
+  // String of data
+  const char *strData = IQuery::pBuffer;
+
+  if (ms_bDebugOutput) {
+    CPrintF("Received data (%d bytes):\n%s\n", iLength, IQuery::pBuffer);
+  }
+
+  // [Cecil] Check for packet types
+  switch (GetRequestType(strData)) {
+    // Status request
+    case E_REQ_STATUS: SendReplies(_rcStatus, &ComposeStatus, "status"); break;
+
+    // Information request
+    case E_REQ_INFO: SendReplies(_rcInfo, &ComposeInfo, "info"); break;
+
+    // Basic request
+    case E_REQ_BASIC: SendReplies(_rcBasic, &ComposeBasic, "basic"); break;
+
+    // Player status request
+    case E_REQ_PLAYERS: SendReplies(_rcPlayers, &ComposePlayers, "players"); break;
+
+    // Validation request (depends on the sent key, so it's never cached)
+    case E_REQ_SECURE: {
+      UBYTE *pValidateKey = gsseckey((UBYTE *)(strData + 8), (UBYTE *)SAM_MS_KEY, 0);
+
+      // Send validation response
+      CTString strPacket;
+      strPacket.PrintF("\\validate\\%s\\final\\" "\\queryid\\2.1", pValidateKey);
+
+      IQuery::SendReply(strPacket);
+
+      if (ms_bDebugOutput) {
+        CPrintF("Sending validation answer:\n%s\n", strPacket);
+      }
+    } break;
+
+    // Unknown request
+    default: {
+      if (ms_bDebugOutput) {
+        CPrintF("Unknown query server request!\n"
+                "Data (%d bytes): %s\n", iLength, strData);
+      }
+    }
   }
 };
 
@@ -53,6 +53,12 @@ void OnServerStart(void) {
   IQuery::bServer = TRUE;
   IQuery::bInitialized = TRUE;
 
+  // [Cecil] Don't reuse replies from the previous game
+  IQuery::InvalidateReplies();
+
+  // [Cecil] Forget addresses from the previous game
+  IQuery::ResetLimiter();
+
   // Send opening packet to the master server
   switch (GetProtocol()) {
     case E_MS_LEGACY: {
@@ -110,6 +116,9 @@ void OnServerEnd(void) {
   // Close the socket
   IQuery::CloseWinsock();
   IQuery::bInitialized = FALSE;
+
+  // [Cecil] Forget replies for this game
+  IQuery::InvalidateReplies();
 };
 
 // Server update step
@@ -122,16 +131,25 @@ void OnServerUpdate(void) {
     return;
   }
 
-  // Receive new packet
-  memset(&IQuery::pBuffer[0], 0, 2050);
-  INDEX iLength = IQuery::ReceivePacket();
+  // [Cecil] Handle all pending packets instead of one per update, so queries don't pile up in the socket
+  // The limit prevents a flood of packets from stalling the game
+  const INDEX ctMaxPackets = ClampDn(ms_iMaxPacketsPerUpdate, (INDEX)1);
+
+  for (INDEX iPacket = 0; iPacket < ctMaxPackets; iPacket++) {
+    // Receive new packet
+    memset(&IQuery::pBuffer[0], 0, 2050);
+    INDEX iLength = IQuery::ReceivePacket();
+
+    // No more data
+    if (iLength <= 0) break;
 
-  // If there's any data
-  if (iLength > 0) {
     if (ms_bDebugOutput) {
       CPrintF("Received packet (%d bytes)\n", iLength);
     }
 
+    // [Cecil] Ignore requests from addresses that send too many of them or when too much has been sent already
+    if (!IQuery::AcceptRequest()) continue;
+
     // Parse received packet
     _aProtocols[GetProtocol()]->ServerParsePacket(iLength);
   }
@@ -156,6 +174,9 @@ void OnServerStateChanged(void) {
     CPutString("  IMasterServer::OnServerStateChanged()\n");
   }
 
+  // [Cecil] Compose new replies to status requests
+  IQuery::InvalidateReplies();
+
   // Notify master server about the state change
   switch (GetProtocol()) {
     // Legacy
@@ -259,7 +280,7 @@ void EnumCancel(void) {
   }
 
   // Delete server requests and close the socket
-  IQuery::aRequests.Clear();
+  SServerRequest::ClearRequests();
   IQuery::CloseWinsock();
 };
 
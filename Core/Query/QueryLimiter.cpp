@@ -0,0 +1,240 @@
+/* Copyright (c) 2022-2025 Dreamy Cecil
+This program is free software; you can redistribute it and/or modify
+it under the terms of version 2 of the GNU General Public License as published by
+the Free Software Foundation
+
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "StdH.h"
+
+#if _PATCHCONFIG_NEW_QUERY
+
+#include "QueryManager.h"
+
+// Requests that can still be answered for one source address
+struct SQuerySource {
+  ULONG ulAddress; // 0 if unused
+  FLOAT fTokens; // Amount of requests that can be answered right now
+  DOUBLE dLastTime; // When the tokens have been updated
+};
+
+// Token buckets for source addresses and for all replies together
+class CQueryLimiter {
+  public:
+    // Fixed amount of tracked addresses and how many neighbouring slots are checked for each one
+    enum {
+      CT_SLOTS = 1024,
+      CT_PROBES = 8,
+    };
+
+    SQuerySource aSources[CT_SLOTS];
+
+    DOUBLE dBudget; // Reply bytes that can be sent right now
+    DOUBLE dBudgetTime; // When the budget has been updated (-1 if it hasn't been used yet)
+
+  public:
+    // Constructor
+    CQueryLimiter() {
+      Clear();
+    };
+
+    // Forget all addresses and restore the budget
+    void Clear(void) {
+      memset(aSources, 0, sizeof(aSources));
+      dBudget = 0.0;
+      dBudgetTime = -1.0;
+    };
+
+    // Take one token from the bucket of some address
+    BOOL AcceptSource(ULONG ulAddress, DOUBLE dNow, FLOAT fRate, FLOAT fBurst);
+
+    // Check if there are any reply bytes left
+    BOOL HasBudget(DOUBLE dNow, DOUBLE dPerSecond);
+
+    // Take sent reply bytes from the budget
+    void SpendBudget(INDEX ctBytes) {
+      dBudget -= ctBytes;
+    };
+};
+
+// Take one token from the bucket of some address
+BOOL CQueryLimiter::AcceptSource(ULONG ulAddress, DOUBLE dNow, FLOAT fRate, FLOAT fBurst) {
+  const ULONG ulHash = (ulAddress * 2654435761UL) >> 16;
+
+  SQuerySource *psrcFound = NULL;
+  SQuerySource *psrcFree = NULL;
+  SQuerySource *psrcOldest = NULL;
+
+  for (INDEX iProbe = 0; iProbe < CT_PROBES; iProbe++) {
+    SQuerySource &src = aSources[(ulHash + iProbe) & (CT_SLOTS - 1)];
+
+    if (src.ulAddress == ulAddress) {
+      psrcFound = &src;
+      break;
+    }
+
+    // Entries that would've refilled completely by now are no different from unused ones
+    if (psrcFree == NULL) {
+      if (src.ulAddress == 0 || src.fTokens + (dNow - src.dLastTime) * fRate >= fBurst) {
+        psrcFree = &src;
+      }
+    }
+
+    if (psrcOldest == NULL || src.dLastTime < psrcOldest->dLastTime) {
+      psrcOldest = &src;
+    }
+  }
+
+  // Start tracking a new address in place of an aged or the oldest one
+  if (psrcFound == NULL) {
+    psrcFound = (psrcFree != NULL ? psrcFree : psrcOldest);
+    psrcFound->ulAddress = ulAddress;
+    psrcFound->fTokens = fBurst;
+    psrcFound->dLastTime = dNow;
+  }
+
+  SQuerySource &src = *psrcFound;
+
+  // Refill the bucket over time
+  src.fTokens = Min(FLOAT(src.fTokens + (dNow - src.dLastTime) * fRate), fBurst);
+  src.dLastTime = dNow;
+
+  if (src.fTokens < 1.0f) return FALSE;
+
+  src.fTokens -= 1.0f;
+  return TRUE;
+};
+
+// Check if there are any reply bytes left
+BOOL CQueryLimiter::HasBudget(DOUBLE dNow, DOUBLE dPerSecond) {
+  // Start with a full budget
+  if (dBudgetTime < 0.0) {
+    dBudget = dPerSecond;
+
+  // Refill it over time
+  } else {
+    dBudget = Min(dBudget + (dNow - dBudgetTime) * dPerSecond, dPerSecond);
+  }
+
+  dBudgetTime = dNow;
+  return dBudget > 0.0;
+};
+
+static CQueryLimiter _limiter;
+
+namespace IQuery {
+
+// Check if a request from the last source address should be answered
+BOOL AcceptRequest(void) {
+  const DOUBLE dNow = _pTimer->GetHighPrecisionTimer().GetSeconds();
+
+  // Drop requests from addresses that send them too often
+  if (ms_fQueryRate > 0.0f) {
+    const FLOAT fBurst = ClampDn((FLOAT)ms_iQueryBurst, 1.0f);
+
+    if (!_limiter.AcceptSource(sinFrom.sin_addr.s_addr, dNow, ms_fQueryRate, fBurst)) {
+      ms_ctQueriesDropped++;
+      return FALSE;
+    }
+  }
+
+  // Drop any requests if too much has already been sent
+  if (ms_iReplyBudget > 0 && !_limiter.HasBudget(dNow, ms_iReplyBudget)) {
+    ms_ctQueriesDropped++;
+    return FALSE;
+  }
+
+  ms_ctQueriesAnswered++;
+  return TRUE;
+};
+
+// Take sent reply bytes from the budget
+void SpendReplyBudget(INDEX ctBytes) {
+  _limiter.SpendBudget(ctBytes);
+};
+
+// Reset limits for all addresses
+void ResetLimiter(void) {
+  _limiter.Clear();
+};
+
+}; // namespace
+
+// Simulate a flood of spoofed requests to measure the limiter
+void BenchmarkQueryLimiter(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const INDEX ctPackets = ClampDn(NEXT_ARG(INDEX), (INDEX)1);
+
+  // Average reply size for status requests with a few players
+  static const INDEX ctReplyBytes = 1400;
+
+  const FLOAT fRate = ClampDn(ms_fQueryRate, 0.001f);
+  const FLOAT fBurst = ClampDn((FLOAT)ms_iQueryBurst, 1.0f);
+  const DOUBLE dBudget = (ms_iReplyBudget > 0 ? ms_iReplyBudget : 1e12);
+
+  CQueryLimiter *pBench = new CQueryLimiter;
+
+  INDEX ctFlooder = 0, ctFlooderAnswered = 0;
+  INDEX ctSpoofed = 0, ctSpoofedAnswered = 0;
+  INDEX ctPlayer = 0, ctPlayerAnswered = 0;
+  ULONG ulRandom = 12345;
+
+  const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  // Packets arrive evenly over one simulated second
+  for (INDEX iPacket = 0; iPacket < ctPackets; iPacket++) {
+    const DOUBLE dNow = DOUBLE(iPacket) / DOUBLE(ctPackets);
+    ulRandom = ulRandom * 1103515245UL + 12345UL;
+
+    // Half of the packets are from one address, the rest are from random ones,
+    // and a regular client asks every 100 packets
+    ULONG ulAddress;
+    INDEX *pctSent, *pctAnswered;
+
+    if (iPacket % 100 == 0) {
+      ulAddress = 0x7F000001;
+      pctSent = &ctPlayer;
+      pctAnswered = &ctPlayerAnswered;
+
+    } else if (iPacket % 2 == 0) {
+      ulAddress = 0x0A000001;
+      pctSent = &ctFlooder;
+      pctAnswered = &ctFlooderAnswered;
+
+    } else {
+      ulAddress = (ulRandom | 1);
+      pctSent = &ctSpoofed;
+      pctAnswered = &ctSpoofedAnswered;
+    }
+
+    (*pctSent)++;
+
+    if (!pBench->AcceptSource(ulAddress, dNow, fRate, fBurst)) continue;
+    if (!pBench->HasBudget(dNow, dBudget)) continue;
+
+    pBench->SpendBudget(ctReplyBytes);
+    (*pctAnswered)++;
+  }
+
+  const CTimerValue tvEnd = _pTimer->GetHighPrecisionTimer();
+  delete pBench;
+
+  const DOUBLE dTime = (tvEnd - tvStart).GetSeconds() * 1000.0;
+  const INDEX ctAnswered = ctFlooderAnswered + ctSpoofedAnswered + ctPlayerAnswered;
+
+  CPrintF(TRANS("%d packets checked in %.3f ms (%.3f us per packet)\n"), ctPackets, dTime, dTime * 1000.0 / ctPackets);
+  CPrintF(TRANS("  one address:      %d / %d answered\n"), ctFlooderAnswered, ctFlooder);
+  CPrintF(TRANS("  random addresses: %d / %d answered\n"), ctSpoofedAnswered, ctSpoofed);
+  CPrintF(TRANS("  regular client:   %d / %d answered\n"), ctPlayerAnswered, ctPlayer);
+  CPrintF(TRANS("  %d reply bytes instead of %d\n"), ctAnswered * ctReplyBytes, ctPackets * ctReplyBytes);
+};
+
+#endif // _PATCHCONFIG_NEW_QUERY
@@ -39,6 +39,34 @@ INDEX ms_bDebugOutput = FALSE;
 // Hook old master server address instead of replacing entire query manager
 INDEX ms_bVanillaQuery = FALSE;
 
+// How many server requests can wait for replies at the same time
+INDEX ms_iMaxPendingRequests = 64;
+
+// How long to wait for a reply from a server before resending the request (in seconds)
+FLOAT ms_fRequestTimeout = 1.0f;
+
+// How many times to resend server requests that haven't been answered
+INDEX ms_iRequestRetries = 1;
+
+// How long composed replies to server status requests can be reused (in seconds; 0 to always compose new ones)
+FLOAT ms_fReplyCacheTime = 1.0f;
+
+// How many received packets can be handled during one server update
+INDEX ms_iMaxPacketsPerUpdate = 64;
+
+// How many requests per second can be answered for one address (0 to answer all of them)
+FLOAT ms_fQueryRate = 2.0f;
+
+// How many requests in a row can be answered for one address before limiting them
+INDEX ms_iQueryBurst = 5;
+
+// How many reply bytes per second can be sent to all addresses together (0 for no limit)
+INDEX ms_iReplyBudget = 65536;
+
+// How many requests have been answered and dropped by the limiter
+INDEX ms_ctQueriesAnswered = 0;
+INDEX ms_ctQueriesDropped = 0;
+
 // Commonly used symbols
 CSymbolPtr _piNetPort;
 CSymbolPtr _pstrLocalHost;
@@ -81,6 +109,8 @@ IGameAgent::IGameAgent() {
 
 // Initialize query manager
 extern void InitQuery(void) {
+  IQuery::csRequests.cs_iIndex = -1;
+
   // Custom symbols
   _pShell->DeclareSymbol("void UpdateInternalGameSpyMS(INDEX);", &UpdateInternalGameSpyMS);
   _pShell->DeclareSymbol("persistent user INDEX ms_iProtocol;",          &ms_iProtocol);
@@ -88,6 +118,25 @@ extern void InitQuery(void) {
 
   _pShell->DeclareSymbol("persistent user INDEX ms_bVanillaQuery pre:UpdateServerSymbolValue;", &ms_bVanillaQuery);
 
+  _pShell->DeclareSymbol("persistent user INDEX ms_iMaxPendingRequests;", &ms_iMaxPendingRequests);
+  _pShell->DeclareSymbol("persistent user FLOAT ms_fRequestTimeout;",     &ms_fRequestTimeout);
+  _pShell->DeclareSymbol("persistent user INDEX ms_iRequestRetries;",     &ms_iRequestRetries);
+
+  _pShell->DeclareSymbol("persistent user FLOAT ms_fReplyCacheTime;",      &ms_fReplyCacheTime);
+  _pShell->DeclareSymbol("persistent user INDEX ms_iMaxPacketsPerUpdate;", &ms_iMaxPacketsPerUpdate);
+
+  _pShell->DeclareSymbol("persistent user FLOAT ms_fQueryRate;",   &ms_fQueryRate);
+  _pShell->DeclareSymbol("persistent user INDEX ms_iQueryBurst;",  &ms_iQueryBurst);
+  _pShell->DeclareSymbol("persistent user INDEX ms_iReplyBudget;", &ms_iReplyBudget);
+  _pShell->DeclareSymbol("user INDEX ms_ctQueriesAnswered;",       &ms_ctQueriesAnswered);
+  _pShell->DeclareSymbol("user INDEX ms_ctQueriesDropped;",        &ms_ctQueriesDropped);
+
+  extern void BenchmarkServerRequests(SHELL_FUNC_ARGS);
+  _pShell->DeclareSymbol("user void ms_BenchmarkRequests(INDEX);", &BenchmarkServerRequests);
+
+  extern void BenchmarkQueryLimiter(SHELL_FUNC_ARGS);
+  _pShell->DeclareSymbol("user void ms_BenchmarkLimiter(INDEX);", &BenchmarkQueryLimiter);
+
   // Master server protocol types
   static const INDEX iLegacyMS     = E_MS_LEGACY;
   static const INDEX iDarkPlacesMS = E_MS_DARKPLACES;
@@ -114,10 +163,11 @@ char *pBuffer = NULL;
 BOOL bServer = FALSE;
 BOOL bInitialized = FALSE;
 
-CDynamicStackArray<SServerRequest> aRequests;
+CServerRequests aRequests;
+CTCriticalSection csRequests;
 
-// Add new server request from a received address
-void Address::AddServerRequest(const char **ppBuffer, INDEX &iLength, const UWORD uwSetPort, const char *strPacket, SOCKET iSocketUDP) {
+// Queue new server request from a received address
+void Address::AddServerRequest(const char **ppBuffer, INDEX &iLength, const UWORD uwSetPort, const char *strPacket) {
   const INDEX iAddrLength = 6; // IQuery::Address struct size
 
   // If valid port and at least one valid address byte
@@ -132,11 +182,8 @@ void Address::AddServerRequest(const char **ppBuffer, INDEX &iLength, const UWOR
     sinServer.sin_addr.s_addr = inet_addr(strIP);
     sinServer.sin_port = uwSetPort;
 
-    // Add a new server status request
-    SServerRequest::AddRequest(sinServer);
-
-    // Send packet to the server
-    SendPacketTo(&sinServer, strPacket, (int)strlen(strPacket), iSocketUDP);
+    // Queue a new server status request
+    SServerRequest::AddRequest(sinServer, strPacket);
   }
 
   // Get next address
@@ -245,6 +292,11 @@ BOOL IsSocketUsable(void) {
   return (_socket != INVALID_SOCKET && bInitialized);
 };
 
+// Get the socket for waiting on incoming packets (INVALID_SOCKET if it's unusable)
+SOCKET GetSocket(void) {
+  return IsSocketUsable() ? _socket : INVALID_SOCKET;
+};
+
 // Send packet with data from a buffer
 void SendPacket(const char *pBuffer, int iLength) {
   // Initialize the socket in case it's not
@@ -268,6 +320,11 @@ void SendPacketTo(sockaddr_in *psin, const char *pBuffer, int iLength, SOCKET iS
 
 // Send reply packet with a message
 void SendReply(const CTString &strMessage) {
+  // [Cecil] Count replies towards the budget
+  if (bServer) {
+    SpendReplyBudget(strMessage.Length());
+  }
+
   SendPacketTo(&sinFrom, strMessage.str_String, strMessage.Length());
 };
 
@@ -277,6 +334,37 @@ int ReceivePacket(void) {
   return recvfrom(_socket, pBuffer, 2048, 0, (sockaddr *)&sinFrom, &ctFrom);
 };
 
+// Current server state for cached replies
+static INDEX _iReplyGeneration = 0;
+
+// Check if cached replies are still up to date
+BOOL IsReplyCached(const SReplyCache &rc) {
+  if (ms_fReplyCacheTime <= 0.0f || rc.iGeneration != _iReplyGeneration) return FALSE;
+
+  // Replies also include player scores and pings, so they shouldn't be kept for long
+  const CTimerValue tvNow = _pTimer->GetHighPrecisionTimer();
+  return (tvNow - rc.tvComposed).GetSeconds() < ms_fReplyCacheTime;
+};
+
+// Start composing new replies
+void BeginReply(SReplyCache &rc) {
+  rc.aPackets.PopAll();
+  rc.iGeneration = _iReplyGeneration;
+  rc.tvComposed = _pTimer->GetHighPrecisionTimer();
+};
+
+// Send all cached reply packets
+void SendCachedReply(const SReplyCache &rc) {
+  for (INDEX i = 0; i < rc.aPackets.Count(); i++) {
+    SendReply(rc.aPackets[i]);
+  }
+};
+
+// Mark all cached replies as outdated
+void InvalidateReplies(void) {
+  _iReplyGeneration++;
+};
+
 // Set enumeration status
 void SetStatus(const CTString &strStatus) {
   _pNetwork->ga_bEnumerationChange = TRUE;
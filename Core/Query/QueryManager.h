@@ -107,6 +107,34 @@ CORE_API extern INDEX ms_bDebugOutput;
 // Hook old master server address instead of replacing entire query manager
 CORE_API extern INDEX ms_bVanillaQuery;
 
+// How many server requests can wait for replies at the same time
+CORE_API extern INDEX ms_iMaxPendingRequests;
+
+// How long to wait for a reply from a server before resending the request (in seconds)
+CORE_API extern FLOAT ms_fRequestTimeout;
+
+// How many times to resend server requests that haven't been answered
+CORE_API extern INDEX ms_iRequestRetries;
+
+// How long composed replies to server status requests can be reused (in seconds; 0 to always compose new ones)
+CORE_API extern FLOAT ms_fReplyCacheTime;
+
+// How many received packets can be handled during one server update
+CORE_API extern INDEX ms_iMaxPacketsPerUpdate;
+
+// How many requests per second can be answered for one address (0 to answer all of them)
+CORE_API extern FLOAT ms_fQueryRate;
+
+// How many requests in a row can be answered for one address before limiting them
+CORE_API extern INDEX ms_iQueryBurst;
+
+// How many reply bytes per second can be sent to all addresses together (0 for no limit)
+CORE_API extern INDEX ms_iReplyBudget;
+
+// How many requests have been answered and dropped by the limiter
+CORE_API extern INDEX ms_ctQueriesAnswered;
+CORE_API extern INDEX ms_ctQueriesDropped;
+
 // Commonly used symbols
 extern CSymbolPtr _piNetPort;
 extern CSymbolPtr _pstrLocalHost;
@@ -124,8 +152,8 @@ struct Address {
   };
   UWORD uwPort; // Port
 
-  // Add new server request from a received address
-  void AddServerRequest(const char **ppBuffer, INDEX &iLength, const UWORD uwSetPort, const char *strPacket, SOCKET iSocketUDP = INVALID_SOCKET);
+  // Queue new server request from a received address
+  void AddServerRequest(const char **ppBuffer, INDEX &iLength, const UWORD uwSetPort, const char *strPacket);
 };
 
 #pragma pack(pop)
@@ -136,7 +164,20 @@ extern char *pBuffer;
 extern BOOL bServer;
 extern BOOL bInitialized;
 
-extern CDynamicStackArray<SServerRequest> aRequests;
+// Server requests are shared between the master server and the local network threads
+extern CServerRequests aRequests;
+extern CTCriticalSection csRequests;
+
+// Reply packets that can be sent again until the server state changes
+struct SReplyCache {
+  CStaticStackArray<CTString> aPackets; // Composed reply packets
+  INDEX iGeneration; // Server state the replies have been composed for
+  CTimerValue tvComposed; // When the replies have been composed
+
+  SReplyCache() : iGeneration(-1)
+  {
+  };
+};
 
 // Initialize the socket
 void InitWinsock(void);
@@ -147,6 +188,9 @@ void CloseWinsock();
 // Check if the socket is usable
 BOOL IsSocketUsable(void);
 
+// Get the socket for waiting on incoming packets (INVALID_SOCKET if it's unusable)
+CORE_API SOCKET GetSocket(void);
+
 // Send data packet
 void SendPacket(const char *pBuffer, int iLength = -1);
 
@@ -159,6 +203,32 @@ void SendReply(const CTString &strMessage);
 // Receive some packet
 int ReceivePacket(void);
 
+// Check if cached replies are still up to date
+BOOL IsReplyCached(const SReplyCache &rc);
+
+// Start composing new replies
+void BeginReply(SReplyCache &rc);
+
+// Add composed reply packet
+inline void AddReply(SReplyCache &rc, const CTString &strMessage) {
+  rc.aPackets.Push() = strMessage;
+};
+
+// Send all cached reply packets
+void SendCachedReply(const SReplyCache &rc);
+
+// Mark all cached replies as outdated
+CORE_API void InvalidateReplies(void);
+
+// Check if a request from the last source address should be answered
+BOOL AcceptRequest(void);
+
+// Take sent reply bytes from the budget
+void SpendReplyBudget(INDEX ctBytes);
+
+// Reset limits for all addresses
+void ResetLimiter(void);
+
 // Set enumeration status
 void SetStatus(const CTString &strStatus);
 
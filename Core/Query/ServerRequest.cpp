@@ -20,40 +20,352 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "ServerRequest.h"
 #include "QueryManager.h"
 
-// Add a new server request
-void SServerRequest::AddRequest(const sockaddr_in &addr) {
-  SServerRequest &req = IQuery::aRequests.Push();
-  req.ulAddress = addr.sin_addr.s_addr;
-  req.uwPort = addr.sin_port;
-  req.tvRequestTime = _pTimer->GetHighPrecisionTimer();
+// Hash an address with a port
+static inline ULONG HashAddress(ULONG ulAddress, UWORD uwPort) {
+  ULONG ulHash = ulAddress * 2654435761UL;
+  ulHash ^= (ULONG(uwPort) * 40503UL) + (ulHash >> 16);
+  return ulHash;
 };
 
-// Find server request with a matching the socket address
-SServerRequest *SServerRequest::Find(const sockaddr_in &addr) {
-  // Search for the status request
-  for (INDEX i = 0; i < IQuery::aRequests.Count(); i++) {
-    SServerRequest &req = IQuery::aRequests[i];
+// Constructor
+CServerRequests::CServerRequests() {
+  sr_ctActive = 0;
+  sr_ctDiscarded = 0;
+  sr_ctQueued = 0;
+  sr_ctSent = 0;
+  sr_iQueuedHead = 0;
+  sr_iSentHead = 0;
+};
+
+// Remove all requests
+void CServerRequests::Clear(void) {
+  sr_aSlots.Clear();
+  sr_aQueued.PopAll();
+  sr_aSent.PopAll();
+
+  sr_ctActive = 0;
+  sr_ctDiscarded = 0;
+  sr_ctQueued = 0;
+  sr_ctSent = 0;
+  sr_iQueuedHead = 0;
+  sr_iSentHead = 0;
+};
+
+// Find slot for a specific address (either with this address, or the first reusable one)
+INDEX CServerRequests::FindSlot(ULONG ulAddress, UWORD uwPort, BOOL bForAdding) const {
+  const INDEX ctSlots = sr_aSlots.Count();
+  if (ctSlots == 0) return -1;
+
+  const ULONG ulMask = ctSlots - 1;
+  ULONG ulSlot = HashAddress(ulAddress, uwPort) & ulMask;
+  INDEX iReusable = -1;
+
+  for (INDEX iProbe = 0; iProbe < ctSlots; iProbe++) {
+    const SServerRequest &req = sr_aSlots[ulSlot];
 
-    // Found matching address
-    if (req.ulAddress == addr.sin_addr.s_addr && req.uwPort == addr.sin_port) {
-      return &req;
+    // End of the chain
+    if (req.iState == SServerRequest::E_SRS_FREE) {
+      if (!bForAdding) return -1;
+      return (iReusable != -1) ? iReusable : ulSlot;
     }
+
+    // Remember the first discarded slot for reuse
+    if (req.iState == SServerRequest::E_SRS_DISCARDED) {
+      if (iReusable == -1) iReusable = ulSlot;
+
+    // Found the request
+    } else if (req.ulAddress == ulAddress && req.uwPort == uwPort) {
+      return ulSlot;
+    }
+
+    ulSlot = (ulSlot + 1) & ulMask;
+  }
+
+  return bForAdding ? iReusable : -1;
+};
+
+// Compact list of references by removing ones before the head
+static void CompactRefs(CStaticStackArray<CServerRequests::SRef> &aRefs, INDEX &iHead) {
+  const INDEX ctRefs = aRefs.Count();
+
+  if (iHead >= ctRefs) {
+    aRefs.PopAll();
+    iHead = 0;
+    return;
+  }
+
+  // Not worth it yet
+  if (iHead < 64 || iHead < ctRefs / 2) return;
+
+  const INDEX ctLeft = ctRefs - iHead;
+
+  for (INDEX i = 0; i < ctLeft; i++) {
+    aRefs[i] = aRefs[iHead + i];
+  }
+
+  aRefs.PopUntil(ctLeft - 1);
+  iHead = 0;
+};
+
+// Remap valid references to new slots
+static void RemapRefs(CStaticStackArray<CServerRequests::SRef> &aRefs, INDEX &iHead,
+  const CStaticArray<SServerRequest> &aOldSlots, const CStaticArray<INDEX> &aiNewSlots, INDEX iState)
+{
+  const INDEX ctRefs = aRefs.Count();
+  INDEX ctValid = 0;
+
+  for (INDEX i = iHead; i < ctRefs; i++) {
+    CServerRequests::SRef ref = aRefs[i];
+    const SServerRequest &req = aOldSlots[ref.iSlot];
+
+    // Drop outdated references
+    if (req.iState != iState || req.ulSerial != ref.ulSerial) continue;
+
+    ref.iSlot = aiNewSlots[ref.iSlot];
+    aRefs[ctValid++] = ref;
+  }
+
+  if (ctValid == 0) {
+    aRefs.PopAll();
+  } else {
+    aRefs.PopUntil(ctValid - 1);
+  }
+
+  iHead = 0;
+};
+
+// Resize the table and drop all discarded requests
+void CServerRequests::Rehash(INDEX ctMinSlots) {
+  INDEX ctSlots = 64;
+  while (ctSlots < ctMinSlots) ctSlots <<= 1;
+
+  CStaticArray<SServerRequest> aOldSlots;
+  aOldSlots.MoveArray(sr_aSlots);
+
+  sr_aSlots.New(ctSlots);
+  sr_ctDiscarded = 0;
+
+  // Reinsert active requests
+  const INDEX ctOldSlots = aOldSlots.Count();
+
+  CStaticArray<INDEX> aiNewSlots;
+  if (ctOldSlots != 0) aiNewSlots.New(ctOldSlots);
+
+  for (INDEX iOld = 0; iOld < ctOldSlots; iOld++) {
+    const SServerRequest &reqOld = aOldSlots[iOld];
+    aiNewSlots[iOld] = -1;
+
+    if (!reqOld.IsActive()) continue;
+
+    const INDEX iNew = FindSlot(reqOld.ulAddress, reqOld.uwPort, TRUE);
+    sr_aSlots[iNew] = reqOld;
+    aiNewSlots[iOld] = iNew;
   }
 
-  // None found
-  return NULL;
+  // Update references to the requests
+  if (ctOldSlots != 0) {
+    RemapRefs(sr_aQueued, sr_iQueuedHead, aOldSlots, aiNewSlots, SServerRequest::E_SRS_QUEUED);
+    RemapRefs(sr_aSent, sr_iSentHead, aOldSlots, aiNewSlots, SServerRequest::E_SRS_SENT);
+  }
+};
+
+// Get valid request from a reference (NULL if it has changed since)
+SServerRequest *CServerRequests::FromRef(const SRef &ref, INDEX iState) {
+  SServerRequest &req = sr_aSlots[ref.iSlot];
+
+  if (req.iState != iState || req.ulSerial != ref.ulSerial) {
+    return NULL;
+  }
+
+  return &req;
+};
+
+// Add a new request or requeue an existing one with the same address
+SServerRequest &CServerRequests::Add(ULONG ulAddress, UWORD uwPort, const char *strPacket) {
+  // Keep the table at most half full, including discarded slots
+  if ((sr_ctActive + sr_ctDiscarded + 1) * 2 > sr_aSlots.Count()) {
+    Rehash((sr_ctActive + 1) * 4);
+  }
+
+  const INDEX iSlot = FindSlot(ulAddress, uwPort, TRUE);
+  ASSERT(iSlot != -1);
+
+  SServerRequest &req = sr_aSlots[iSlot];
+
+  // Replace existing request
+  if (req.IsActive()) {
+    Discard(req);
+  }
+
+  if (req.iState == SServerRequest::E_SRS_DISCARDED) {
+    sr_ctDiscarded--;
+  }
+
+  const ULONG ulSerial = req.ulSerial + 1;
+  req.Clear();
+
+  req.ulAddress = ulAddress;
+  req.uwPort = uwPort;
+  req.strPacket = strPacket;
+  req.iState = SServerRequest::E_SRS_QUEUED;
+  req.ulSerial = ulSerial;
+
+  sr_ctActive++;
+  sr_ctQueued++;
+
+  SRef &ref = sr_aQueued.Push();
+  ref.iSlot = iSlot;
+  ref.ulSerial = ulSerial;
+
+  return req;
+};
+
+// Find active request by its address (NULL if none)
+SServerRequest *CServerRequests::Find(ULONG ulAddress, UWORD uwPort) {
+  const INDEX iSlot = FindSlot(ulAddress, uwPort, FALSE);
+  if (iSlot == -1) return NULL;
+
+  return &sr_aSlots[iSlot];
+};
+
+// Discard an active request and free its slot for reuse
+void CServerRequests::Discard(SServerRequest &req) {
+  if (!req.IsActive()) return;
+
+  if (req.iState == SServerRequest::E_SRS_QUEUED) {
+    sr_ctQueued--;
+  } else {
+    sr_ctSent--;
+  }
+
+  req.iState = SServerRequest::E_SRS_DISCARDED;
+  req.ulSerial++;
+
+  sr_ctActive--;
+  sr_ctDiscarded++;
+};
+
+// Mark request as sent at a specific time
+void CServerRequests::MarkSent(SServerRequest &req, const CTimerValue &tvTime) {
+  ASSERT(req.IsActive());
+
+  if (req.iState == SServerRequest::E_SRS_QUEUED) {
+    sr_ctQueued--;
+    sr_ctSent++;
+  }
+
+  req.iState = SServerRequest::E_SRS_SENT;
+  req.tvRequestTime = tvTime;
+  req.ctSent++;
+  req.ulSerial++;
+
+  SRef &ref = sr_aSent.Push();
+  ref.iSlot = INDEX(&req - &sr_aSlots[0]);
+  ref.ulSerial = req.ulSerial;
+};
+
+// Send a request to its server
+static void SendRequest(SServerRequest &req, SOCKET iSocket) {
+  sockaddr_in sinServer;
+  sinServer.sin_family = AF_INET;
+  sinServer.sin_addr.s_addr = req.ulAddress;
+  sinServer.sin_port = req.uwPort;
+
+  IQuery::SendPacketTo(&sinServer, req.strPacket, (int)strlen(req.strPacket), iSocket);
+};
+
+// Send queued requests and resend or discard expired ones
+BOOL CServerRequests::Update(SOCKET iSocket) {
+  const CTimerValue tvNow = _pTimer->GetHighPrecisionTimer();
+  const DOUBLE dTimeout = ClampDn(ms_fRequestTimeout, 0.05f);
+  const INDEX ctMaxPending = ClampDn(ms_iMaxPendingRequests, (INDEX)1);
+
+  // Go through the oldest sent requests until one that hasn't expired yet
+  while (sr_iSentHead < sr_aSent.Count()) {
+    SServerRequest *preq = FromRef(sr_aSent[sr_iSentHead], SServerRequest::E_SRS_SENT);
+
+    // Already answered or resent
+    if (preq == NULL) {
+      sr_iSentHead++;
+      continue;
+    }
+
+    // Still waiting
+    if ((tvNow - preq->tvRequestTime).GetSeconds() < dTimeout) break;
+
+    sr_iSentHead++;
+
+    // Try again or discard it
+    if (preq->ctSent <= ms_iRequestRetries) {
+      SendRequest(*preq, iSocket);
+      MarkSent(*preq, tvNow);
+
+    } else {
+      if (ms_bDebugOutput) {
+        in_addr addr;
+        addr.s_addr = preq->ulAddress;
+        CPrintF("Server request to %s:%d has timed out\n", inet_ntoa(addr), htons(preq->uwPort));
+      }
+
+      Discard(*preq);
+    }
+  }
+
+  // Send queued requests until the window is full
+  while (sr_ctSent < ctMaxPending && sr_iQueuedHead < sr_aQueued.Count()) {
+    SServerRequest *preq = FromRef(sr_aQueued[sr_iQueuedHead++], SServerRequest::E_SRS_QUEUED);
+    if (preq == NULL) continue;
+
+    SendRequest(*preq, iSocket);
+    MarkSent(*preq, tvNow);
+  }
+
+  CompactRefs(sr_aQueued, sr_iQueuedHead);
+  CompactRefs(sr_aSent, sr_iSentHead);
+
+  return (sr_ctActive > 0);
+};
+
+// Remove all server requests
+void SServerRequest::ClearRequests(void) {
+  CTSingleLock slRequests(&IQuery::csRequests, TRUE);
+  IQuery::aRequests.Clear();
+};
+
+// Add a new server request that's sent out later by UpdateRequests()
+void SServerRequest::AddRequest(const sockaddr_in &addr, const char *strPacket) {
+  CTSingleLock slRequests(&IQuery::csRequests, TRUE);
+  IQuery::aRequests.Add(addr.sin_addr.s_addr, addr.sin_port, strPacket);
+};
+
+// Find server request with a matching the socket address
+SServerRequest *SServerRequest::Find(const sockaddr_in &addr) {
+  CTSingleLock slRequests(&IQuery::csRequests, TRUE);
+  return IQuery::aRequests.Find(addr.sin_addr.s_addr, addr.sin_port);
+};
+
+// Discard server request for this socket address, if there is one
+void SServerRequest::Discard(const sockaddr_in &addr) {
+  CTSingleLock slRequests(&IQuery::csRequests, TRUE);
+  SServerRequest *preq = Find(addr);
+
+  if (preq != NULL) {
+    IQuery::aRequests.Discard(*preq);
+  }
 };
 
 // Get time from a server request and discard it, if found for this socket address
 CTimerValue SServerRequest::PopRequestTime(const sockaddr_in &addr) {
+  CTSingleLock slRequests(&IQuery::csRequests, TRUE);
+
   // Find server request for this socket address
   SServerRequest *preq = Find(addr);
 
-  // If found
-  if (preq != NULL) {
-    // Get its time and clear it
+  // If found and it has been sent
+  if (preq != NULL && preq->iState == E_SRS_SENT) {
+    // Get its time and discard it
     CTimerValue tvTime = preq->tvRequestTime;
-    preq->Clear();
+    IQuery::aRequests.Discard(*preq);
 
     return tvTime;
   }
@@ -61,4 +373,55 @@ CTimerValue SServerRequest::PopRequestTime(const sockaddr_in &addr) {
   return __int64(-1);
 };
 
+// Send queued requests while keeping a limited amount of them in flight and resend timed out ones
+BOOL SServerRequest::UpdateRequests(SOCKET iSocket) {
+  CTSingleLock slRequests(&IQuery::csRequests, TRUE);
+  return IQuery::aRequests.Update(iSocket);
+};
+
+// Replay synthetic replies to measure request matching
+void BenchmarkServerRequests(SHELL_FUNC_ARGS) {
+  BEGIN_SHELL_FUNC;
+  const INDEX ctRequests = ClampDn(NEXT_ARG(INDEX), (INDEX)1);
+
+  CServerRequests aBench;
+
+  const CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  // Queue and "send" requests to synthetic addresses
+  for (INDEX iAdd = 0; iAdd < ctRequests; iAdd++) {
+    const ULONG ulAddress = 0x0A000000 | ULONG(iAdd * 7919);
+    SServerRequest &req = aBench.Add(ulAddress, UWORD(25601 + iAdd % 21), "\\status\\");
+    aBench.MarkSent(req, tvStart);
+  }
+
+  const CTimerValue tvSent = _pTimer->GetHighPrecisionTimer();
+
+  // Receive replies in a scrambled order
+  ULONG ulRandom = 12345;
+  INDEX ctMatched = 0;
+
+  for (INDEX iReply = 0; iReply < ctRequests; iReply++) {
+    ulRandom = ulRandom * 1103515245UL + 12345UL;
+    const INDEX iServer = (iReply + (ulRandom >> 16)) % ctRequests;
+
+    const ULONG ulAddress = 0x0A000000 | ULONG(iServer * 7919);
+    SServerRequest *preq = aBench.Find(ulAddress, UWORD(25601 + iServer % 21));
+
+    if (preq != NULL && preq->iState == SServerRequest::E_SRS_SENT) {
+      aBench.Discard(*preq);
+      ctMatched++;
+    }
+  }
+
+  const CTimerValue tvEnd = _pTimer->GetHighPrecisionTimer();
+
+  const DOUBLE dAdd = (tvSent - tvStart).GetSeconds() * 1000.0;
+  const DOUBLE dMatch = (tvEnd - tvSent).GetSeconds() * 1000.0;
+
+  CPrintF(TRANS("%d requests added in %.3f ms\n"), ctRequests, dAdd);
+  CPrintF(TRANS("%d replies (%d matched) in %.3f ms (%.3f us per reply)\n"),
+    ctRequests, ctMatched, dMatch, dMatch * 1000.0 / ctRequests);
+};
+
 #endif // _PATCHCONFIG_NEW_QUERY
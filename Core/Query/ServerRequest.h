@@ -22,30 +22,118 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 // Server request for receiving server pings
 struct SServerRequest {
+  // Request states
+  enum EState {
+    E_SRS_FREE = 0, // Never used
+    E_SRS_DISCARDED, // Answered or expired (can be reused)
+    E_SRS_QUEUED,   // Waiting to be sent
+    E_SRS_SENT,     // Waiting for a reply
+  };
+
   ULONG ulAddress;
   UWORD uwPort;
   CTimerValue tvRequestTime;
 
+  INDEX iState; // Current request state
+  INDEX ctSent; // How many times the request has been sent
+  ULONG ulSerial; // Changed on every state change to invalidate old references to the request
+  const char *strPacket; // Packet to send to the server (must be a static string)
+
   // Constructor
   SServerRequest() {
     Clear();
+    ulSerial = 0;
   };
 
-  // Clear data in the dynamic stack array
+  // Clear request data
   void Clear(void) {
     ulAddress = 0;
     uwPort = 0;
     tvRequestTime.Clear();
+
+    iState = E_SRS_FREE;
+    ctSent = 0;
+    strPacket = NULL;
+  };
+
+  // Check if the request is in use
+  inline BOOL IsActive(void) const {
+    return (iState == E_SRS_QUEUED || iState == E_SRS_SENT);
   };
 
-  // Add a new server request
-  static void AddRequest(const sockaddr_in &addr);
+  // Remove all server requests
+  static void ClearRequests(void);
+
+  // Add a new server request that's sent out later by UpdateRequests()
+  static void AddRequest(const sockaddr_in &addr, const char *strPacket);
 
   // Find server request with a matching the socket address
+  // NOTE: Keep IQuery::csRequests locked while using the returned request
   static SServerRequest *Find(const sockaddr_in &addr);
 
+  // Discard server request for this socket address, if there is one
+  static void Discard(const sockaddr_in &addr);
+
   // Get time from a server request and discard it, if found for this socket address
   static CTimerValue PopRequestTime(const sockaddr_in &addr);
+
+  // Send queued requests while keeping a limited amount of them in flight and resend timed out ones
+  // Returns TRUE if there are any requests that are still waiting to be sent or answered
+  static BOOL UpdateRequests(SOCKET iSocket = INVALID_SOCKET);
+};
+
+// Table of server requests with quick lookups by address and port
+class CServerRequests {
+  public:
+    // Reference to a request in some slot
+    struct SRef {
+      INDEX iSlot;
+      ULONG ulSerial;
+    };
+
+    CStaticArray<SServerRequest> sr_aSlots; // Open addressing hash table
+    INDEX sr_ctActive;    // Queued and sent requests
+    INDEX sr_ctDiscarded; // Discarded requests that occupy slots
+    INDEX sr_ctQueued;    // Requests waiting to be sent
+    INDEX sr_ctSent;      // Requests waiting for replies
+
+    CStaticStackArray<SRef> sr_aQueued; // Queued requests in order of adding
+    INDEX sr_iQueuedHead;
+
+    CStaticStackArray<SRef> sr_aSent; // Sent requests in order of sending
+    INDEX sr_iSentHead;
+
+  public:
+    // Constructor
+    CServerRequests();
+
+    // Remove all requests
+    void Clear(void);
+
+    // Add a new request or requeue an existing one with the same address
+    SServerRequest &Add(ULONG ulAddress, UWORD uwPort, const char *strPacket);
+
+    // Find active request by its address (NULL if none)
+    SServerRequest *Find(ULONG ulAddress, UWORD uwPort);
+
+    // Discard an active request and free its slot for reuse
+    void Discard(SServerRequest &req);
+
+    // Mark request as sent at a specific time
+    void MarkSent(SServerRequest &req, const CTimerValue &tvTime);
+
+    // Send queued requests and resend or discard expired ones
+    BOOL Update(SOCKET iSocket);
+
+  private:
+    // Find slot for a specific address (either with this address, or the first reusable one)
+    INDEX FindSlot(ULONG ulAddress, UWORD uwPort, BOOL bForAdding) const;
+
+    // Resize the table and drop all discarded requests
+    void Rehash(INDEX ctMinSlots);
+
+    // Get valid request from a reference (NULL if it has changed since)
+    SServerRequest *FromRef(const SRef &ref, INDEX iState);
 };
 
 #endif
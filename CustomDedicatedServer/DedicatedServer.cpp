@@ -25,6 +25,9 @@ FLOAT ded_tmTimeout = -1;
 // [Cecil] Change level of the current round mid-game
 CTString ded_strForceLevelChange = "";
 
+// [Cecil] Wait for incoming packets between frames instead of sleeping
+INDEX ded_bWaitForPackets = TRUE;
+
 // Break/close handler
 BOOL WINAPI HandlerRoutine(DWORD dwCtrlType)
 {
@@ -133,6 +136,9 @@ BOOL Init(int argc, char *argv[])
 
   // [Cecil] Custom symbols
   _pShell->DeclareSymbol("user CTString ded_strForceLevelChange;", &ded_strForceLevelChange);
+  _pShell->DeclareSymbol("persistent user INDEX ded_bWaitForPackets;", &ded_bWaitForPackets);
+  _pShell->DeclareSymbol("user void ded_PrintLoopStats(void);", &PrintLoopStats);
+  _pShell->DeclareSymbol("user void ded_ResetLoopStats(void);", &ResetLoopStats);
 
   // [Cecil] Load Game library as a module
   GetPluginAPI()->LoadGameLib("Data\\DedicatedServer.gms");
@@ -17,6 +17,11 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 // [Cecil] Classics Patch
 #include <Core/Networking/Modules/VotingSystem.h>
+#include <Core/Networking/CommInterface.h>
+
+#if _PATCHCONFIG_NEW_QUERY
+  #include <Core/Query/QueryManager.h>
+#endif
 
 // Game state properties
 INDEX _iRound = 1;
@@ -145,6 +150,121 @@ BOOL StartNewMap(void) {
   return TRUE;
 };
 
+// [Cecil] Reasons for the main loop to wake up
+enum ELoopWake {
+  LW_PACKET = 0, // Incoming packet
+  LW_TICK,       // Next simulation tick is due
+  LW_FRAME,      // Frame time limit has passed
+  LW_SLEEP,      // Slept through the frame without sockets
+  LW_BUSY,       // Frame took too long to wait at all
+
+  LW_MAX,
+};
+
+static const char *_astrLoopWakeNames[LW_MAX] = {
+  "packet", "tick", "frame", "sleep", "busy",
+};
+
+// [Cecil] Main loop timing statistics
+struct SLoopStats {
+  INDEX ctFrames;
+  INDEX actWakes[LW_MAX];
+
+  // Delay between simulation ticks compared to the tick quantum
+  INDEX ctTicks;
+  DOUBLE dJitterSum;
+  DOUBLE dJitterMax;
+
+  // Delay of waking up after the wanted time
+  INDEX ctLateWakes;
+  DOUBLE dLateSum;
+  DOUBLE dLateMax;
+};
+
+static SLoopStats _lsStats;
+
+// [Cecil] Time of the last observed simulation tick
+static CTimerValue _tvLastTick;
+static TIME _tmLastTick = -1.0f;
+
+// [Cecil] Reset main loop timing statistics
+void ResetLoopStats(void) {
+  memset(&_lsStats, 0, sizeof(_lsStats));
+};
+
+// [Cecil] Print main loop timing statistics
+void PrintLoopStats(void) {
+  const SLoopStats &ls = _lsStats;
+
+  CPrintF(TRANS("Main loop: %d frames (%s)\n"), ls.ctFrames, ded_bWaitForPackets ? TRANS("waiting for packets") : TRANS("sleeping"));
+
+  for (INDEX i = 0; i < LW_MAX; i++) {
+    CPrintF("  %-6s : %d\n", _astrLoopWakeNames[i], ls.actWakes[i]);
+  }
+
+  if (ls.ctTicks > 0) {
+    CPrintF(TRANS("Tick jitter: %.3f ms average, %.3f ms max (%d ticks)\n"),
+      ls.dJitterSum / ls.ctTicks * 1000.0, ls.dJitterMax * 1000.0, ls.ctTicks);
+  }
+
+  if (ls.ctLateWakes > 0) {
+    CPrintF(TRANS("Late wakes: %.3f ms average, %.3f ms max (%d wakes)\n"),
+      ls.dLateSum / ls.ctLateWakes * 1000.0, ls.dLateMax * 1000.0, ls.ctLateWakes);
+  }
+};
+
+// [Cecil] Remember when the server has processed a new simulation tick
+static void ObserveSimulationTick(const CTimerValue &tvNow) {
+  if (!_pNetwork->IsServer()) {
+    _tmLastTick = -1.0f;
+    return;
+  }
+
+  const TIME tmTick = _pNetwork->ga_srvServer.srv_tmLastProcessedTick;
+  if (tmTick == _tmLastTick) return;
+
+  // Measure how far apart processed ticks are from the expected quantum
+  if (_tmLastTick >= 0.0f && tmTick > _tmLastTick) {
+    const DOUBLE dExpected = tmTick - _tmLastTick;
+    const DOUBLE dJitter = Abs((tvNow - _tvLastTick).GetSeconds() - dExpected);
+
+    _lsStats.ctTicks++;
+    _lsStats.dJitterSum += dJitter;
+    _lsStats.dJitterMax = Max(_lsStats.dJitterMax, dJitter);
+  }
+
+  _tmLastTick = tmTick;
+  _tvLastTick = tvNow;
+};
+
+// [Cecil] Gather sockets that can receive packets for the server
+static INDEX GetServerSockets(fd_set &fdsRead) {
+  FD_ZERO(&fdsRead);
+  INDEX ctSockets = 0;
+
+#if SE1_VER >= SE1_107
+  // Game socket
+  CCommunicationInterface &cci = GetComm();
+
+  if (cci.cci_bServerInitialized && cci.cci_hSocket != INVALID_SOCKET) {
+    FD_SET(cci.cci_hSocket, &fdsRead);
+    ctSockets++;
+  }
+#endif
+
+#if _PATCHCONFIG_NEW_QUERY
+  // Query socket
+  SOCKET hQuery = IQuery::GetSocket();
+
+  if (hQuery != INVALID_SOCKET) {
+    FD_SET(hQuery, &fdsRead);
+    ctSockets++;
+  }
+#endif
+
+  return ctSockets;
+};
+
 // Limit current frame rate if neeeded
 static void LimitFrameRate(void) {
   // measure passed time for each loop
@@ -153,16 +273,59 @@ static void LimitFrameRate(void) {
   CTimerValue tvNow = _pTimer->GetHighPrecisionTimer();
   TIME tmCurrentDelta = (tvNow - tvLast).GetSeconds();
 
+  _lsStats.ctFrames++;
+  ObserveSimulationTick(tvNow);
+
   // limit maximum frame rate
   ded_iMaxFPS = ClampDn(ded_iMaxFPS, 1L);
   TIME tmWantedDelta = 1.0f / ded_iMaxFPS;
 
-  if (tmCurrentDelta < tmWantedDelta) {
-    Sleep((tmWantedDelta - tmCurrentDelta) * 1000.0f);
+  // [Cecil] How long to wait until the next frame
+  DOUBLE dWait = tmWantedDelta - tmCurrentDelta;
+  INDEX eWake = LW_FRAME;
+
+  // [Cecil] Don't wait past the next simulation tick
+  if (_tmLastTick >= 0.0f && !_pNetwork->IsPaused()) {
+    const DOUBLE dUntilTick = _pTimer->TickQuantum - (tvNow - _tvLastTick).GetSeconds();
+
+    if (dUntilTick < dWait) {
+      dWait = dUntilTick;
+      eWake = LW_TICK;
+    }
+  }
+
+  fd_set fdsRead;
+
+  if (dWait <= 0.0) {
+    eWake = LW_BUSY;
+
+  // [Cecil] Wake up as soon as any packet arrives
+  } else if (ded_bWaitForPackets && GetServerSockets(fdsRead) > 0) {
+    timeval tvWait;
+    tvWait.tv_sec = 0;
+    tvWait.tv_usec = long(dWait * 1000000.0);
+
+    if (select(0, &fdsRead, NULL, NULL, &tvWait) > 0) {
+      eWake = LW_PACKET;
+    }
+
+  } else {
+    Sleep(DWORD(dWait * 1000.0));
+    eWake = LW_SLEEP;
   }
 
   // remember new time
   tvLast = _pTimer->GetHighPrecisionTimer();
+  _lsStats.actWakes[eWake]++;
+
+  // [Cecil] Measure how late the wait has ended
+  if (eWake != LW_PACKET && eWake != LW_BUSY) {
+    const DOUBLE dLate = ClampDn((tvLast - tvNow).GetSeconds() - dWait, 0.0);
+
+    _lsStats.ctLateWakes++;
+    _lsStats.dLateSum += dLate;
+    _lsStats.dLateMax = Max(_lsStats.dLateMax, dLate);
+  }
 };
 
 // Main game loop
@@ -31,3 +31,9 @@ BOOL StartNewMap(void);
 
 // Main game loop
 void DoGame(void);
+
+// [Cecil] Reset main loop timing statistics
+void ResetLoopStats(void);
+
+// [Cecil] Print main loop timing statistics
+void PrintLoopStats(void);
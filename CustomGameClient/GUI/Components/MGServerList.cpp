@@ -53,9 +53,18 @@ CMGServerList::CMGServerList() {
   // by default, sort by ping, best on top
   mg_iSort = 2;
   mg_bSortDown = FALSE;
+
+  // [Cecil] Empty view
+  mg_iViewSort = -1;
+  mg_bViewSortDown = FALSE;
+
+  for (INDEX i = 0; i < ARRAYCOUNT(mg_aFilters); i++) {
+    mg_aFilters[i].iCompare = 0;
+    mg_aFilters[i].iValue = 0;
+  }
 }
 void CMGServerList::AdjustFirstOnScreen(void) {
-  INDEX ctSessions = _lhServers.Count();
+  INDEX ctSessions = mg_apnsView.Count();
   mg_iSelected = Clamp(mg_iSelected, 0L, ClampDn(ctSessions - 1L, 0L));
   mg_iFirstOnScreen = Clamp(mg_iFirstOnScreen, 0L, ClampDn(ctSessions - mg_ctOnScreen, 0L));
 
@@ -96,55 +105,164 @@ int CompareSessions(const void *pv0, const void *pv1) {
 
 extern CMGButton mgServerColumn[7];
 extern CMGEdit mgServerFilter[7];
+extern CTString _strServerFilter[7];
+
+// [Cecil] Comparison operators for number filters
+enum EFilterCompare {
+  FLT_NONE = 0,
+  FLT_LESS,
+  FLT_LESSEQUAL,
+  FLT_GREATER,
+  FLT_GREATEREQUAL,
+  FLT_EQUAL,
+};
 
-void SortAndFilterServers(void) {
-  {FORDELETELIST(CNetworkSession, ns_lnNode, _lhServers, itns) {
-    delete &*itns;
-  }}
+// [Cecil] Compile filter text for some column
+static void CompileFilter(CMGServerList::Filter &flt, const CTString &strFilter, INDEX iColumn) {
+  flt.strSource = strFilter;
+  flt.strPattern = "";
+  flt.iCompare = FLT_NONE;
+  flt.iValue = 0;
+
+  if (strFilter == "") return;
+
+  // Text columns
+  if (iColumn != 2 && iColumn != 3) {
+    flt.strPattern = "*" + strFilter + "*";
+    return;
+  }
+
+  // Number columns (ping & players)
+  char strCompare[3] = { 0, 0, 0 };
+  int iValue = 0;
+  sscanf(strFilter.str_String, "%2[<>= ]%d", strCompare, &iValue);
+
+  // Ignore spaces around the operator
+  CTString strOperator = strCompare;
+  strOperator.TrimSpacesLeft();
+  strOperator.TrimSpacesRight();
+
+  if      (strOperator == "<")  flt.iCompare = FLT_LESS;
+  else if (strOperator == "<=") flt.iCompare = FLT_LESSEQUAL;
+  else if (strOperator == ">")  flt.iCompare = FLT_GREATER;
+  else if (strOperator == ">=") flt.iCompare = FLT_GREATEREQUAL;
+  else if (strOperator == "=")  flt.iCompare = FLT_EQUAL;
+
+  flt.iValue = iValue;
+};
 
-  {FOREACHINLIST(CNetworkSession, ns_lnNode, _pNetwork->ga_lhEnumeratedSessions, itns) {
-    CNetworkSession &ns = *itns;
-    extern CTString _strServerFilter[7];
-    if (_strServerFilter[0] != "" && !ns.ns_strSession.Matches("*" + _strServerFilter[0] + "*")) continue;
-    if (_strServerFilter[1] != "" && !ns.ns_strWorld.Matches("*" + _strServerFilter[1] + "*")) continue;
-    if (_strServerFilter[2] != "") {
-      char strCompare[3] = { 0, 0, 0 };
-      int iPing = 0;
-      _strServerFilter[2].ScanF("%2[< >= ]%d", strCompare, &iPing);
-      if (strcmp(strCompare, "<") == 0 && !(int(ns.ns_tmPing * 1000) < iPing)) continue;
-      if (strcmp(strCompare, " <= ") == 0 && !(int(ns.ns_tmPing * 1000) <= iPing)) continue;
-      if (strcmp(strCompare, ">") == 0 && !(int(ns.ns_tmPing * 1000) > iPing)) continue;
-      if (strcmp(strCompare, " >= ") == 0 && !(int(ns.ns_tmPing * 1000) >= iPing)) continue;
-      if (strcmp(strCompare, "=") == 0 && !(int(ns.ns_tmPing * 1000) == iPing)) continue;
+// [Cecil] Check if a number passes the filter
+static BOOL CompareFilter(const CMGServerList::Filter &flt, INDEX iNumber) {
+  switch (flt.iCompare) {
+    case FLT_LESS:         return iNumber <  flt.iValue;
+    case FLT_LESSEQUAL:    return iNumber <= flt.iValue;
+    case FLT_GREATER:      return iNumber >  flt.iValue;
+    case FLT_GREATEREQUAL: return iNumber >= flt.iValue;
+    case FLT_EQUAL:        return iNumber == flt.iValue;
+  }
+
+  return TRUE;
+};
+
+// [Cecil] Check if a session passes all filters
+static BOOL MatchesFilters(const CMGServerList::Filter *aFilters, const CNetworkSession &ns) {
+  if (aFilters[0].strPattern != "" && !ns.ns_strSession.Matches(aFilters[0].strPattern)) return FALSE;
+  if (aFilters[1].strPattern != "" && !ns.ns_strWorld.Matches(aFilters[1].strPattern)) return FALSE;
+  if (!CompareFilter(aFilters[2], int(ns.ns_tmPing * 1000))) return FALSE;
+  if (!CompareFilter(aFilters[3], ns.ns_ctPlayers)) return FALSE;
+  if (aFilters[4].strPattern != "" && !ns.ns_strGameType.Matches(aFilters[4].strPattern)) return FALSE;
+#if SE1_GAME != SS_REV
+  if (aFilters[5].strPattern != "" && !ns.ns_strMod.Matches(aFilters[5].strPattern)) return FALSE;
+#endif
+  if (aFilters[6].strPattern != "" && !ns.ns_strVer.Matches(aFilters[6].strPattern)) return FALSE;
+
+  return TRUE;
+};
+
+// [Cecil] Check if an enumerated session is still the same as the listing
+static inline BOOL SameListing(const CMGServerList::Listing &l, CNetworkSession &ns) {
+  return l.pns == &ns && l.tmPing == ns.ns_tmPing && l.ctPlayers == ns.ns_ctPlayers;
+};
+
+// [Cecil] Update the view if sessions, filters or sorting have changed
+void CMGServerList::UpdateView(void) {
+  BOOL bRebuild = FALSE;
+
+  // Recompile changed filters
+  for (INDEX iFilter = 0; iFilter < ARRAYCOUNT(mg_aFilters); iFilter++) {
+    if (mg_aFilters[iFilter].strSource != _strServerFilter[iFilter]) {
+      CompileFilter(mg_aFilters[iFilter], _strServerFilter[iFilter], iFilter);
+      bRebuild = TRUE;
     }
-    if (_strServerFilter[3] != "") {
-      char strCompare[3] = { 0, 0, 0 };
-      int iPlayers = 0;
-      _strServerFilter[3].ScanF("%2[< >= ]%d", strCompare, &iPlayers);
-      if (strcmp(strCompare, "<") == 0 && !(ns.ns_ctPlayers < iPlayers)) continue;
-      if (strcmp(strCompare, " <= ") == 0 && !(ns.ns_ctPlayers <= iPlayers)) continue;
-      if (strcmp(strCompare, ">") == 0 && !(ns.ns_ctPlayers > iPlayers)) continue;
-      if (strcmp(strCompare, " >= ") == 0 && !(ns.ns_ctPlayers >= iPlayers)) continue;
-      if (strcmp(strCompare, "=") == 0 && !(ns.ns_ctPlayers == iPlayers)) continue;
+  }
+
+  CListHead &lhSessions = _pNetwork->ga_lhEnumeratedSessions;
+
+  // Count sessions that haven't changed since the last update
+  const INDEX ctListings = mg_aListings.Count();
+  INDEX ctSame = 0;
+  INDEX ctSessions = 0;
+
+  {FOREACHINLIST(CNetworkSession, ns_lnNode, lhSessions, itns) {
+    if (ctSame == ctSessions && ctSame < ctListings && SameListing(mg_aListings[ctSame], *itns)) {
+      ctSame++;
     }
-    if (_strServerFilter[4] != "" && !ns.ns_strGameType.Matches("*" + _strServerFilter[4] + "*")) continue;
-  #if SE1_GAME != SS_REV
-    if (_strServerFilter[5] != "" && !ns.ns_strMod.Matches("*" + _strServerFilter[5] + "*")) continue;
-  #endif
-    if (_strServerFilter[6] != "" && !ns.ns_strVer.Matches("*" + _strServerFilter[6] + "*")) continue;
 
-    CNetworkSession *pnsNew = new CNetworkSession;
-    pnsNew->Copy(*itns);
-    _lhServers.AddTail(pnsNew->ns_lnNode);
+    ctSessions++;
   }}
 
-  _lhServers.Sort(CompareSessions, offsetof(CNetworkSession, ns_lnNode));
-}
+  // Some sessions have been removed or updated
+  if (ctSame < ctListings) {
+    bRebuild = TRUE;
+  }
+
+  const BOOL bResort = (bRebuild || ctSessions > ctListings || mg_iViewSort != mg_iSort || mg_bViewSortDown != mg_bSortDown);
+
+  // Nothing has changed
+  if (!bResort) return;
+
+  // Start over or only add new sessions at the end
+  INDEX iFirstNew = ctListings;
+
+  if (bRebuild) {
+    mg_aListings.PopAll();
+    mg_apnsView.PopAll();
+    iFirstNew = 0;
+  }
+
+  if (ctSessions > iFirstNew) {
+    INDEX iSession = 0;
+
+    FOREACHINLIST(CNetworkSession, ns_lnNode, lhSessions, itns) {
+      if (iSession++ < iFirstNew) continue;
+
+      CNetworkSession &ns = *itns;
+
+      Listing &l = mg_aListings.Push();
+      l.pns = &ns;
+      l.tmPing = ns.ns_tmPing;
+      l.ctPlayers = ns.ns_ctPlayers;
+
+      if (MatchesFilters(mg_aFilters, ns)) {
+        mg_apnsView.Push() = &ns;
+      }
+    }
+  }
+
+  // Sort the view
+  mg_iViewSort = mg_iSort;
+  mg_bViewSortDown = mg_bSortDown;
+
+  if (mg_apnsView.Count() > 1) {
+    _iSort = mg_iSort;
+    _bSortDown = mg_bSortDown;
+    qsort(&mg_apnsView[0], mg_apnsView.Count(), sizeof(CNetworkSession *), CompareSessions);
+  }
+};
 
 void CMGServerList::Render(CDrawPort *pdp) {
-  _iSort = mg_iSort;
-  _bSortDown = mg_bSortDown;
-  SortAndFilterServers();
+  // [Cecil] Only update the view when something changes
+  UpdateView();
 
   // [Cecil] Medium text scale
   const FLOAT fTextScale = 0.65f;
@@ -171,7 +289,7 @@ void CMGServerList::Render(CDrawPort *pdp) {
   PIX pixSliderSizeI = 10 * fScaling;
   PIX pixOuterMargin = 20;
 
-  INDEX ctSessions = _lhServers.Count();
+  INDEX ctSessions = mg_apnsView.Count();
   INDEX iSession = 0;
 
   INDEX ctColumns[7];
@@ -267,7 +385,7 @@ void CMGServerList::Render(CDrawPort *pdp) {
   mg_ctOnScreen = ctSessionsOnScreen;
   AdjustFirstOnScreen();
 
-  if (_lhServers.Count() == 0) {
+  if (mg_apnsView.Count() == 0) {
     if (_pNetwork->ga_strEnumerationStatus != "") {
       mg_bFocused = TRUE;
       COLOR colItem = GetCurrentColor();
@@ -275,13 +393,11 @@ void CMGServerList::Render(CDrawPort *pdp) {
                  apixSeparatorI[1] - apixSeparatorI[0], LOCALIZE("searching..."), colItem, TRUE);
     }
   } else {
-    FOREACHINLIST(CNetworkSession, ns_lnNode, _lhServers, itns) {
-      CNetworkSession &ns = *itns;
+    // [Cecil] Only go through sessions on screen
+    const INDEX iLastOnScreen = Min(mg_iFirstOnScreen + ctSessionsOnScreen, ctSessions);
 
-      if (iSession < mg_iFirstOnScreen || iSession >= mg_iFirstOnScreen + ctSessionsOnScreen) {
-        iSession++;
-        continue;
-      }
+    for (iSession = mg_iFirstOnScreen; iSession < iLastOnScreen; iSession++) {
+      CNetworkSession &ns = *mg_apnsView[iSession];
 
       PIX pixJ = pixListTopJ + (iSession - mg_iFirstOnScreen) * pixCharSizeJ + pixLineSize + 1;
 
@@ -328,8 +444,6 @@ void CMGServerList::Render(CDrawPort *pdp) {
                    apixSeparatorI[iTab + 1] - apixSeparatorI[iTab] - pixCharSizeI,
                    astrEntries[iTab], colItem, abUndecorate[iTab]);
       }
-
-      iSession++;
     }
   }
 
@@ -365,7 +479,7 @@ PIXaabbox2D CMGServerList::GetScrollBarFullBox(void) {
 }
 
 PIXaabbox2D CMGServerList::GetScrollBarHandleBox(void) {
-  return GetSliderBox(mg_iFirstOnScreen, mg_ctOnScreen, _lhServers.Count(), GetScrollBarFullBox());
+  return GetSliderBox(mg_iFirstOnScreen, mg_ctOnScreen, mg_apnsView.Count(), GetScrollBarFullBox());
 }
 
 void CMGServerList::OnMouseOver(PIX pixI, PIX pixJ) {
@@ -375,7 +489,7 @@ void CMGServerList::OnMouseOver(PIX pixI, PIX pixJ) {
   BOOL bInSlider = (pixI >= mg_pixSBMinI && pixI <= mg_pixSBMaxI && pixJ >= mg_pixSBMinJ && pixJ <= mg_pixSBMaxJ);
   if (mg_pixDragJ >= 0 && bInSlider) {
     PIX pixDelta = pixJ - mg_pixDragJ;
-    INDEX ctSessions = _lhServers.Count();
+    INDEX ctSessions = mg_apnsView.Count();
     INDEX iWantedLine = mg_iDragLine + SliderPixToIndex(pixDelta, mg_ctOnScreen, ctSessions, GetScrollBarFullBox());
     mg_iFirstOnScreen = Clamp(iWantedLine, 0L, ClampDn(ctSessions - mg_ctOnScreen, 0L));
     mg_iSelected = Clamp(mg_iSelected, mg_iFirstOnScreen, mg_iFirstOnScreen + mg_ctOnScreen - 1L);
@@ -451,22 +565,19 @@ BOOL CMGServerList::OnKeyDown(PressedMenuButton pmb) {
     PlayMenuSound(_psdPress);
     IFeel_PlayEffect("Menu_press");
 
-    INDEX i = 0;
+    // [Cecil] Make sure the view isn't outdated
+    UpdateView();
 
-    FOREACHINLIST(CNetworkSession, ns_lnNode, _lhServers, itns) {
-      if (i == mg_iSelected) {
-        char strAddress[256];
-        int iPort;
-        itns->ns_strAddress.ScanF("%200[^:]:%d", &strAddress, &iPort);
-        _pGame->gam_strJoinAddress = strAddress;
-        _pShell->SetINDEX("net_iPort", iPort);
+    if (mg_iSelected >= 0 && mg_iSelected < mg_apnsView.Count()) {
+      char strAddress[256];
+      int iPort;
+      mg_apnsView[mg_iSelected]->ns_strAddress.ScanF("%200[^:]:%d", &strAddress, &iPort);
+      _pGame->gam_strJoinAddress = strAddress;
+      _pShell->SetINDEX("net_iPort", iPort);
 
-        extern void StartJoinServerMenu(void);
-        StartJoinServerMenu();
-        return TRUE;
-      }
-
-      i++;
+      extern void StartJoinServerMenu(void);
+      StartJoinServerMenu();
+      return TRUE;
     }
 
     // [Cecil] NOTE: It skipped to the end with TRUE before, so not sure
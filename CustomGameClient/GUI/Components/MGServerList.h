@@ -23,6 +23,21 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 class CMGServerList : public CMGButton {
   public:
+    // [Cecil] Column filter compiled from its text
+    struct Filter {
+      CTString strSource;  // Text that the filter has been compiled from
+      CTString strPattern; // Wildcard pattern for text columns
+      INDEX iCompare;      // Comparison operator for number columns
+      INDEX iValue;        // Number to compare with
+    };
+
+    // [Cecil] Enumerated session as it was during the last view update
+    struct Listing {
+      CNetworkSession *pns;
+      FLOAT tmPing;
+      INDEX ctPlayers;
+    };
+
     INDEX mg_iSelected;
     INDEX mg_iFirstOnScreen;
     INDEX mg_ctOnScreen;
@@ -52,6 +67,13 @@ class CMGServerList : public CMGButton {
     INDEX mg_iSort;    // column to sort by
     BOOL mg_bSortDown; // sort in reverse order
 
+    // [Cecil] Persistent view of enumerated sessions
+    Filter mg_aFilters[7];
+    CStaticStackArray<Listing> mg_aListings; // Enumerated sessions in list order
+    CStaticStackArray<CNetworkSession *> mg_apnsView; // Filtered and sorted sessions
+    INDEX mg_iViewSort;
+    BOOL mg_bViewSortDown;
+
     CMGServerList();
     BOOL OnKeyDown(PressedMenuButton pmb);
     BOOL OnKeyUp(PressedMenuButton pmb); // [Cecil]
@@ -62,6 +84,9 @@ class CMGServerList : public CMGButton {
     void Render(CDrawPort *pdp);
     void AdjustFirstOnScreen(void);
     void OnMouseOver(PIX pixI, PIX pixJ);
+
+    // [Cecil] Update the view if sessions, filters or sorting have changed
+    void UpdateView(void);
 };
 
 #endif /* include-once check. */
\ No newline at end of file
@@ -40,7 +40,6 @@ extern BOOL _bPlayerMenuFromSinglePlayer = FALSE;
 
 GameMode _gmMenuGameMode = GM_NONE;
 GameMode _gmRunningGameMode = GM_NONE;
-CListHead _lhServers;
 
 void OnPlayerSelect(void);
 
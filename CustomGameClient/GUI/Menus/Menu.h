@@ -134,8 +134,6 @@ extern void PlayMenuSound(CSoundData *psd, BOOL bOverOtherSounds = TRUE);
 // [Cecil] Amount of supported local players
 #define MAX_GAME_LOCAL_PLAYERS Min((INDEX)GetGameAPI()->GetLocalPlayerCount(), (INDEX)4)
 
-extern CListHead _lhServers;
-
 extern INDEX _iLocalPlayer;
 
 enum GameMode {
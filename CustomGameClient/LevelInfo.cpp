@@ -146,6 +146,323 @@ int qsort_CompareLevels(const void *elem1, const void *elem2) {
   return strcmp(li1.li_fnLevel, li2.li_fnLevel);
 }
 
+// [Cecil] Level metadata cache
+static const CTString _strLevelCacheFile = "Data\\ClassicsPatch\\LevelCache.dat";
+static const INDEX _iLevelCacheVersion = 1;
+
+// [Cecil] How much of the beginning of a level file to read for its info
+#define LEVEL_HEADER_SIZE 4096
+
+// [Cecil] Level info together with the state of the file it has been read from
+struct SLevelCacheEntry {
+  CTFileName fnmLevel;
+  ULONG ulSize;    // File size
+  ULONG ulStamp;   // Last write time of the file on disk or CRC of the file in an archive
+  ULONG ulStampHi; // Upper part of the last write time
+
+  INDEX iResult;     // 1 - valid level, 0 - invalid level, -1 - couldn't be read
+  CTString strName;  // Untranslated level name
+  ULONG ulSpawnFlags;
+  INDEX iFormat;     // Format from the level itself (-1 if it doesn't specify one)
+
+  // Where to read the file from
+  CTFileName fnmFull; // Full path on disk
+  INDEX iZipFile;     // Index of the file in archives (-1 if on disk)
+
+  SLevelCacheEntry() : ulSize(0), ulStamp(0), ulStampHi(0), iResult(-1),
+    ulSpawnFlags(0), iFormat(-1), iZipFile(-1)
+  {
+  };
+
+  // Check if the file is in the same state as a cached one
+  inline BOOL SameFile(const SLevelCacheEntry &le) const {
+    return ulSize == le.ulSize && ulStamp == le.ulStamp && ulStampHi == le.ulStampHi;
+  };
+};
+
+// [Cecil] Read level cache from the disk
+static void LoadLevelCache(CStaticStackArray<SLevelCacheEntry> &aCache) {
+  if (!FileExists(_strLevelCacheFile)) return;
+
+  try {
+    CTFileStream strm;
+    strm.Open_t(_strLevelCacheFile);
+
+    strm.ExpectID_t("LVLC"); // LeVeL Cache
+
+    INDEX iVersion, ctEntries;
+    strm >> iVersion;
+
+    // Outdated cache
+    if (iVersion != _iLevelCacheVersion) return;
+
+    strm >> ctEntries;
+
+    for (INDEX i = 0; i < ctEntries; i++) {
+      SLevelCacheEntry &le = aCache.Push();
+      strm >> le.fnmLevel >> le.ulSize >> le.ulStamp >> le.ulStampHi;
+      strm >> le.iResult >> le.strName >> le.ulSpawnFlags >> le.iFormat;
+    }
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot load level cache: %s\n"), strError);
+    aCache.PopAll();
+  }
+};
+
+// [Cecil] Write level cache onto the disk
+static void SaveLevelCache(CStaticArray<SLevelCacheEntry> &aLevels) {
+  // Make sure the directory exists
+  IDir::CreateDir(_strLevelCacheFile);
+
+  try {
+    CTFileStream strm;
+    strm.Create_t(_strLevelCacheFile);
+
+    strm.WriteID_t("LVLC"); // LeVeL Cache
+    strm << _iLevelCacheVersion;
+
+    // Only cache levels that have been read properly
+    INDEX ctEntries = 0;
+    INDEX i;
+
+    for (i = 0; i < aLevels.Count(); i++) {
+      if (aLevels[i].iResult != -1) ctEntries++;
+    }
+
+    strm << ctEntries;
+
+    for (i = 0; i < aLevels.Count(); i++) {
+      SLevelCacheEntry &le = aLevels[i];
+      if (le.iResult == -1) continue;
+
+      strm << le.fnmLevel << le.ulSize << le.ulStamp << le.ulStampHi;
+      strm << le.iResult << le.strName << le.ulSpawnFlags << le.iFormat;
+    }
+
+    strm.Close();
+
+  } catch (char *strError) {
+    CPrintF(TRANS("Cannot save level cache: %s\n"), strError);
+  }
+};
+
+// [Cecil] Determine where a level file is and what state it's in
+static BOOL ResolveLevelFile(SLevelCacheEntry &le) {
+  const INDEX iType = ExpandFilePath(EFP_READ, le.fnmLevel, le.fnmFull);
+
+  // Regular file on disk
+  if (iType == EFP_FILE) {
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+    if (!GetFileAttributesExA(le.fnmFull.str_String, GetFileExInfoStandard, &fad)) return FALSE;
+
+    le.iZipFile = -1;
+    le.ulSize = fad.nFileSizeLow;
+    le.ulStamp = fad.ftLastWriteTime.dwLowDateTime;
+    le.ulStampHi = fad.ftLastWriteTime.dwHighDateTime;
+    return TRUE;
+  }
+
+  // File in some archive
+  if (iType == EFP_BASEZIP || iType == EFP_MODZIP) {
+    le.iZipFile = IUnzip::GetFileIndex(le.fnmLevel);
+    if (le.iZipFile == -1) return FALSE;
+
+    const CZipEntry &ze = IUnzip::GetEntry(le.iZipFile);
+    le.ulSize = ze.ze_slUncompressedSize;
+    le.ulStamp = ze.ze_ulCRC;
+    le.ulStampHi = 0;
+    return TRUE;
+  }
+
+  return FALSE;
+};
+
+// [Cecil] Simple reader of the level header in memory
+struct SLevelHeaderReader {
+  const UBYTE *pubData;
+  SLONG slSize;
+  SLONG slPos;
+
+  BOOL Read(void *pDest, SLONG slLen) {
+    if (slLen < 0 || slPos + slLen > slSize) return FALSE;
+
+    memcpy(pDest, pubData + slPos, slLen);
+    slPos += slLen;
+    return TRUE;
+  };
+
+  BOOL PeekID(const char *strID) {
+    return slPos + 4 <= slSize && memcmp(pubData + slPos, strID, 4) == 0;
+  };
+
+  BOOL ExpectID(const char *strID) {
+    if (!PeekID(strID)) return FALSE;
+
+    slPos += 4;
+    return TRUE;
+  };
+
+  BOOL ReadString(CTString &str) {
+    INDEX iLength;
+    if (!Read(&iLength, sizeof(iLength)) || iLength < 0 || slPos + iLength > slSize) return FALSE;
+
+    char *strBuffer = (char *)AllocMemory(iLength + 1);
+    memcpy(strBuffer, pubData + slPos, iLength);
+    strBuffer[iLength] = '\0';
+    slPos += iLength;
+
+    str = strBuffer;
+    FreeMemory(strBuffer);
+    return TRUE;
+  };
+};
+
+// [Cecil] Read level info from the file header (same as GetLevelInfo() but without translation)
+static INDEX ParseLevelHeader(SLevelCacheEntry &le, const UBYTE *pubData, SLONG slSize) {
+  SLevelHeaderReader rd;
+  rd.pubData = pubData;
+  rd.slSize = slSize;
+  rd.slPos = 0;
+
+  le.iFormat = -1;
+
+  if (!rd.ExpectID("BUIV")) return 0; // 'build version'
+
+  INDEX iDummy;
+  if (!rd.Read(&iDummy, sizeof(iDummy))) return -1; // the version number
+
+  // Levels from other games
+  if (iDummy != 10000) {
+    le.iFormat = E_LF_150;
+  }
+
+  if (!rd.ExpectID("WRLD")) return 0; // 'world'
+  if (!rd.ExpectID("WLIF")) return 0; // 'world info'
+
+  // "DTRS" in the EXE as is gets picked up by the Depend utility
+  const CTString strDTRS = CTString("DT") + "RS";
+
+  if (rd.PeekID(strDTRS)) {
+    rd.ExpectID(strDTRS);
+  }
+
+  if (rd.ExpectID("LDRB")) {
+    CTString strDummy;
+    if (!rd.ReadString(strDummy)) return -1;
+
+    le.iFormat = E_LF_SSR;
+  }
+
+  if (rd.ExpectID("Plv0")) {
+    UBYTE aDummy[12];
+    if (!rd.Read(aDummy, sizeof(aDummy))) return -1;
+
+    le.iFormat = E_LF_SSR;
+  }
+
+  // Name and flags
+  if (!rd.ReadString(le.strName)) return -1;
+  if (!rd.Read(&le.ulSpawnFlags, sizeof(le.ulSpawnFlags))) return -1;
+
+  if (rd.PeekID("SpGM")) {
+    le.iFormat = E_LF_SSR;
+  }
+
+  return 1;
+};
+
+// [Cecil] Read level info of a single file (safe to call from other threads)
+static void ScanLevelFile(SLevelCacheEntry &le) {
+  UBYTE aubHeader[LEVEL_HEADER_SIZE];
+  SLONG slRead = -1;
+
+  if (le.iZipFile != -1) {
+    slRead = IUnzip::ReadFileStart(le.iZipFile, aubHeader, sizeof(aubHeader));
+
+  } else {
+    FILE *f = fopen(le.fnmFull.str_String, "rb");
+
+    if (f != NULL) {
+      slRead = fread(aubHeader, 1, sizeof(aubHeader), f);
+      fclose(f);
+    }
+  }
+
+  if (slRead < 0) {
+    le.iResult = -1;
+    return;
+  }
+
+  le.iResult = ParseLevelHeader(le, aubHeader, slRead);
+
+  // Header has been cut off but the file is bigger
+  if (le.iResult == -1 && slRead == LEVEL_HEADER_SIZE) return;
+
+  // Cut off file is simply invalid
+  if (le.iResult == -1) {
+    le.iResult = 0;
+  }
+};
+
+// [Cecil] Levels that are being scanned by worker threads
+static CStaticArray<SLevelCacheEntry> *_paLevelsToScan = NULL;
+static CStaticStackArray<INDEX> *_paiLevelScanQueue = NULL;
+static volatile LONG _iNextLevelScan = 0;
+
+// [Cecil] Worker thread that takes levels from the queue one by one
+static DWORD WINAPI LevelScanThread(LPVOID lpParam) {
+  const INDEX ctQueue = _paiLevelScanQueue->Count();
+
+  for (;;) {
+    const INDEX iQueue = InterlockedIncrement(&_iNextLevelScan) - 1;
+    if (iQueue >= ctQueue) break;
+
+    ScanLevelFile((*_paLevelsToScan)[(*_paiLevelScanQueue)[iQueue]]);
+  }
+
+  return 0;
+};
+
+// [Cecil] Scan queued levels using multiple threads
+static void ScanLevelFiles(CStaticArray<SLevelCacheEntry> &aLevels, CStaticStackArray<INDEX> &aiQueue) {
+  const INDEX ctQueue = aiQueue.Count();
+  if (ctQueue == 0) return;
+
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+
+  // Don't bother with threads for a few levels
+  INDEX ctThreads = Clamp((INDEX)si.dwNumberOfProcessors, (INDEX)1, (INDEX)8);
+  ctThreads = ClampUp(ctThreads, ctQueue / 8);
+
+  _paLevelsToScan = &aLevels;
+  _paiLevelScanQueue = &aiQueue;
+  _iNextLevelScan = 0;
+
+  CStaticStackArray<HANDLE> ahThreads;
+
+  for (INDEX iThread = 0; iThread < ctThreads; iThread++) {
+    DWORD dwThreadID;
+    HANDLE hThread = CreateThread(NULL, 0, &LevelScanThread, NULL, 0, &dwThreadID);
+
+    if (hThread != NULL) {
+      ahThreads.Push() = hThread;
+    }
+  }
+
+  // Help the workers or do everything if there are none
+  LevelScanThread(NULL);
+
+  for (INDEX iWait = 0; iWait < ahThreads.Count(); iWait++) {
+    WaitForSingleObject(ahThreads[iWait], INFINITE);
+    CloseHandle(ahThreads[iWait]);
+  }
+
+  _paLevelsToScan = NULL;
+  _paiLevelScanQueue = NULL;
+};
+
 // Init level-info subsystem
 void LoadLevelsList(void) {
   CPutString(LOCALIZE("Reading levels directory...\n"));
@@ -161,35 +478,111 @@ void LoadLevelsList(void) {
     ListGameFiles(afnmDir, "Downloaded\\Levels\\", "*.wld", LIST_LEVELS_BASE_FLAGS | FLF_REUSELIST);
   #endif
 
-  // for each file in the directory
-  for (INDEX i = 0; i < afnmDir.Count(); i++) {
-    CTFileName fnm = afnmDir[i];
+  // [Cecil] Load cached level info
+  CStaticStackArray<SLevelCacheEntry> aCache;
+  LoadLevelCache(aCache);
+
+  se1::map<CTString, INDEX> mapCache;
+
+  for (INDEX iCached = 0; iCached < aCache.Count(); iCached++) {
+    mapCache[aCache[iCached].fnmLevel] = iCached;
+  }
+
+  // [Cecil] Reuse info of unchanged levels and queue the rest for reading
+  const INDEX ctLevels = afnmDir.Count();
+
+  CStaticArray<SLevelCacheEntry> aLevels;
+  aLevels.New(ctLevels);
+
+  CStaticStackArray<INDEX> aiQueue;
+  INDEX ctCached = 0;
+
+  for (INDEX i = 0; i < ctLevels; i++) {
+    SLevelCacheEntry &le = aLevels[i];
+    le.fnmLevel = afnmDir[i];
+
+    // Read the file in place if it can't be found
+    if (!ResolveLevelFile(le)) continue;
+
+    se1::map<CTString, INDEX>::const_iterator it = mapCache.find(le.fnmLevel);
+
+    if (it != mapCache.end() && le.SameFile(aCache[it->second])) {
+      const SLevelCacheEntry &leCached = aCache[it->second];
+      le.iResult = leCached.iResult;
+      le.strName = leCached.strName;
+      le.ulSpawnFlags = leCached.ulSpawnFlags;
+      le.iFormat = leCached.iFormat;
+      ctCached++;
+
+    } else {
+      aiQueue.Push() = i;
+    }
+  }
 
-    CPrintF(LOCALIZE("  file '%s' : "), (const char *)fnm);
+  // [Cecil] Read changed levels
+  ScanLevelFiles(aLevels, aiQueue);
+
+  INDEX ctInvalid = 0;
+
+  // for each file in the directory
+  for (INDEX i = 0; i < ctLevels; i++) {
+    SLevelCacheEntry &le = aLevels[i];
+    const CTFileName &fnm = le.fnmLevel;
 
     // try to load its info, and if valid
     CLevelInfo li;
 
-    if (GetLevelInfo(li, fnm)) {
-      // Mark as a TFE level in the log
-      if (li.li_eFormat == E_LF_TFE) {
-        CPutString("(TFE) ");
+    // [Cecil] Read the file normally if it couldn't be read in advance
+    if (le.iResult == -1) {
+      if (!GetLevelInfo(li, fnm)) {
+        ctInvalid++;
+        continue;
       }
 
-      CPrintF(LOCALIZE("'%s' spawn=0x%08x\n"), li.li_strName, li.li_ulSpawnFlags);
+    } else if (le.iResult == 0) {
+      ctInvalid++;
+      continue;
 
-      // create new info for that file
-      CLevelInfo *pliNew = new CLevelInfo;
-      *pliNew = li;
+    // [Cecil] Fill level info in the same way as GetLevelInfo()
+    } else {
+    #if CLASSIC_TSE_FUSION_MODE
+      // Mark levels from the TFE directory
+      if (IsFileFromDir(GAME_DIR_TFE, fnm)) {
+        li.li_eFormat = E_LF_TFE;
+      }
+    #endif
 
-      // add it to list of all levels
-      _lhAllLevels.AddTail(pliNew->li_lnNode);
+      if (le.iFormat != -1) {
+        li.li_eFormat = (ELevelFormat)le.iFormat;
+      }
 
-    } else {
-      CPutString(LOCALIZE("invalid level\n"));
+      li.li_strName = TRANSV(le.strName);
+      li.li_ulSpawnFlags = le.ulSpawnFlags;
+
+      if (li.li_strName == "") {
+        li.li_strName = fnm.FileName();
+      }
+
+      li.li_fnLevel = fnm;
     }
+
+    // create new info for that file
+    CLevelInfo *pliNew = new CLevelInfo;
+    *pliNew = li;
+
+    // add it to list of all levels
+    _lhAllLevels.AddTail(pliNew->li_lnNode);
+  }
+
+  // [Cecil] Update the cache if anything has been read or removed
+  if (aiQueue.Count() > 0 || ctCached != aCache.Count()) {
+    SaveLevelCache(aLevels);
   }
 
+  // [Cecil] Summary instead of every single file
+  CPrintF(TRANS("  %d levels (%d cached, %d read, %d invalid)\n"),
+    ctLevels - ctInvalid, ctCached, ctLevels - ctCached, ctInvalid);
+
   // sort the list
   _lhAllLevels.Sort(qsort_CompareLevels, offsetof(CLevelInfo, li_lnNode));
 }
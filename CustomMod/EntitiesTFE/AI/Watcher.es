@@ -18,6 +18,253 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "StdH.h"
 
 #include "Enemies/EnemyBase.h"
+
+// [Cecil] Player that can be watched by enemies
+struct SWatchedPlayer {
+  CEntity *pen;
+  INDEX iSlot;   // index in the player list
+  FLOAT3D vPos;  // position at the time of the snapshot
+  BOOL bTarget;  // alive and visible
+};
+
+// [Cecil] Active players in a world at some tick
+struct SWatchedPlayers {
+  CWorld *pwo;
+  TIME tmTick;
+  CStaticStackArray<SWatchedPlayer> aPlayers; // sorted by slots
+};
+
+// [Cecil] Shared snapshot for all watchers and a temporary one for predictors,
+// since predicted ticks are repeated with different player positions
+static SWatchedPlayers _wpSnapshot;
+static SWatchedPlayers _wpPredicted;
+
+// [Cecil] Gather all active players
+static void TakePlayerSnapshot(SWatchedPlayers &wp, CWorld *pwo)
+{
+  wp.pwo = pwo;
+  wp.tmTick = _pTimer->CurrentTick();
+  wp.aPlayers.PopAll();
+
+  const INDEX ctMaxPlayers = CEntity::GetMaxPlayers();
+
+  for (INDEX i = 0; i < ctMaxPlayers; i++) {
+    CEntity *pen = CEntity::GetPlayerEntity(i);
+    if (pen == NULL) continue;
+
+    SWatchedPlayer &player = wp.aPlayers.Push();
+    player.pen = pen;
+    player.iSlot = i;
+    player.vPos = pen->GetPlacement().pl_PositionVector;
+    player.bTarget = (pen->GetFlags() & ENF_ALIVE) && !(pen->GetFlags() & ENF_INVISIBLE);
+  }
+};
+
+// [Cecil] Check if the snapshot has been taken during the current tick for the same players
+static BOOL IsSnapshotValid(const SWatchedPlayers &wp, CWorld *pwo)
+{
+  if (wp.pwo != pwo || wp.tmTick != _pTimer->CurrentTick()) return FALSE;
+
+  // Players may have been recreated after loading a game at the same tick
+  const INDEX ct = wp.aPlayers.Count();
+
+  for (INDEX i = 0; i < ct; i++) {
+    const SWatchedPlayer &player = wp.aPlayers[i];
+
+    if (CEntity::GetPlayerEntity(player.iSlot) != player.pen) return FALSE;
+  }
+
+  return TRUE;
+};
+
+// [Cecil] Get active players for some watcher, taking the snapshot once per tick
+static const SWatchedPlayers &GetWatchedPlayers(CEntity *penWatcher)
+{
+  CWorld *pwo = penWatcher->GetWorld();
+
+  if (penWatcher->IsPredictor()) {
+    TakePlayerSnapshot(_wpPredicted, pwo);
+    return _wpPredicted;
+  }
+
+  if (!IsSnapshotValid(_wpSnapshot, pwo)) {
+    TakePlayerSnapshot(_wpSnapshot, pwo);
+  }
+
+  return _wpSnapshot;
+};
+
+// [Cecil] Check if a watched player can still be picked as a target
+// Players may die or become invisible later in the tick, after the snapshot has been taken
+static BOOL IsWatchedTarget(const SWatchedPlayer &player)
+{
+  if (!player.bTarget) return FALSE;
+
+  // Synthetic players from the benchmark have no entities
+  if (player.pen == NULL) return TRUE;
+
+  const ULONG ulFlags = player.pen->GetFlags();
+  return (ulFlags & ENF_ALIVE) && !(ulFlags & ENF_INVISIBLE);
+};
+
+// [Cecil] Find the first active player starting from some slot, wrapping around (-1 if there are none)
+static INDEX FindPlayerFromSlot(const SWatchedPlayers &wp, INDEX iSlot)
+{
+  const INDEX ct = wp.aPlayers.Count();
+  if (ct == 0) return -1;
+
+  for (INDEX i = 0; i < ct; i++) {
+    if (wp.aPlayers[i].iSlot >= iSlot) return i;
+  }
+
+  return 0;
+};
+
+// [Cecil] Find the closest target player to some position (-1 if there are none)
+static INDEX FindClosestWatched(const SWatchedPlayers &wp, const FLOAT3D &vSrc, FLOAT &fClosest)
+{
+  INDEX iClosest = -1;
+  FLOAT fClosest2 = UpperLimit(0.0f);
+
+  const INDEX ct = wp.aPlayers.Count();
+
+  for (INDEX i = 0; i < ct; i++) {
+    const SWatchedPlayer &player = wp.aPlayers[i];
+    if (!player.bTarget) continue;
+
+    // Compare squared distances and only compute the closest one
+    const FLOAT3D vDiff = player.vPos - vSrc;
+    const FLOAT fDist2 = vDiff % vDiff;
+
+    if (fDist2 < fClosest2 && IsWatchedTarget(player)) {
+      fClosest2 = fDist2;
+      iClosest = i;
+    }
+  }
+
+  if (iClosest != -1) {
+    fClosest = Sqrt(fClosest2);
+  }
+
+  return iClosest;
+};
+
+// [Cecil] Synthetic player for the benchmark, as big and scattered in memory as real entities
+struct SBenchPlayer {
+  ULONG ulFlags;
+  FLOAT3D vPos;
+  UBYTE aubRest[2048];
+};
+
+// [Cecil] Compare watching costs with and without the snapshot on synthetic players and enemies
+static void BenchmarkWatchers(SHELL_FUNC_ARGS)
+{
+  BEGIN_SHELL_FUNC;
+  const INDEX ctPlayers = ClampDn(NEXT_ARG(INDEX), (INDEX)1);
+  const INDEX ctEnemies = ClampDn(NEXT_ARG(INDEX), (INDEX)1);
+
+  // Simulate one second of watching every tick
+  const INDEX ctTicks = 20;
+
+  ULONG ulRnd = 0x1234567;
+  #define WAT_BENCH_RND() (ulRnd = ulRnd * 1103515245 + 12345, FLOAT((ulRnd >> 16) & 0x7FFF) / 32767.0f)
+
+  CStaticArray<SBenchPlayer *> apSlots;
+  apSlots.New(ctPlayers);
+
+  INDEX i;
+
+  for (i = 0; i < ctPlayers; i++) {
+    apSlots[i] = new SBenchPlayer;
+    apSlots[i]->ulFlags = (i % 8 == 7 ? 0 : ENF_ALIVE); // some players are dead
+    apSlots[i]->vPos = FLOAT3D(WAT_BENCH_RND(), WAT_BENCH_RND(), WAT_BENCH_RND()) * 512.0f;
+  }
+
+  CStaticArray<FLOAT3D> avEnemies;
+  avEnemies.New(ctEnemies);
+
+  for (i = 0; i < ctEnemies; i++) {
+    avEnemies[i] = FLOAT3D(WAT_BENCH_RND(), WAT_BENCH_RND(), WAT_BENCH_RND()) * 512.0f;
+  }
+
+  #undef WAT_BENCH_RND
+
+  FLOAT fSumSlots = 0.0f;
+  FLOAT fSumSnapshot = 0.0f;
+  INDEX iTick, iEnemy;
+
+  // Each enemy goes through all slots on its own
+  CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  for (iTick = 0; iTick < ctTicks; iTick++) {
+    for (iEnemy = 0; iEnemy < ctEnemies; iEnemy++) {
+      FLOAT fClosest = UpperLimit(0.0f);
+
+      for (INDEX iPlayer = 0; iPlayer < ctPlayers; iPlayer++) {
+        SBenchPlayer *pbp = apSlots[iPlayer];
+
+        if (pbp != NULL && pbp->ulFlags & ENF_ALIVE && !(pbp->ulFlags & ENF_INVISIBLE)) {
+          FLOAT fDistance = (pbp->vPos - avEnemies[iEnemy]).Length();
+
+          if (fDistance < fClosest) {
+            fClosest = fDistance;
+          }
+        }
+      }
+
+      fSumSlots += fClosest;
+    }
+  }
+
+  const DOUBLE dSlots = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() / ctTicks;
+
+  // Players are gathered once per tick
+  SWatchedPlayers wp;
+  tvStart = _pTimer->GetHighPrecisionTimer();
+
+  for (iTick = 0; iTick < ctTicks; iTick++) {
+    wp.aPlayers.PopAll();
+
+    for (INDEX iPlayer = 0; iPlayer < ctPlayers; iPlayer++) {
+      SBenchPlayer *pbp = apSlots[iPlayer];
+      if (pbp == NULL) continue;
+
+      SWatchedPlayer &player = wp.aPlayers.Push();
+      player.pen = NULL;
+      player.iSlot = iPlayer;
+      player.vPos = pbp->vPos;
+      player.bTarget = (pbp->ulFlags & ENF_ALIVE) && !(pbp->ulFlags & ENF_INVISIBLE);
+    }
+
+    for (iEnemy = 0; iEnemy < ctEnemies; iEnemy++) {
+      FLOAT fClosest = UpperLimit(0.0f);
+      FindClosestWatched(wp, avEnemies[iEnemy], fClosest);
+
+      fSumSnapshot += fClosest;
+    }
+  }
+
+  const DOUBLE dSnapshot = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds() / ctTicks;
+
+  for (i = 0; i < ctPlayers; i++) {
+    delete apSlots[i];
+  }
+
+  CPrintF("%d players, %d enemies, average tick cost:\n", ctPlayers, ctEnemies);
+  CPrintF("  player slots: %.3f ms\n", dSlots * 1000.0);
+  CPrintF("  snapshot:     %.3f ms (%.2fx)\n", dSnapshot * 1000.0, dSlots / ClampDn(dSnapshot, 1e-9));
+
+  // Both should find the same players
+  if (Abs(fSumSlots - fSumSnapshot) > 0.001f * Abs(fSumSlots)) {
+    CPrintF("  closest distances differ: %.3f != %.3f\n", fSumSlots, fSumSnapshot);
+  }
+};
+
+// [Cecil] Declare watcher commands
+void CWatcher_OnInitClass(void)
+{
+  _pShell->DeclareSymbol("user void WAT_Benchmark(INDEX, INDEX);", &BenchmarkWatchers);
+};
 %}
 
 // input parameter for watcher
@@ -33,7 +280,7 @@ event EWatch {
 class export CWatcher : CRationalEntity {
 name      "Watcher";
 thumbnail "";
-features  "CanBePredictable";
+features  "CanBePredictable", "ImplementsOnInitClass";
 
 
 properties:
@@ -59,41 +306,19 @@ functions:
   // find one player number by random
   INDEX GetRandomPlayer(void)
   {
-//    CPrintF("Getting random number... ");
-    // get maximum number of players in game
-    INDEX ctMaxPlayers = GetMaxPlayers();
-    // find actual number of players
-    INDEX ctActivePlayers = 0;
-    {for(INDEX i=0; i<ctMaxPlayers; i++) {
-      if (GetPlayerEntity(i)!=NULL) {
-        ctActivePlayers++;
-      }
-    }}
-//    CPrintF("active players %d, ", ctActivePlayers);
+    // [Cecil] Choose from active players in the snapshot
+    const SWatchedPlayers &wp = GetWatchedPlayers(this);
+    const INDEX ctActivePlayers = wp.aPlayers.Count();
+
     // if none
     if (ctActivePlayers==0) {
       // return first index anyway
       return 0;
     }
 
-
-    // choose one by random
+    // choose one by random and return its physical index
     INDEX iChosenActivePlayer = IRnd()%ctActivePlayers;
-//    CPrintF("chosen %d, ", iChosenActivePlayer);
-
-    // find its physical index
-    INDEX iActivePlayer = 0;
-    {for(INDEX i=0; i<ctMaxPlayers; i++) {
-      if (GetPlayerEntity(i)!=NULL) {
-        if (iActivePlayer==iChosenActivePlayer) {
-//          CPrintF("actual index %d\n", iActivePlayer);
-          return i;
-        }
-        iActivePlayer++;
-      }
-    }}
-    ASSERT(FALSE);
-    return 0;
+    return wp.aPlayers[iChosenActivePlayer].iSlot;
   }
 
   // find closest player
@@ -101,20 +326,13 @@ functions:
   {
     CEntity *penClosestPlayer = NULL;
     FLOAT fClosestPlayer = UpperLimit(0.0f);
-    // for all players
-    for (INDEX iPlayer=0; iPlayer<GetMaxPlayers(); iPlayer++) {
-      CEntity *penPlayer = GetPlayerEntity(iPlayer);
-      // if player is alive and visible
-      if (penPlayer!=NULL && penPlayer->GetFlags()&ENF_ALIVE && !(penPlayer->GetFlags()&ENF_INVISIBLE)) {
-        // calculate distance to player
-        FLOAT fDistance = 
-          (penPlayer->GetPlacement().pl_PositionVector-m_penOwner->GetPlacement().pl_PositionVector).Length();
-        // update if closer
-        if (fDistance<fClosestPlayer) {
-          fClosestPlayer = fDistance;
-          penClosestPlayer = penPlayer;
-        }
-      }
+
+    // [Cecil] Search among alive and visible players in the snapshot
+    const SWatchedPlayers &wp = GetWatchedPlayers(this);
+    INDEX iClosest = FindClosestWatched(wp, m_penOwner->GetPlacement().pl_PositionVector, fClosestPlayer);
+
+    if (iClosest!=-1) {
+      penClosestPlayer = wp.aPlayers[iClosest].pen;
     }
     // if no players found
     if (penClosestPlayer==NULL) {
@@ -144,23 +362,20 @@ functions:
     // get maximum number of players in game
     INDEX ctPlayers = GetMaxPlayers();
     // find first one after current sequence
-    CEntity *penPlayer = NULL;
-    m_iPlayerToCheck = (m_iPlayerToCheck+1)%ctPlayers;
-    INDEX iFirstChecked = m_iPlayerToCheck;
-    FOREVER {
-      penPlayer = GetPlayerEntity(m_iPlayerToCheck);
-      if (penPlayer!=NULL) {
-        break;
-      }
-      m_iPlayerToCheck++;
-      m_iPlayerToCheck%=ctPlayers;
-      if (m_iPlayerToCheck==iFirstChecked) {
-        return; // we get here if there are no players at all
-      }
+    // [Cecil] Skip empty slots by going through the snapshot
+    const SWatchedPlayers &wp = GetWatchedPlayers(this);
+    INDEX iActive = FindPlayerFromSlot(wp, (m_iPlayerToCheck+1)%ctPlayers);
+
+    if (iActive==-1) {
+      return; // we get here if there are no players at all
     }
 
+    const SWatchedPlayer &player = wp.aPlayers[iActive];
+    m_iPlayerToCheck = player.iSlot;
+    CEntity *penPlayer = player.pen;
+
     // if this one is dead or invisible
-    if (!(penPlayer->GetFlags()&ENF_ALIVE) || (penPlayer->GetFlags()&ENF_INVISIBLE)) {
+    if (!IsWatchedTarget(player)) {
       // do nothing
       return;
     }
@@ -244,28 +459,32 @@ functions:
     }
 
     CEntity *penClosestPlayer = NULL;
-    FLOAT fClosestPlayer = 
-      (penCurrentTarget->GetPlacement().pl_PositionVector-m_penOwner->GetPlacement().pl_PositionVector).Length();
+    const FLOAT3D &vOwner = m_penOwner->GetPlacement().pl_PositionVector;
+    FLOAT fClosestPlayer = (penCurrentTarget->GetPlacement().pl_PositionVector-vOwner).Length();
     fClosestPlayer = Min(fClosestPlayer, fRange);  // this is maximum considered range
 
+    // [Cecil] Compare squared distances
+    FLOAT fClosestPlayer2 = fClosestPlayer*fClosestPlayer;
+
     // for all other players
-    for (INDEX iPlayer=0; iPlayer<GetMaxPlayers(); iPlayer++) {
-      CEntity *penPlayer = GetPlayerEntity(iPlayer);
-      if (penPlayer==NULL || penPlayer==penCurrentTarget) {
+    const SWatchedPlayers &wp = GetWatchedPlayers(this);
+    const INDEX ctActive = wp.aPlayers.Count();
+
+    for (INDEX iActive=0; iActive<ctActive; iActive++) {
+      const SWatchedPlayer &player = wp.aPlayers[iActive];
+      // skip the current target and dead or invisible players
+      if (player.pen==penCurrentTarget || !player.bTarget) {
         continue;
       }
-      // if player is alive and visible
-      if ((penPlayer->GetFlags()&ENF_ALIVE) && !(penPlayer->GetFlags()&ENF_INVISIBLE)) {
-        // calculate distance to player
-        FLOAT fDistance = 
-          (penPlayer->GetPlacement().pl_PositionVector-m_penOwner->GetPlacement().pl_PositionVector).Length();
-        // if closer than current and you can see him
-        if (fDistance<fClosestPlayer && 
-            GetOwner()->SeeEntity(penPlayer, Cos(GetOwner()->m_fViewAngle/2.0f))) {
-          // update
-          fClosestPlayer = fDistance;
-          penClosestPlayer = penPlayer;
-        }
+      // calculate distance to player
+      const FLOAT3D vDiff = player.vPos-vOwner;
+      FLOAT fDistance2 = vDiff%vDiff;
+      // if closer than current and you can see him
+      if (fDistance2<fClosestPlayer2 && IsWatchedTarget(player) &&
+          GetOwner()->SeeEntity(player.pen, Cos(GetOwner()->m_fViewAngle/2.0f))) {
+        // update
+        fClosestPlayer2 = fDistance2;
+        penClosestPlayer = player.pen;
       }
     }
 
@@ -282,32 +501,33 @@ functions:
     }
 
     // get allowed distance
-    CEntity *penClosestPlayer = NULL;
-    FLOAT fCurrentDistance = 
-      (penCurrentTarget->GetPlacement().pl_PositionVector-m_penOwner->GetPlacement().pl_PositionVector).Length();
+    const FLOAT3D &vOwner = m_penOwner->GetPlacement().pl_PositionVector;
+    FLOAT fCurrentDistance = (penCurrentTarget->GetPlacement().pl_PositionVector-vOwner).Length();
     FLOAT fRange = fCurrentDistance*1.5f;
+    FLOAT fRange2 = fRange*fRange;
 
     // find a random offset to start searching
     INDEX iOffset = GetRandomPlayer();
 
     // for all other players
-    INDEX ctPlayers = GetMaxPlayers();
-    for (INDEX iPlayer=0; iPlayer<ctPlayers; iPlayer++) {
-      CEntity *penPlayer = GetPlayerEntity((iPlayer+iOffset)%ctPlayers);
-      if (penPlayer==NULL || penPlayer==penCurrentTarget) {
+    // [Cecil] Starting from the active player at the offset
+    const SWatchedPlayers &wp = GetWatchedPlayers(this);
+    const INDEX ctActive = wp.aPlayers.Count();
+    const INDEX iFirst = FindPlayerFromSlot(wp, iOffset);
+
+    for (INDEX iActive=0; iActive<ctActive; iActive++) {
+      const SWatchedPlayer &player = wp.aPlayers[(iActive+iFirst)%ctActive];
+      // skip the current target and dead or invisible players
+      if (player.pen==penCurrentTarget || !player.bTarget) {
         continue;
       }
-      // if player is alive and visible
-      if ((penPlayer->GetFlags()&ENF_ALIVE) && !(penPlayer->GetFlags()&ENF_INVISIBLE)) {
-        // calculate distance to player
-        FLOAT fDistance = 
-          (penPlayer->GetPlacement().pl_PositionVector-m_penOwner->GetPlacement().pl_PositionVector).Length();
-        // if inside allowed range and visible
-        if (fDistance<fRange && 
-            GetOwner()->SeeEntity(penPlayer, Cos(GetOwner()->m_fViewAngle/2.0f))) {
-          // attack that one
-          return penPlayer;
-        }
+      // calculate distance to player
+      const FLOAT3D vDiff = player.vPos-vOwner;
+      // if inside allowed range and visible
+      if (vDiff%vDiff<fRange2 && IsWatchedTarget(player) &&
+          GetOwner()->SeeEntity(player.pen, Cos(GetOwner()->m_fViewAngle/2.0f))) {
+        // attack that one
+        return player.pen;
       }
     }
 
@@ -205,10 +205,14 @@ static CTString PadStringLeft(const CTString &str, INDEX iLen)
 
 static void KillAllEnemies(CEntity *penKiller)
 {
-  // for each entity in the world
-  {FOREACHINDYNAMICCONTAINER(penKiller->GetWorld()->wo_cenEntities, CEntity, iten) {
+  // [Cecil] Only go through enemies in the world
+  CDynamicContainer<CEntity> cenEnemies;
+  IEntityRegistry::GetEntities(penKiller->GetWorld(), ECAT_ENEMY, cenEnemies);
+
+  // for each enemy in the world
+  {FOREACHINDYNAMICCONTAINER(cenEnemies, CEntity, iten) {
     CEntity *pen = iten;
-    if (IsDerivedFromClass(pen, "Enemy Base") && !IsOfClass(pen, "Devil")) {
+    if (!IsOfClass(pen, "Devil")) {
       CEnemyBase *penEnemy = (CEnemyBase *)pen;
       if (penEnemy->m_penEnemy==NULL) {
         continue;
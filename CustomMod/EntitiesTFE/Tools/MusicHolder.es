@@ -130,33 +130,42 @@ functions:
   {
     m_ctEnemiesInWorld = 0;
     m_ctSecretsInWorld = 0;
-    // for each entity in the world
-    {FOREACHINDYNAMICCONTAINER(GetWorld()->wo_cenEntities, CEntity, iten) {
+    // [Cecil] Only go through entities that are counted
+    CDynamicContainer<CEntity> cenEnemies, cenSpawners, cenTriggers;
+    IEntityRegistry::GetEntities(GetWorld(), ECAT_ENEMY, cenEnemies);
+    IEntityRegistry::GetEntities(GetWorld(), ECAT_SPAWNER, cenSpawners);
+    IEntityRegistry::GetEntities(GetWorld(), ECAT_TRIGGER, cenTriggers);
+
+    // for each enemybase
+    {FOREACHINDYNAMICCONTAINER(cenEnemies, CEntity, iten) {
       CEntity *pen = iten;
-      // if enemybase
-      if (IsDerivedFromClass(pen, "Enemy Base")) {
-        CEnemyBase *penEnemy = (CEnemyBase *)pen;
-        // if not template
-        if (!penEnemy->m_bTemplate) {
-          // count one
-          m_ctEnemiesInWorld++;
-        }
-      // if spawner
-      } else if (IsDerivedFromClass(pen, "Enemy Spawner")) {
-        CEnemySpawner *penSpawner = (CEnemySpawner *)pen;
-        // if not teleporting
-        if (penSpawner->m_estType!=EST_TELEPORTER) {
-          // add total count
-          m_ctEnemiesInWorld+=penSpawner->m_ctTotal;
-        }
-      // if trigger
-      } else if (IsDerivedFromClass(pen, "Trigger")) {
-        CTrigger *penTrigger = (CTrigger *)pen;
-        // if has score
-        if (penTrigger->m_fScore>0) {
-          // it counts as a secret
-          m_ctSecretsInWorld++;
-        }
+      CEnemyBase *penEnemy = (CEnemyBase *)pen;
+      // if not template
+      if (!penEnemy->m_bTemplate) {
+        // count one
+        m_ctEnemiesInWorld++;
+      }
+    }}
+
+    // for each spawner
+    {FOREACHINDYNAMICCONTAINER(cenSpawners, CEntity, iten) {
+      CEntity *pen = iten;
+      CEnemySpawner *penSpawner = (CEnemySpawner *)pen;
+      // if not teleporting
+      if (penSpawner->m_estType!=EST_TELEPORTER) {
+        // add total count
+        m_ctEnemiesInWorld+=penSpawner->m_ctTotal;
+      }
+    }}
+
+    // for each trigger
+    {FOREACHINDYNAMICCONTAINER(cenTriggers, CEntity, iten) {
+      CEntity *pen = iten;
+      CTrigger *penTrigger = (CTrigger *)pen;
+      // if has score
+      if (penTrigger->m_fScore>0) {
+        // it counts as a secret
+        m_ctSecretsInWorld++;
       }
     }}
   }
@@ -18,12 +18,18 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "StdH.h"
 #include "Common/PathFinding.h"
 
-#define MAX_TARGETS 6
+#define MAX_TARGETS PATH_MAX_LINKS
 %}
 
 uses "Tools/Marker";
 
 %{
+// [Cecil] Declare path finding commands
+void CNavigationMarker_OnInitClass(void)
+{
+  PATH_DeclareSymbols();
+};
+
 // info structure
 static EntityInfo eiMarker = {
   EIBT_ROCK, 10.0f,
@@ -36,7 +42,7 @@ static EntityInfo eiMarker = {
 class export CNavigationMarker : CEntity {
 name      "NavigationMarker";
 thumbnail "Thumbnails\\NavigationMarker.tbn";
-features  "HasName", "IsTargetable";
+features  "HasName", "IsTargetable", "ImplementsOnInitClass";
 
 properties:
   1 CTString m_strName          "Name" 'N' = "Marker",
@@ -50,7 +56,9 @@ properties:
   105 CEntityPointer m_penTarget5  "Target 5"     COLOR(C_dBLUE|0xFF),
 
   {
-    CPathNode *m_ppnNode;  // for pathfinding algorithm
+    // [Cecil] Node in the navigation graph
+    INDEX m_iPathNode;
+    ULONG m_ulPathGraph; // graph that the node is from
   }
 
 components:
@@ -60,18 +68,24 @@ components:
 functions:
   void CNavigationMarker(void)
   {
-    m_ppnNode = NULL;
+    m_iPathNode = -1;
+    m_ulPathGraph = 0;
   }
   void ~CNavigationMarker(void)
   {
-    ASSERT(m_ppnNode == NULL);
+    // [Cecil] Graph cannot reference this marker anymore
+    PATH_ResetGraph();
   }
 
   /* Read from stream. */
   void Read_t( CTStream *istr) // throw char *
   {
     CEntity::Read_t(istr);
-    m_ppnNode = NULL;
+    m_iPathNode = -1;
+    m_ulPathGraph = 0;
+
+    // [Cecil] Start over with a new graph after loading a world or a game
+    PATH_ResetGraph();
   }
   
   CEntity *GetTarget(void) const { return m_penTarget0; };
@@ -81,16 +95,6 @@ functions:
     return &eiMarker;
   };
 
-  // get node used for pathfinding algorithm
-  CPathNode *GetPathNode(void)
-  {
-    if (m_ppnNode==NULL) {
-      m_ppnNode = new CPathNode(this);
-    }
-
-    return m_ppnNode;
-  }
-
   CEntityPointer &TargetPointer(INDEX i)
   {
     ASSERT(i>=0 && i<MAX_TARGETS);
@@ -138,6 +142,9 @@ functions:
 
 procedures:
   Main() {
+    // [Cecil] Links between markers may change
+    PATH_ResetGraph();
+
     InitAsEditorModel();
     SetPhysicsFlags(EPF_MODEL_IMMATERIAL);
     SetCollisionFlags(ECF_IMMATERIAL);
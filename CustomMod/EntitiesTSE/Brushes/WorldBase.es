@@ -148,26 +148,30 @@ static void DoLevelSafetyChecks()
   }
   
   CPrintF("STEP 1 - Checking model holders...\n");
+  // [Cecil] Only go through model holders
+  CDynamicContainer<CEntity> cenModelHolders;
+  IEntityRegistry::GetEntities(pwo, ECAT_MODELHOLDER, cenModelHolders);
+
   // for model holder in the world;
-  {FOREACHINDYNAMICCONTAINER(pwo->wo_cenEntities, CEntity, iten) {  
-    if (IsOfClass(iten, "ModelHolder2")) {
-      CModelHolder2 *mh = (CModelHolder2*)&*iten;
-      FLOAT3D vPos = mh->GetPlacement().pl_PositionVector;
-      if (mh->m_penDestruction == NULL) {
-        CPrintF("  model holder '%s' at (%2.2f, %2.2f, %2.2f) has no destruction\n", mh->m_strName, vPos(1), vPos(2), vPos(3));
-      }
+  {FOREACHINDYNAMICCONTAINER(cenModelHolders, CEntity, iten) {
+    CModelHolder2 *mh = (CModelHolder2*)&*iten;
+    FLOAT3D vPos = mh->GetPlacement().pl_PositionVector;
+    if (mh->m_penDestruction == NULL) {
+      CPrintF("  model holder '%s' at (%2.2f, %2.2f, %2.2f) has no destruction\n", mh->m_strName, vPos(1), vPos(2), vPos(3));
     }
   }}
 
   CPrintF("STEP 2 - Checking sound holders...\n");
+  // [Cecil] Only go through sound holders
+  CDynamicContainer<CEntity> cenSoundHolders;
+  IEntityRegistry::GetEntities(pwo, ECAT_SOUNDHOLDER, cenSoundHolders);
+
   // for each sound holder in the world
-  {FOREACHINDYNAMICCONTAINER(pwo->wo_cenEntities, CEntity, iten) {
-    if (IsOfClass(iten, "SoundHolder")) {
-      CSoundHolder *sh = (CSoundHolder *)&*iten;
-      FLOAT3D vPos = sh->GetPlacement().pl_PositionVector;
-      if (sh->m_fnSound == CTFILENAME("Sounds\\Default.wav")) {
-        CPrintF("  sound holder '%s' at (%2.2f, %2.2f, %2.2f) has default sound!\n", sh->m_strName, vPos(1), vPos(2), vPos(3));
-      }
+  {FOREACHINDYNAMICCONTAINER(cenSoundHolders, CEntity, iten) {
+    CSoundHolder *sh = (CSoundHolder *)&*iten;
+    FLOAT3D vPos = sh->GetPlacement().pl_PositionVector;
+    if (sh->m_fnSound == CTFILENAME("Sounds\\Default.wav")) {
+      CPrintF("  sound holder '%s' at (%2.2f, %2.2f, %2.2f) has default sound!\n", sh->m_strName, vPos(1), vPos(2), vPos(3));
     }
   }}
   
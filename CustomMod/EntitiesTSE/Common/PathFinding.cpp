@@ -20,143 +20,295 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #define PRINTOUT(_dummy)
 //#define PRINTOUT(something) something
 
-// open and closed lists of nodes
-static CListHead _lhOpen;
-static CListHead _lhClosed;
+// [Cecil] Navigation graph with nodes for every reached marker
+static CStaticStackArray<CPathNode> _apnGraph;
+static ULONG _ulGraph = 1; // Current graph (markers remember which graph their nodes are from)
+static ULONG _ulSearch = 0; // Current search (nodes remember which search their state is from)
+
+// [Cecil] Open list of node indices, sorted the same way as the original linked list but in reverse, best node last
+static CStaticStackArray<INDEX> _aiOpen;
+
+// [Cecil] Next node on the path found by a search from one node to another
+// NOTE: Only exact results of searches are cached, so that cached queries always give the same result as a new
+// search would. The cache belongs to the graph, which is reset whenever markers are created, destroyed or read
+// from a stream, so every machine starts over with an empty cache after loading a world or a game.
+struct SPathHop {
+  INDEX ph_iSrc; // -1 if empty
+  INDEX ph_iDst;
+  INDEX ph_iNext; // -1 if there's no path
+};
+
+// [Cecil] Cache of path queries in the current graph
+static CStaticArray<SPathHop> _aPathHops;
+static INDEX _ctPathHops = 0;
+
+// [Cecil] Maximum amount of cached path queries before starting over
+#define PATH_MAX_HOPS (1 << 14)
+
+INDEX path_ctCacheHits = 0;
+INDEX path_ctCacheMisses = 0;
+
+// [Cecil] Forget all cached path queries
+static void ClearPathHops(void)
+{
+  for (INDEX i = 0; i < _aPathHops.Count(); i++) {
+    _aPathHops[i].ph_iSrc = -1;
+  }
+
+  _ctPathHops = 0;
+}
 
-FLOAT NodeDistance(CPathNode *ppn0, CPathNode *ppn1)
+// [Cecil] Forget the navigation graph (whenever markers change)
+void PATH_ResetGraph(void)
 {
-  return (
-    ppn0->pn_pnmMarker->GetPlacement().pl_PositionVector - 
-    ppn1->pn_pnmMarker->GetPlacement().pl_PositionVector).Length();
+  _apnGraph.PopAll();
+  _aiOpen.PopAll();
+  _ulGraph++;
+
+  ClearPathHops();
 }
 
-CPathNode::CPathNode(class CNavigationMarker *penMarker)
+// [Cecil] Find slot of a path query in the cache (empty one if it's not cached)
+static inline INDEX FindPathHop(INDEX iSrc, INDEX iDst)
 {
-  pn_pnmMarker = penMarker;
-  pn_ppnParent = NULL;
-  pn_fG = 0.0f;
-  pn_fH = 0.0f;
-  pn_fF = 0.0f;
+  const ULONG ulMask = _aPathHops.Count() - 1;
+  ULONG ulSlot = (ULONG(iSrc) * 0x9E3779B1UL ^ ULONG(iDst) * 0x85EBCA77UL) & ulMask;
+
+  for (;;) {
+    const SPathHop &ph = _aPathHops[ulSlot];
+
+    if (ph.ph_iSrc == -1 || (ph.ph_iSrc == iSrc && ph.ph_iDst == iDst)) {
+      return ulSlot;
+    }
+
+    ulSlot = (ulSlot + 1) & ulMask;
+  }
 }
 
-CPathNode::~CPathNode(void)
+// [Cecil] Get cached next node on the path
+static BOOL GetPathHop(INDEX iSrc, INDEX iDst, INDEX &iNext)
 {
-  // detach from marker when deleting
-  ASSERT(pn_pnmMarker!=NULL);
-  pn_pnmMarker->m_ppnNode = NULL;
+  if (_ctPathHops == 0) return FALSE;
+
+  const SPathHop &ph = _aPathHops[FindPathHop(iSrc, iDst)];
+  if (ph.ph_iSrc == -1) return FALSE;
+
+  iNext = ph.ph_iNext;
+  return TRUE;
 }
 
-// get name of this node
-const CTString &CPathNode::GetName(void)
+// [Cecil] Remember next node on the path
+static void SetPathHop(INDEX iSrc, INDEX iDst, INDEX iNext)
 {
-  static CTString strNone="<none>";
-  if (this==NULL || pn_pnmMarker==NULL) {
-    return strNone;
-  } else {
-    return pn_pnmMarker->GetName();
+  // start over if the cache is full
+  if (_ctPathHops >= PATH_MAX_HOPS / 2) {
+    ClearPathHops();
+  }
+
+  // allocate the table
+  if (_aPathHops.Count() == 0) {
+    _aPathHops.New(PATH_MAX_HOPS);
+    ClearPathHops();
+  }
+
+  SPathHop &ph = _aPathHops[FindPathHop(iSrc, iDst)];
+
+  if (ph.ph_iSrc == -1) {
+    ph.ph_iSrc = iSrc;
+    ph.ph_iDst = iDst;
+    _ctPathHops++;
+  }
+
+  ph.ph_iNext = iNext;
+}
+
+// [Cecil] Add a new node to the graph
+static INDEX AddNode(CNavigationMarker *pnm, const FLOAT3D &vPos)
+{
+  const INDEX iNode = _apnGraph.Count();
+  CPathNode &pn = _apnGraph.Push();
+
+  pn.pn_pnmMarker = pnm;
+  pn.pn_vPos = vPos;
+  pn.pn_ctLinks = -1;
+  pn.pn_ulSearch = 0;
+  pn.pn_bOpen = FALSE;
+  pn.pn_bClosed = FALSE;
+  pn.pn_iParent = -1;
+  pn.pn_fG = 0.0f;
+  pn.pn_fH = 0.0f;
+  pn.pn_fF = 0.0f;
+
+  return iNode;
+}
+
+// [Cecil] Get graph node of a marker
+static INDEX NodeForMarker(CNavigationMarker *pnm)
+{
+  if (pnm->m_ulPathGraph != _ulGraph) {
+    pnm->m_ulPathGraph = _ulGraph;
+    pnm->m_iPathNode = AddNode(pnm, pnm->GetPlacement().pl_PositionVector);
   }
+
+  return pnm->m_iPathNode;
 }
 
-// get link with given index or null if no more (for iteration along the graph)
-CPathNode *CPathNode::GetLink(INDEX i)
+// [Cecil] Get node links from its marker
+static void ResolveLinks(INDEX iNode)
 {
-  if (this==NULL || pn_pnmMarker==NULL) {
-    ASSERT(FALSE);
-    return NULL;
+  CNavigationMarker *pnm = _apnGraph[iNode].pn_pnmMarker;
+  ASSERT(pnm!=NULL);
+
+  INDEX aiLinks[PATH_MAX_LINKS];
+  INDEX ctLinks = 0;
+
+  // get links until the first empty one
+  CNavigationMarker *pnmLink = NULL;
+  for(INDEX i=0; i<PATH_MAX_LINKS && (pnmLink=pnm->GetLink(i))!=NULL; i++) {
+    aiLinks[ctLinks++] = NodeForMarker(pnmLink);
   }
-  CNavigationMarker *pnm = pn_pnmMarker->GetLink(i);
-  if (pnm==NULL) {
-    return NULL;
+
+  // adding new nodes could've moved the array
+  CPathNode &pn = _apnGraph[iNode];
+  memcpy(pn.pn_aiLinks, aiLinks, sizeof(aiLinks));
+  pn.pn_ctLinks = ctLinks;
+}
+
+// [Cecil] Prepare node for the current search
+static inline CPathNode &SearchNode(INDEX iNode)
+{
+  CPathNode &pn = _apnGraph[iNode];
+
+  if (pn.pn_ulSearch != _ulSearch) {
+    pn.pn_ulSearch = _ulSearch;
+    pn.pn_bOpen = FALSE;
+    pn.pn_bClosed = FALSE;
+    pn.pn_iParent = -1;
+    pn.pn_fG = 0.0f;
+    pn.pn_fH = 0.0f;
+    pn.pn_fF = 0.0f;
   }
-  return pnm->GetPathNode();
+
+  return pn;
+}
+
+// [Cecil] Get current position of a node
+static inline const FLOAT3D &NodePos(const CPathNode &pn)
+{
+  // markers are checked every time, like the original algorithm did
+  if (pn.pn_pnmMarker!=NULL) {
+    return pn.pn_pnmMarker->GetPlacement().pl_PositionVector;
+  }
+
+  return pn.pn_vPos;
+}
+
+static inline FLOAT NodeDistance(const CPathNode &pn0, const CPathNode &pn1)
+{
+  return (NodePos(pn0) - NodePos(pn1)).Length();
 }
 
 // add given node to open list, sorting best first
-static void SortIntoOpenList(CPathNode *ppnLink)
+// [Cecil] NOTE: Nodes that are already in the list aren't moved when their cost changes,
+// so the order of visiting nodes is exactly the same as in the original algorithm
+static void SortIntoOpenList(INDEX iNode)
 {
-  // start at head of the open list
-  LISTITER(CPathNode, pn_lnInOpen) itpn(_lhOpen);
+  CPathNode &pn = _apnGraph[iNode];
+  pn.pn_bOpen = TRUE;
+
+  // start at head of the open list (end of the array)
+  INDEX iPos = _aiOpen.Count() - 1;
   // while the given node is further than the one in list
-  while(ppnLink->pn_fF>itpn->pn_fF && !itpn.IsPastEnd()) {
+  while (iPos>=0 && pn.pn_fF>_apnGraph[_aiOpen[iPos]].pn_fF) {
     // move to next node
-    itpn.MoveToNext();
+    iPos--;
   }
 
-  // if past the end of list
-  if (itpn.IsPastEnd()) {
-    // add to the end of list
-    _lhOpen.AddTail(ppnLink->pn_lnInOpen);
-  // if not past end of list
-  } else {
-    // add before current node
-    itpn.InsertBeforeCurrent(ppnLink->pn_lnInOpen);
+  // add before current node
+  _aiOpen.Push();
+
+  for (INDEX i = _aiOpen.Count() - 1; i > iPos + 1; i--) {
+    _aiOpen[i] = _aiOpen[i - 1];
   }
+
+  _aiOpen[iPos + 1] = iNode;
 }
-  
-// find shortest path from one marker to another
-static BOOL FindPath(CNavigationMarker *pnmSrc, CNavigationMarker *pnmDst)
+
+// [Cecil] Take the first node from the open list
+static INDEX PopOpenList(void)
 {
+  const INDEX iNode = _aiOpen.Pop();
+  _apnGraph[iNode].pn_bOpen = FALSE;
 
-  ASSERT(pnmSrc!=pnmDst);
-  CPathNode *ppnSrc = pnmSrc->GetPathNode();
-  CPathNode *ppnDst = pnmDst->GetPathNode();
+  return iNode;
+}
 
-  PRINTOUT(CPrintF("--------------------\n"));
-  PRINTOUT(CPrintF("FindPath(%s, %s)\n", ppnSrc->GetName(), ppnDst->GetName()));
+// find shortest path from one node to another
+static BOOL FindPath(INDEX iSrc, INDEX iDst)
+{
+  ASSERT(iSrc!=iDst);
+
+  // [Cecil] New search makes states of all nodes outdated
+  _ulSearch++;
+  _aiOpen.PopAll();
 
-  // start with empty open and closed lists
-  ASSERT(_lhOpen.IsEmpty());
-  ASSERT(_lhClosed.IsEmpty());
+  PRINTOUT(CPrintF("--------------------\n"));
+  PRINTOUT(CPrintF("FindPath(%d, %d)\n", iSrc, iDst));
 
   // add the start node to open list
-  ppnSrc->pn_fG = 0.0f;
-  ppnSrc->pn_fH = NodeDistance(ppnSrc, ppnDst);
-  ppnSrc->pn_fF = ppnSrc->pn_fG +ppnSrc->pn_fH;
-  _lhOpen.AddTail(ppnSrc->pn_lnInOpen);
-  PRINTOUT(CPrintF("StartState: %s\n", ppnSrc->GetName()));
+  CPathNode &pnDst = SearchNode(iDst);
+  CPathNode &pnSrc = SearchNode(iSrc);
+  pnSrc.pn_fG = 0.0f;
+  pnSrc.pn_fH = NodeDistance(pnSrc, pnDst);
+  pnSrc.pn_fF = pnSrc.pn_fG + pnSrc.pn_fH;
+  SortIntoOpenList(iSrc);
 
   // while the open list is not empty
-  while (!_lhOpen.IsEmpty()) {
+  while (_aiOpen.Count() > 0) {
     // get the first node from open list (that is, the one with lowest F)
-    CPathNode *ppnNode = LIST_HEAD(_lhOpen, CPathNode, pn_lnInOpen);
-    ppnNode->pn_lnInOpen.Remove();
-      _lhClosed.AddTail(ppnNode->pn_lnInClosed);
-    PRINTOUT(CPrintF("Node: %s - moved from OPEN to CLOSED\n", ppnNode->GetName()));
+    const INDEX iNode = PopOpenList();
+    _apnGraph[iNode].pn_bClosed = TRUE;
+    PRINTOUT(CPrintF("Node: %d - moved from OPEN to CLOSED\n", iNode));
 
     // if this is the goal
-    if (ppnNode==ppnDst) {
+    if (iNode==iDst) {
       PRINTOUT(CPrintF("PATH FOUND!\n"));
       // the path is found
       return TRUE;
     }
 
+    // [Cecil] Resolve links of the marker on the first visit
+    if (_apnGraph[iNode].pn_ctLinks < 0) {
+      ResolveLinks(iNode);
+    }
+
+    const CPathNode &pnNode = _apnGraph[iNode];
+
     // for each link of current node
-    CPathNode *ppnLink = NULL;
-    for(INDEX i=0; (ppnLink=ppnNode->GetLink(i))!=NULL; i++) {
-      PRINTOUT(CPrintF(" Link %d: %s\n", i, ppnLink->GetName()));
+    for(INDEX i=0; i<pnNode.pn_ctLinks; i++) {
+      const INDEX iLink = pnNode.pn_aiLinks[i];
+      CPathNode &pnLink = SearchNode(iLink);
+      PRINTOUT(CPrintF(" Link %d: %d\n", i, iLink));
+
       // get cost to get to this node if coming from current node
-      FLOAT fNewG = ppnLink->pn_fG+NodeDistance(ppnNode, ppnLink);
+      // [Cecil] NOTE: Original algorithm adds to the cost of the link instead of the current node
+      FLOAT fNewG = pnLink.pn_fG+NodeDistance(pnNode, pnLink);
       // if a shorter path already exists
-      if ((ppnLink->pn_lnInOpen.IsLinked() || ppnLink->pn_lnInClosed.IsLinked()) && fNewG>=ppnLink->pn_fG) {
-        PRINTOUT(CPrintF("  shorter path exists through: %s\n", ppnLink->pn_ppnParent->GetName()));
+      if ((pnLink.pn_bOpen || pnLink.pn_bClosed) && fNewG>=pnLink.pn_fG) {
         // skip this link
         continue;
       }
       // remember this path
-      ppnLink->pn_ppnParent = ppnNode;
-      ppnLink->pn_fG = fNewG;
-      ppnLink->pn_fH = NodeDistance(ppnLink, ppnDst);
-      ppnLink->pn_fF = ppnLink->pn_fG + ppnLink->pn_fH;
+      pnLink.pn_iParent = iNode;
+      pnLink.pn_fG = fNewG;
+      pnLink.pn_fH = NodeDistance(pnLink, _apnGraph[iDst]);
+      pnLink.pn_fF = pnLink.pn_fG + pnLink.pn_fH;
       // remove from closed list, if in it
-      if (ppnLink->pn_lnInClosed.IsLinked()) {
-        ppnLink->pn_lnInClosed.Remove();
-        PRINTOUT(CPrintF("  %s removed from CLOSED\n", ppnLink->GetName()));
-      }
+      pnLink.pn_bClosed = FALSE;
+
       // add to open if not in it
-      if (!ppnLink->pn_lnInOpen.IsLinked()) {
-        SortIntoOpenList(ppnLink);
-        PRINTOUT(CPrintF("  %s added to OPEN\n", ppnLink->GetName()));
+      if (!pnLink.pn_bOpen) {
+        SortIntoOpenList(iLink);
       }
     }
   }
@@ -166,26 +318,94 @@ static BOOL FindPath(CNavigationMarker *pnmSrc, CNavigationMarker *pnmDst)
   return FALSE;
 }
 
-// clear all temporary structures used for path finding
-static void ClearPath(CEntity *penThis)
+// [Cecil] Find node after the source one on the path to the destination
+static INDEX NextNodeOnPath(INDEX iSrc, INDEX iDst)
+{
+  INDEX iNode = iDst;
+
+  while (_apnGraph[iNode].pn_iParent!=-1 && _apnGraph[iNode].pn_iParent!=iSrc) {
+    iNode = _apnGraph[iNode].pn_iParent;
+  }
+
+  return iNode;
+}
+
+// [Cecil] Check if the marker has moved away from where its node has been added
+static inline BOOL MarkerMoved(INDEX iNode)
+{
+  const CPathNode &pn = _apnGraph[iNode];
+  return NodePos(pn) != pn.pn_vPos;
+}
+
+// [Cecil] Replay path queries on a synthetic grid of markers
+static void BenchmarkPathFinding(SHELL_FUNC_ARGS)
 {
-  {FORDELETELIST(CPathNode, pn_lnInOpen, _lhOpen, itpn) {
-    delete &itpn.Current();
-  }}
-  {FORDELETELIST(CPathNode, pn_lnInClosed, _lhClosed, itpn) {
-    delete &itpn.Current();          
-  }}
-
-#ifndef NDEBUG
-  // for each navigation marker in the world
-  {FOREACHINDYNAMICCONTAINER(penThis->en_pwoWorld->wo_cenEntities, CEntity, iten) {
-    if (!IsOfClass(iten, "NavigationMarker")) {
-      continue;
+  BEGIN_SHELL_FUNC;
+  const INDEX ctMarkers = ClampDn(NEXT_ARG(INDEX), (INDEX)4);
+  const INDEX ctQueries = ClampDn(NEXT_ARG(INDEX), (INDEX)1);
+
+  PATH_ResetGraph();
+
+  // lay out markers in a square grid with 4 links each and random gaps
+  const INDEX iSide = (INDEX)ceil(sqrt((FLOAT)ctMarkers));
+  INDEX iMarker;
+
+  for (iMarker = 0; iMarker < ctMarkers; iMarker++) {
+    const FLOAT3D vPos((iMarker % iSide) * 8.0f, 0.0f, (iMarker / iSide) * 8.0f);
+    AddNode(NULL, vPos);
+  }
+
+  ULONG ulRnd = 0x1234567;
+  #define PATH_BENCH_RND() (ulRnd = ulRnd * 1103515245 + 12345, (ulRnd >> 16) & 0x7FFF)
+
+  for (iMarker = 0; iMarker < ctMarkers; iMarker++) {
+    CPathNode &pn = _apnGraph[iMarker];
+    pn.pn_ctLinks = 0;
+
+    const INDEX aiNeighbors[4] = { iMarker - 1, iMarker + 1, iMarker - iSide, iMarker + iSide };
+    const BOOL abValid[4] = { iMarker % iSide != 0, iMarker % iSide != iSide - 1, TRUE, TRUE };
+
+    for (INDEX i = 0; i < 4; i++) {
+      const INDEX iLink = aiNeighbors[i];
+
+      // skip some links to make paths go around
+      if (!abValid[i] || iLink < 0 || iLink >= ctMarkers || PATH_BENCH_RND() % 8 == 0) continue;
+
+      pn.pn_aiLinks[pn.pn_ctLinks++] = iLink;
     }
-    CNavigationMarker &nm = (CNavigationMarker&)*iten;
-    ASSERT(nm.m_ppnNode==NULL);
-  }}
-#endif
+  }
+
+  INDEX ctFound = 0;
+
+  CTimerValue tvStart = _pTimer->GetHighPrecisionTimer();
+
+  for (INDEX iQuery = 0; iQuery < ctQueries; iQuery++) {
+    const INDEX iSrc = PATH_BENCH_RND() % ctMarkers;
+    const INDEX iDst = PATH_BENCH_RND() % ctMarkers;
+    if (iSrc == iDst) continue;
+
+    if (FindPath(iSrc, iDst)) {
+      ctFound++;
+    }
+  }
+
+  const DOUBLE dTime = (_pTimer->GetHighPrecisionTimer() - tvStart).GetSeconds();
+  #undef PATH_BENCH_RND
+
+  CPrintF("%d markers, %d queries (%d paths found) in %.3f ms (%.2f us per query)\n",
+    ctMarkers, ctQueries, ctFound, dTime * 1000.0, dTime * 1000000.0 / ctQueries);
+
+  // [Cecil] Start over with the actual markers
+  PATH_ResetGraph();
+}
+
+// [Cecil] Declare path finding commands
+void PATH_DeclareSymbols(void)
+{
+  _pShell->DeclareSymbol("user void PATH_Benchmark(INDEX, INDEX);", &BenchmarkPathFinding);
+
+  _pShell->DeclareSymbol("user INDEX path_ctCacheHits;", &path_ctCacheHits);
+  _pShell->DeclareSymbol("user INDEX path_ctCacheMisses;", &path_ctCacheMisses);
 }
 
 // find marker closest to a given position
@@ -198,7 +418,8 @@ static void FindClosestMarker(
   {FOREACHSRCOFDST(penThis->en_rdSectors, CBrushSector, bsc_rsEntities, pbsc)
     // for each navigation marker in that sector
     {FOREACHDSTOFSRC(pbsc->bsc_rsEntities, CEntity, en_rdSectors, pen)
-      if (!IsOfClass(pen, "NavigationMarker")) {
+      // [Cecil] Check precomputed class categories instead of comparing names
+      if (!IEntityRegistry::IsOfCategory(pen, ECAT_NAVMARKER)) {
         continue;
       }
       CNavigationMarker &nm = (CNavigationMarker&)*pen;
@@ -268,28 +489,43 @@ void PATH_FindNextMarker(CEntity *penThis, const FLOAT3D &vSrc, const FLOAT3D &v
   }
 
   // try to find shortest path to the destination
-  BOOL bFound = FindPath((CNavigationMarker*)penMarker, pnmDst);
+  INDEX iSrc = NodeForMarker((CNavigationMarker*)penMarker);
+  INDEX iDst = NodeForMarker(pnmDst);
+
+  // [Cecil] Start over if any of the markers has moved
+  if (MarkerMoved(iSrc) || MarkerMoved(iDst)) {
+    PATH_ResetGraph();
+    iSrc = NodeForMarker((CNavigationMarker*)penMarker);
+    iDst = NodeForMarker(pnmDst);
+  }
+
+  // [Cecil] Use cached query or find the path and remember it
+  INDEX iNext = -1;
+
+  if (GetPathHop(iSrc, iDst, iNext)) {
+    path_ctCacheHits++;
+
+  } else {
+    path_ctCacheMisses++;
+
+    if (FindPath(iSrc, iDst)) {
+      iNext = NextNodeOnPath(iSrc, iDst);
+    }
+
+    SetPathHop(iSrc, iDst, iNext);
+  }
 
   // if not found
-  if (!bFound) {
-    // just clean up and fail
-    delete pnmDst->GetPathNode();
-    ClearPath(penThis);
+  if (iNext==-1) {
+    // fail
     penMarker = NULL;
     vPath = vSrc;
     return;
   }
 
   // find the first marker position after current
-  CPathNode *ppn = pnmDst->GetPathNode();
-  while (ppn->pn_ppnParent!=NULL && ppn->pn_ppnParent->pn_pnmMarker!=penMarker) {
-    ppn = ppn->pn_ppnParent;
-  }
-  penMarker = ppn->pn_pnmMarker;
+  penMarker = _apnGraph[iNext].pn_pnmMarker;
 
   // go there
   vPath = penMarker->GetPlacement().pl_PositionVector;
-
-  // clean up
-  ClearPath(penThis);
 }
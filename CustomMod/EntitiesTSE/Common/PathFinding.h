@@ -19,30 +19,37 @@ with this program; if not, write to the Free Software Foundation, Inc.,
   #pragma once
 #endif
 
+// [Cecil] Maximum amount of links of a single navigation marker
+#define PATH_MAX_LINKS 6
+
 // temporary structure used for path finding
+// [Cecil] Nodes are kept in a flat array and reference each other by indices
 class DECL_DLL CPathNode {
 public:
-  // cunstruction/destruction
-  CPathNode(class CNavigationMarker *penMarker);
-  ~CPathNode(void);
-
-  // get name of this node
-  const CTString &GetName(void);
-
-  // get link with given index or null if no more (for iteration along the graph)
-  CPathNode *GetLink(INDEX i);
+  class CNavigationMarker *pn_pnmMarker; // the marker itself (NULL in synthetic graphs)
+  FLOAT3D pn_vPos; // [Cecil] Marker position when the node has been added (node position in synthetic graphs)
 
-  class CNavigationMarker *pn_pnmMarker; // the marker itself
+  // [Cecil] Indices of linked nodes (amount is -1 until they are resolved)
+  INDEX pn_aiLinks[PATH_MAX_LINKS];
+  INDEX pn_ctLinks;
 
-  CListNode pn_lnInOpen;  // for linking in open/closed lists
-  CListNode pn_lnInClosed;
+  // [Cecil] Fields below are only valid during the search they have been set in
+  ULONG pn_ulSearch;
+  BOOL pn_bOpen;    // in the open list
+  BOOL pn_bClosed;  // already visited
 
-  CPathNode *pn_ppnParent;  // best found parent in path yet
+  INDEX pn_iParent; // best found parent in path yet (-1 if none)
   FLOAT pn_fG;  // total cost to get here through the best parent
   FLOAT pn_fH;  // estimate of distance to the goal
   FLOAT pn_fF;  // total quality of the path going through this node
 };
 
+// [Cecil] Forget the navigation graph (whenever markers change)
+DECL_DLL void PATH_ResetGraph(void);
+
+// [Cecil] Declare path finding commands
+void PATH_DeclareSymbols(void);
+
 // find first marker for path navigation
 DECL_DLL void PATH_FindFirstMarker(
     CEntity *penThis, const FLOAT3D &vSrc, const FLOAT3D &vDst, CEntity *&penMarker, FLOAT3D &vPath);
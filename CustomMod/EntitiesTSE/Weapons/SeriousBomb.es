@@ -90,16 +90,18 @@ functions:
 
   void ExplodeBomb( void )
   {
-    // for each entity in the world
-    {FOREACHINDYNAMICCONTAINER(this->GetWorld()->wo_cenEntities, CEntity, iten) {
+    // [Cecil] Only go through enemies in the world
+    CDynamicContainer<CEntity> cenEnemies;
+    IEntityRegistry::GetEntities(this->GetWorld(), ECAT_ENEMY, cenEnemies);
+
+    // for each enemy in the world
+    {FOREACHINDYNAMICCONTAINER(cenEnemies, CEntity, iten) {
       CEntity *pen = iten;
-      if (IsDerivedFromClass(pen, "Enemy Base")) {
-        CEnemyBase *penEnemy = (CEnemyBase *)pen;
-        if (penEnemy->m_bBoss==TRUE || DistanceTo(this, penEnemy)>250.0f) {
-          continue;
-        }
-        this->InflictDirectDamage(pen, this, DMT_EXPLOSION, penEnemy->GetHealth()+100.0f, pen->GetPlacement().pl_PositionVector, FLOAT3D(0,1,0));
+      CEnemyBase *penEnemy = (CEnemyBase *)pen;
+      if (penEnemy->m_bBoss==TRUE || DistanceTo(this, penEnemy)>250.0f) {
+        continue;
       }
+      this->InflictDirectDamage(pen, this, DMT_EXPLOSION, penEnemy->GetHealth()+100.0f, pen->GetPlacement().pl_PositionVector, FLOAT3D(0,1,0));
     }}
   }
   